@@ -42,7 +42,7 @@
 
 #define MAX_LEN_LOG_LINE 512
 
-char last_called_script_event[MAX_EVENT_NAME_LEN];
+const char *last_called_script_event = "<none>";
 UDWORD traceID = -1;
 
 static debug_callback *callbackRegistry = nullptr;
@@ -50,8 +50,8 @@
 
 #define MAX_EVENT_NAME_LEN	100
 
-/** Stores name of the last function or event called by scripts. */
-extern char last_called_script_event[MAX_EVENT_NAME_LEN];
+/** Name of the last function or event called by scripts; points into the script's decoded code, so it is only formatted on error. */
+extern const char *last_called_script_event;
 
 /** Whether asserts are currently enabled. */
 extern bool assertEnabled;
@@ -0,0 +1,110 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/*!
+ * \file
+ * \brief Storage for many short lived objects of one type.
+ *
+ * Memory comes from the heap in slabs of many objects at once, and freed objects go on a free list
+ * to be handed out again, newest first, so that objects created and destroyed every tick don't go
+ * through malloc and stay close together in memory. Slabs are only returned to the heap by release().
+ */
+
+#ifndef SLABPOOL_H
+#define SLABPOOL_H
+
+#include <memory>
+#include <vector>
+
+template <typename T, size_t PerSlab = 256>
+class SlabPool
+{
+public:
+	SlabPool() = default;
+	SlabPool(SlabPool const &) = delete;
+	SlabPool &operator =(SlabPool const &) = delete;
+
+	/// Returns uninitialised storage for one T.
+	void *allocate()
+	{
+		if (freeList == nullptr)
+		{
+			addSlab();
+		}
+		Slot *slot = freeList;
+		freeList = slot->next;
+		++used;
+		return slot->storage;
+	}
+
+	/// Returns storage from allocate() to the pool. The object must already be destroyed.
+	void deallocate(void *p)
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+		Slot *slot = reinterpret_cast<Slot *>(p);
+		slot->next = freeList;
+		freeList = slot;
+		--used;
+	}
+
+	/// Frees all the slabs, if nothing is allocated from them.
+	bool release()
+	{
+		if (used != 0)
+		{
+			return false;
+		}
+		freeList = nullptr;
+		slabs.clear();
+		return true;
+	}
+
+	/// Number of objects allocated and not yet deallocated.
+	size_t size() const
+	{
+		return used;
+	}
+
+private:
+	union Slot
+	{
+		Slot *next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	void addSlab()
+	{
+		slabs.emplace_back(new Slot[PerSlab]);
+		Slot *slab = slabs.back().get();
+		// Link backwards, so the slab is handed out from the start.
+		for (size_t i = PerSlab; i-- > 0;)
+		{
+			slab[i].next = freeList;
+			freeList = &slab[i];
+		}
+	}
+
+	std::vector<std::unique_ptr<Slot[]>> slabs;
+	Slot *freeList = nullptr;
+	size_t used = 0;
+};
+
+#endif // SLABPOOL_H
@@ -44,6 +44,7 @@
 
 #include "netplay.h"
 #include "netlog.h"
+#include "netreplay.h"
 #include "netsocket.h"
 
 #include <miniupnpc/miniwget.h>
@@ -1322,6 +1323,12 @@ bool NETsend(NETQUEUE queue, NetMessage const *message)
 		ASSERT_OR_RETURN(false, false, "Wrong queue type.");
 	}
 
+	// Encoded once, and shared by all the players it is sent to.
+	std::vector<uint8_t> rawData;
+	rawData.reserve(message->rawLen());
+	message->rawDataAppendToVector(rawData);
+	ssize_t rawLen = rawData.size();
+
 	if (NetPlay.isHost)
 	{
 		int firstPlayer = player == NET_ALL_PLAYERS ? 0                         : player;
@@ -1331,11 +1338,8 @@ bool NETsend(NETQUEUE queue, NetMessage const *message)
 			// We are the host, send directly to player.
 			if (sockets[player] != nullptr && player != queue.exclude)
 			{
-				uint8_t *rawData = message->rawDataDup();
-				ssize_t rawLen   = message->rawLen();
 				size_t compressedRawLen;
-				result = writeAll(sockets[player], rawData, rawLen, &compressedRawLen);
-				delete[] rawData;  // Done with the data.
+				result = writeAll(sockets[player], &rawData[0], rawLen, &compressedRawLen);
 
 				if (result == rawLen)
 				{
@@ -1362,11 +1366,8 @@ bool NETsend(NETQUEUE queue, NetMessage const *message)
 		// We are a client, send directly to player, who happens to be the host.
 		if (bsocket)
 		{
-			uint8_t *rawData = message->rawDataDup();
-			ssize_t rawLen   = message->rawLen();
 			size_t compressedRawLen;
-			result = writeAll(bsocket, rawData, rawLen, &compressedRawLen);
-			delete[] rawData;  // Done with the data.
+			result = writeAll(bsocket, &rawData[0], rawLen, &compressedRawLen);
 
 			if (result == rawLen)
 			{
@@ -1915,6 +1916,23 @@ checkMessages:
 	return false;
 }
 
+/// When playing back a replay, reads recorded messages into the game queues, until there is one for the given player.
+static bool NETreplayFillGameQueue(unsigned player)
+{
+	static NetMessage message;
+	uint8_t messagePlayer;
+
+	while (!NETisMessageReady(NETgameQueue(player)))
+	{
+		if (!NETreplayLoadNetMessage(message, messagePlayer))
+		{
+			return false;  // End of the replay, the game will wait here forever.
+		}
+		NETinsertMessageFromNet(NETgameQueue(messagePlayer), &message);
+	}
+	return true;
+}
+
 bool NETrecvGame(NETQUEUE *queue, uint8_t *type)
 {
 	for (unsigned current = 0; current < MAX_PLAYERS; ++current)
@@ -1922,7 +1940,7 @@ bool NETrecvGame(NETQUEUE *queue, uint8_t *type)
 		*queue = NETgameQueue(current);
 		while (!checkPlayerGameTime(current))  // Check for any messages that are scheduled to be read now.
 		{
-			if (!NETisMessageReady(*queue))
+			if (!NETisMessageReady(*queue) && !(NETisReplay() && NETreplayFillGameQueue(current)))
 			{
 				return false;  // Still waiting for messages from this player, and all players should process messages in the same order. Will have to freeze the game while waiting.
 			}
@@ -3186,6 +3204,136 @@ bool NETcheckPlayerConnectionStatus(CONNECTION_STATUS status, unsigned player)
 	return realTime < NET_PlayerConnectionStatus[status][player];
 }
 
+/// Mixes a word into a sync debug CRC. Much faster than crcSum, which goes a byte at a time.
+static inline uint32_t syncDebugMix(uint32_t crc, uint32_t word)
+{
+	crc = (crc ^ word) * 0x9E3779B1;  // Spreads the bits upwards...
+	return crc ^ crc >> 16;           // ...and back down, since only the low 16 bits get sent.
+}
+
+static uint32_t syncDebugMixString(uint32_t crc, char const *string)
+{
+	uint8_t const *bytes = (uint8_t const *)string;
+	size_t len = strlen(string);
+	for (size_t n = 0; n < len; n += 4)
+	{
+		uint32_t word = 0;
+		for (size_t i = 0; i < 4 && n + i < len; ++i)
+		{
+			word |= (uint32_t)bytes[n + i] << 8 * i;  // Built from the bytes, so the same on big endian.
+		}
+		crc = syncDebugMix(crc, word);
+	}
+	return syncDebugMix(crc, len);
+}
+
+/// Prints "[function] format\n", taking the arguments in order from words and, for %s, from strings. Advances words past numWords, and strings past the ones used.
+/// Integers take two words if the format says they are 64-bit. Returns the number of characters printed, at most bufSize.
+static size_t syncDebugSnprintf(char *buf, size_t bufSize, char const *function, char const *format, int const *&words, unsigned numWords, char const *&strings)
+{
+	size_t index = 0;
+	unsigned word = 0;
+	auto advance = [&](int ret)
+	{
+		index = MIN(index + MAX(ret, 0), bufSize);
+	};
+
+	advance(snprintf(buf, bufSize, "[%s] ", function));
+	for (char const *c = format; *c != '\0' && index < bufSize;)
+	{
+		if (*c != '%')
+		{
+			buf[index++] = *c++;
+			continue;
+		}
+
+		// Keep the flags, width and precision, such as "%08", and use the length modifier only to see how many words to take.
+		char spec[24];
+		size_t specLen = 0;
+		spec[specLen++] = *c++;
+		while (*c != '\0' && strchr("-+ #0123456789.", *c) != nullptr && specLen < sizeof(spec) - 4)
+		{
+			spec[specLen++] = *c++;
+		}
+		unsigned longs = 0;
+		bool wide = false;
+		for (;; ++c)
+		{
+			if (*c == 'l')
+			{
+				wide = ++longs == 2 || sizeof(long) == sizeof(int64_t);
+			}
+			else if (*c == 'j' || *c == 'q')
+			{
+				wide = true;
+			}
+			else if (*c == 'z')
+			{
+				wide = sizeof(size_t) == sizeof(int64_t);
+			}
+			else if (c[0] == 'I' && c[1] == '6' && c[2] == '4')
+			{
+				wide = true;
+				c += 2;
+			}
+			else if (*c != 'h')
+			{
+				break;
+			}
+		}
+		char conversion = *c;
+		if (conversion == '\0')
+		{
+			break;
+		}
+		++c;
+		if (wide)
+		{
+			spec[specLen++] = 'l';
+			spec[specLen++] = 'l';
+		}
+		spec[specLen++] = conversion;
+		spec[specLen] = '\0';
+
+		bool isSigned = conversion == 'd' || conversion == 'i' || conversion == 'c';
+		switch (conversion)
+		{
+		case '%':
+			buf[index++] = '%';
+			break;
+		case 's':
+			if (strings != nullptr)
+			{
+				advance(snprintf(buf + index, bufSize - index, spec, strings));
+				strings += strlen(strings) + 1;
+			}
+			break;
+		case 'd': case 'i': case 'c': case 'u': case 'o': case 'x': case 'X':
+			if (wide && word + 2 <= numWords)
+			{
+				uint64_t value = (uint32_t)words[word] | (uint64_t)(uint32_t)words[word + 1] << 32;
+				word += 2;
+				advance(isSigned ? snprintf(buf + index, bufSize - index, spec, (long long)value) : snprintf(buf + index, bufSize - index, spec, (unsigned long long)value));
+			}
+			else if (!wide && word < numWords)
+			{
+				int value = words[word++];
+				advance(isSigned ? snprintf(buf + index, bufSize - index, spec, value) : snprintf(buf + index, bufSize - index, spec, (unsigned)value));
+			}
+			break;
+		default:
+			advance(snprintf(buf + index, bufSize - index, "%s", spec));  // Not something syncDebug() takes.
+			break;
+		}
+	}
+	if (index < bufSize)
+	{
+		buf[index++] = '\n';
+	}
+	words += numWords;
+	return index;
+}
+
 struct SyncDebugEntry
 {
 	char const *function;
@@ -3196,8 +3344,8 @@ struct SyncDebugString : public SyncDebugEntry
 	void set(uint32_t &crc, char const *f, char const *string)
 	{
 		function = f;
-		crc = crcSum(crc, function, strlen(function) + 1);
-		crc = crcSum(crc, string,   strlen(string) + 1);
+		crc = syncDebugMixString(crc, function);
+		crc = syncDebugMixString(crc, string);
 	}
 	int snprint(char *buf, size_t bufSize, char const *&string) const
 	{
@@ -3215,10 +3363,9 @@ struct SyncDebugValueChange : public SyncDebugEntry
 		variableName = vn;
 		newValue = nv;
 		id = i;
-		uint32_t valueBytes = htonl(newValue);
-		crc = crcSum(crc, function,     strlen(function) + 1);
-		crc = crcSum(crc, variableName, strlen(variableName) + 1);
-		crc = crcSum(crc, &valueBytes,  4);
+		crc = syncDebugMixString(crc, function);
+		crc = syncDebugMixString(crc, variableName);
+		crc = syncDebugMix(crc, newValue);
 	}
 	int snprint(char *buf, size_t bufSize) const
 	{
@@ -3240,81 +3387,34 @@ struct SyncDebugIntList : public SyncDebugEntry
 	{
 		function = f;
 		string = s;
-		uint32_t valueBytes[40];
-		numInts = std::min(num, ARRAY_SIZE(valueBytes));
+		numInts = num;
 		for (unsigned n = 0; n < numInts; ++n)
 		{
-			valueBytes[n] = htonl(ints[n]);
+			crc = syncDebugMix(crc, ints[n]);
 		}
-		crc = crcSum(crc, valueBytes, 4 * numInts);
 	}
 	int snprint(char *buf, size_t bufSize, int const *&ints) const
 	{
-		size_t index = 0;
-		if (index < bufSize)
-		{
-			index += snprintf(buf + index, bufSize - index, "[%s] ", function);
-		}
-		if (index < bufSize)
-		{
-			switch (numInts)
-			{
-			case  0: index += snprintf(buf + index, bufSize - index, "%s", string); break;
-			case  1: index += snprintf(buf + index, bufSize - index, string, ints[0]); break;
-			case  2: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1]); break;
-			case  3: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2]); break;
-			case  4: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3]); break;
-			case  5: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4]); break;
-			case  6: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5]); break;
-			case  7: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6]); break;
-			case  8: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7]); break;
-			case  9: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8]); break;
-			case 10: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9]); break;
-			case 11: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10]); break;
-			case 12: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11]); break;
-			case 13: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12]); break;
-			case 14: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13]); break;
-			case 15: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14]); break;
-			case 16: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15]); break;
-			case 17: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16]); break;
-			case 18: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17]); break;
-			case 19: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18]); break;
-			case 20: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19]); break;
-			case 21: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20]); break;
-			case 22: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21]); break;
-			case 23: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22]); break;
-			case 24: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23]); break;
-			case 25: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24]); break;
-			case 26: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25]); break;
-			case 27: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26]); break;
-			case 28: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27]); break;
-			case 29: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28]); break;
-			case 30: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29]); break;
-			case 31: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30]); break;
-			case 32: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31]); break;
-			case 33: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32]); break;
-			case 34: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33]); break;
-			case 35: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33], ints[34]); break;
-			case 36: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33], ints[34], ints[35]); break;
-			case 37: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33], ints[34], ints[35], ints[36]); break;
-			case 38: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33], ints[34], ints[35], ints[36], ints[37]); break;
-			case 39: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33], ints[34], ints[35], ints[36], ints[37], ints[38]); break;
-			case 40: index += snprintf(buf + index, bufSize - index, string, ints[0], ints[1], ints[2], ints[3], ints[4], ints[5], ints[6], ints[7], ints[8], ints[9], ints[10], ints[11], ints[12], ints[13], ints[14], ints[15], ints[16], ints[17], ints[18], ints[19], ints[20], ints[21], ints[22], ints[23], ints[24], ints[25], ints[26], ints[27], ints[28], ints[29], ints[30], ints[31], ints[32], ints[33], ints[34], ints[35], ints[36], ints[37], ints[38], ints[39]); break;
-			default: index += snprintf(buf + index, bufSize - index, "Too many ints in intlist."); break;
-			}
-		}
-		if (index < bufSize)
-		{
-			index += snprintf(buf + index, bufSize - index, "\n");
-		}
-		ints += numInts;
-		return index;
+		char const *noStrings = nullptr;
+		return syncDebugSnprintf(buf, bufSize, function, string, ints, numInts, noStrings);
 	}
 
 	char const *string;
 	unsigned numInts;
 };
 
+/// A syncDebug() call, with the integer arguments stored as words, and the strings in the chars of the log.
+struct SyncDebugArgList : public SyncDebugEntry
+{
+	int snprint(char *buf, size_t bufSize, int const *&words, char const *&strings) const
+	{
+		return syncDebugSnprintf(buf, bufSize, function, format, words, numWords, strings);
+	}
+
+	char const *format;
+	unsigned numWords;
+};
+
 struct SyncDebugLog
 {
 	SyncDebugLog() : time(0), crc(0x00000000) {}
@@ -3327,6 +3427,7 @@ struct SyncDebugLog
 		strings.clear();
 		valueChanges.clear();
 		intLists.clear();
+		argLists.clear();
 		chars.clear();
 		ints.clear();
 	}
@@ -3359,11 +3460,41 @@ struct SyncDebugLog
 		intLists.back().set(crc, f, s, buf, num);
 		log.push_back('i');
 	}
+	void argList(SyncDebugSite const &site, SyncDebugArg const *args, size_t numArgs)
+	{
+		crc = syncDebugMix(crc, site.id);
+		size_t firstWord = ints.size();
+		for (size_t n = 0; n < numArgs; ++n)
+		{
+			SyncDebugArg const &arg = args[n];
+			if (arg.string != nullptr)
+			{
+				crc = syncDebugMixString(crc, arg.string);
+				chars.insert(chars.end(), arg.string, arg.string + strlen(arg.string) + 1);
+				continue;
+			}
+			uint64_t value = arg.value;
+			ints.push_back((uint32_t)value);
+			crc = syncDebugMix(crc, (uint32_t)value);
+			if (arg.wide)
+			{
+				ints.push_back((uint32_t)(value >> 32));
+				crc = syncDebugMix(crc, (uint32_t)(value >> 32));
+			}
+		}
+
+		argLists.resize(argLists.size() + 1);
+		argLists.back().function = site.function;
+		argLists.back().format = site.format;
+		argLists.back().numWords = ints.size() - firstWord;
+		log.push_back('a');
+	}
 	int snprint(char *buf, size_t bufSize)
 	{
 		SyncDebugString const *stringPtr = strings.empty() ? nullptr : &strings[0]; // .empty() check, since &strings[0] is undefined if strings is empty(), even if it's likely to work, anyway.
 		SyncDebugValueChange const *valueChangePtr = valueChanges.empty() ? nullptr : &valueChanges[0];
 		SyncDebugIntList const *intListPtr = intLists.empty() ? nullptr : &intLists[0];
+		SyncDebugArgList const *argListPtr = argLists.empty() ? nullptr : &argLists[0];
 		char const *charPtr = chars.empty() ? nullptr : &chars[0];
 		int const *intPtr = ints.empty() ? nullptr : &ints[0];
 
@@ -3382,6 +3513,9 @@ struct SyncDebugLog
 			case 'i':
 				index += intListPtr++->snprint(buf + index, bufSize - index, intPtr);
 				break;
+			case 'a':
+				index += argListPtr++->snprint(buf + index, bufSize - index, intPtr, charPtr);
+				break;
 			default:
 				abort();
 				break;
@@ -3418,6 +3552,7 @@ private:
 	std::vector<SyncDebugString> strings;
 	std::vector<SyncDebugValueChange> valueChanges;
 	std::vector<SyncDebugIntList> intLists;
+	std::vector<SyncDebugArgList> argLists;
 
 	std::vector<char> chars;
 	std::vector<int> ints;
@@ -3456,6 +3591,24 @@ void _syncDebug(const char *function, const char *str, ...)
 	syncDebugLog[syncDebugNext].string(function, outputBuffer);
 }
 
+void _syncDebugArgList(SyncDebugSite &site, char const *format, SyncDebugArg const *args, size_t numArgs)
+{
+	if (site.format != format)
+	{
+		// First call from here, so work out the id. It only depends on the source, so is the same for everyone.
+#ifdef WZ_CC_MSVC
+		char const *f = site.function; while (*f != '\0') if (*f++ == ':')
+			{
+				site.function = f;    // Strip "Class::" from "Class::myFunction".
+			}
+#endif
+		site.format = format;
+		site.id = syncDebugMixString(syncDebugMixString(0, site.function), format);
+	}
+
+	syncDebugLog[syncDebugNext].argList(site, args, numArgs);
+}
+
 void _syncDebugIntList(const char *function, const char *str, int *ints, size_t numInts)
 {
 #ifdef WZ_CC_MSVC
@@ -3494,7 +3647,7 @@ void _syncDebugBacktrace(const char *function)
 #endif
 
 	// Use CRC of something platform-independent, to avoid false positive desynchs.
-	backupCrc = ~crcSum(~backupCrc, function, strlen(function) + 1);
+	backupCrc = ~syncDebugMixString(~backupCrc, function);
 	syncDebugLog[syncDebugNext].setCrc(backupCrc);
 }
 
@@ -29,6 +29,7 @@
 #include "lib/framework/crc.h"
 #include "nettypes.h"
 #include <physfs.h>
+#include <type_traits>
 
 // Lobby Connection errors
 
@@ -335,14 +336,50 @@ bool NETcheckPlayerConnectionStatus(CONNECTION_STATUS status, unsigned player);
 const char *messageTypeToString(unsigned messageType);
 
 /// Sync debugging. Only prints anything, if different players would print different things.
-#define syncDebug(...) do { _syncDebug(__FUNCTION__, __VA_ARGS__); } while(0)
+/// The arguments are stored as they are, and only formatted if a desynch log is written. Takes integers of up to 64 bits and strings.
+#define syncDebug(...) do { static SyncDebugSite syncDebugSite_ = {__FUNCTION__, nullptr, 0}; if (false) { _syncDebugCheckFormat(__VA_ARGS__); } _syncDebugArgs(syncDebugSite_, __VA_ARGS__); } while(0)
+/// Formats immediately, for callers giving their own function name.
 #ifdef WZ_CC_MINGW
 void _syncDebug(const char *function, const char *str, ...) WZ_DECL_FORMAT(__MINGW_PRINTF_FORMAT, 2, 3);
+inline void _syncDebugCheckFormat(const char *, ...) WZ_DECL_FORMAT(__MINGW_PRINTF_FORMAT, 1, 2);
 #else
 void _syncDebug(const char *function, const char *str, ...) WZ_DECL_FORMAT(printf, 2, 3);
+inline void _syncDebugCheckFormat(const char *, ...) WZ_DECL_FORMAT(printf, 1, 2);
 #endif
+inline void _syncDebugCheckFormat(const char *, ...) {}  ///< Never called, only lets the compiler check the syncDebug() format against the arguments.
 
-/// Faster than syncDebug. Make sure that str is a format string that takes ints only.
+/// A syncDebug() call. The sync CRC covers the id, worked out from the function name and format string on the first call, instead of the text.
+struct SyncDebugSite
+{
+	char const *function;
+	char const *format;
+	uint32_t id;
+};
+
+/// An argument of syncDebug(), stored as 32-bit words, or a string.
+struct SyncDebugArg
+{
+	template<typename T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, int>::type = 0>
+	SyncDebugArg(T v) : value(static_cast<int64_t>(v)), string(nullptr), wide(sizeof(T) > sizeof(uint32_t))
+	{
+		static_assert(sizeof(T) <= sizeof(int64_t), "syncDebug() takes integers of up to 64 bits");
+	}
+	SyncDebugArg(char const *s) : value(0), string(s != nullptr ? s : "(null)"), wide(false) {}
+
+	int64_t value;
+	char const *string;
+	bool wide;           ///< Takes two words, for 64-bit integers.
+};
+
+void _syncDebugArgList(SyncDebugSite &site, char const *format, SyncDebugArg const *args, size_t numArgs);
+template<typename... Args>
+void _syncDebugArgs(SyncDebugSite &site, char const *format, Args... args)
+{
+	SyncDebugArg const list[] = {SyncDebugArg(args)..., SyncDebugArg(0)};  // Extra element, since arrays can't be empty.
+	_syncDebugArgList(site, format, list, sizeof...(args));
+}
+
+/// Like syncDebug, for callers giving their own function name. Make sure that str is a format string that takes ints only.
 void _syncDebugIntList(const char *function, const char *str, int *ints, size_t numInts);
 #define syncDebugBacktrace() do { _syncDebugBacktrace(__FUNCTION__); } while(0)
 void _syncDebugBacktrace(const char *function);                  ///< Adds a backtrace to syncDebug, if the platform supports it. Can be a bit slow, don't call way too often, unless desperate.
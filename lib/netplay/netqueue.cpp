@@ -118,17 +118,70 @@ uint8_t *NetMessage::rawDataDup() const
 	return ret;
 }
 
+void NetMessage::rawDataAppendToVector(std::vector<uint8_t> &output) const
+{
+	unsigned encodedLengthOfSize = encodedlength_uint32_t(data.size());
+
+	size_t pos = output.size();
+	output.resize(pos + 1 + encodedLengthOfSize);
+
+	output[pos] = type;
+
+	uint32_t len = data.size();
+	for (unsigned n = 0; n < encodedLengthOfSize; ++n)
+	{
+		encode_uint32_t(output[pos + n + 1], len, n);
+	}
+
+	output.insert(output.end(), data.begin(), data.end());
+}
+
 size_t NetMessage::rawLen() const
 {
 	return 1 + encodedlength_uint32_t(data.size()) + data.size();
 }
 
+#define NETQUEUE_MIN_SLOTS 16                  ///< Initial size of the message ring.
+#define NETQUEUE_MAX_REUSED_CAPACITY 65536      ///< Data buffers bigger than this are freed when popped, instead of kept for reuse.
+
 NetQueue::NetQueue()
 	: canGetMessagesForNet(true)
 	, canGetMessages(true)
+	, oldestPos(0)
+	, dataPos(0)
+	, messagePos(0)
+	, endPos(0)
+{
+}
+
+NetMessage &NetQueue::at(size_t pos) const
 {
-	dataPos = messages.end();
-	messagePos = messages.end();
+	return *ring[pos & (ring.size() - 1)];
+}
+
+NetMessage &NetQueue::pushSlot(uint8_t type)
+{
+	if (endPos - oldestPos == ring.size())
+	{
+		// Full, so double the size. The messages themselves don't move.
+		Ring newRing(std::max<size_t>(ring.size() * 2, NETQUEUE_MIN_SLOTS));
+		for (size_t pos = oldestPos; pos != endPos; ++pos)
+		{
+			newRing[pos & (newRing.size() - 1)] = std::move(ring[pos & (ring.size() - 1)]);
+		}
+		ring.swap(newRing);
+	}
+
+	std::unique_ptr<NetMessage> &slot = ring[endPos & (ring.size() - 1)];
+	if (slot == nullptr)
+	{
+		slot.reset(new NetMessage);
+	}
+	++endPos;
+
+	slot->type = type;
+	slot->data.clear();
+	return *slot;
 }
 
 void NetQueue::writeRawData(const uint8_t *netData, size_t netLen)
@@ -159,8 +212,7 @@ void NetQueue::writeRawData(const uint8_t *netData, size_t netLen)
 			break;  // Don't have a whole message ready yet.
 		}
 
-		messages.push_front(NetMessage(type));
-		messages.front().data.assign(buffer.begin() + used + headerLen, buffer.begin() + used + headerLen + len);
+		pushSlot(type).data.assign(buffer.begin() + used + headerLen, buffer.begin() + used + headerLen + len);
 		used += headerLen + len;
 	}
 
@@ -175,36 +227,25 @@ void NetQueue::setWillNeverGetMessagesForNet()
 
 unsigned NetQueue::numMessagesForNet() const
 {
-	unsigned count = 0;
-	if (canGetMessagesForNet)
-	{
-		for (List::iterator i = dataPos; i != messages.begin(); --i)
-		{
-			++count;
-		}
-	}
-
-	return count;
+	return canGetMessagesForNet ? endPos - dataPos : 0;
 }
 
 const NetMessage &NetQueue::getMessageForNet() const
 {
 	ASSERT(canGetMessagesForNet, "Wrong NetQueue type for getMessageForNet.");
-	ASSERT(dataPos != messages.begin(), "No message to get!");
+	ASSERT(dataPos != endPos, "No message to get!");
 
 	// Return the message.
-	List::iterator i = dataPos;
-	--i;
-	return *i;
+	return at(dataPos);
 }
 
 void NetQueue::popMessageForNet()
 {
 	ASSERT(canGetMessagesForNet, "Wrong NetQueue type for popMessageForNet.");
-	ASSERT(dataPos != messages.begin(), "No message to pop!");
+	ASSERT(dataPos != endPos, "No message to pop!");
 
 	// Pop the message.
-	--dataPos;
+	++dataPos;
 
 	// Recycle old data.
 	popOldMessages();
@@ -212,7 +253,7 @@ void NetQueue::popMessageForNet()
 
 void NetQueue::pushMessage(const NetMessage &message)
 {
-	messages.push_front(message);
+	pushSlot(message.type).data.assign(message.data.begin(), message.data.end());
 }
 
 void NetQueue::setWillNeverGetMessages()
@@ -223,27 +264,25 @@ void NetQueue::setWillNeverGetMessages()
 bool NetQueue::haveMessage() const
 {
 	ASSERT(canGetMessages, "Wrong NetQueue type for haveMessage.");
-	return messagePos != messages.begin();
+	return messagePos != endPos;
 }
 
 const NetMessage &NetQueue::getMessage() const
 {
 	ASSERT(canGetMessages, "Wrong NetQueue type for getMessage.");
-	ASSERT(messagePos != messages.begin(), "No message to get!");
+	ASSERT(messagePos != endPos, "No message to get!");
 
 	// Return the message.
-	List::iterator i = messagePos;
-	--i;
-	return *i;
+	return at(messagePos);
 }
 
 void NetQueue::popMessage()
 {
 	ASSERT(canGetMessages, "Wrong NetQueue type for popMessage.");
-	ASSERT(messagePos != messages.begin(), "No message to pop!");
+	ASSERT(messagePos != endPos, "No message to pop!");
 
 	// Pop the message.
-	--messagePos;
+	++messagePos;
 
 	// Recycle old data.
 	popOldMessages();
@@ -253,27 +292,20 @@ void NetQueue::popOldMessages()
 {
 	if (!canGetMessagesForNet)
 	{
-		dataPos = messages.begin();
+		dataPos = endPos;
 	}
 	if (!canGetMessages)
 	{
-		messagePos = messages.begin();
-	}
-
-	List::iterator i = messages.end();
-	while (i != dataPos && i != messagePos)
-	{
-		--i;
+		messagePos = endPos;
 	}
 
-	if (i == dataPos)
+	size_t newOldestPos = std::min(dataPos, messagePos);
+	for (; oldestPos != newOldestPos; ++oldestPos)
 	{
-		dataPos = messages.end();  // Old iterator will become invalid.
-	}
-	if (i == messagePos)
-	{
-		messagePos = messages.end();  // Old iterator will become invalid.
+		NetMessage &old = at(oldestPos);
+		if (old.data.capacity() > NETQUEUE_MAX_REUSED_CAPACITY)
+		{
+			std::vector<uint8_t>().swap(old.data);  // Don't keep huge buffers around.
+		}
 	}
-
-	messages.erase(i, messages.end());
 }
@@ -25,9 +25,11 @@
 #define _NET_QUEUE_H_
 
 #include "lib/framework/frame.h"
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <deque>
+#include <memory>
 
 // At game level:
 // There should be a NetQueue representing each client.
@@ -47,6 +49,7 @@ public:
 	NetMessage(uint8_t type_ = 0xFF) : type(type_) {}
 	uint8_t *rawDataDup() const;  ///< Returns data compatible with NetQueue::writeRawData(). Must be delete[]d.
 	size_t rawLen() const;        ///< Returns the length of the return value of rawDataDup().
+	void rawDataAppendToVector(std::vector<uint8_t> &output) const;  ///< Appends the same data as rawDataDup() returns to output.
 	uint8_t type;
 	std::vector<uint8_t> data;
 };
@@ -63,6 +66,10 @@ public:
 	{
 		message->data.push_back(v);
 	}
+	void bytes(uint8_t const *v, size_t n) const
+	{
+		message->data.insert(message->data.end(), v, v + n);
+	}
 	bool valid() const
 	{
 		return true;
@@ -82,6 +89,18 @@ public:
 		v = index >= message->data.size() ? 0x00 : message->data[index];
 		++index;
 	}
+	void bytes(uint8_t *v, size_t n) const  ///< Same as calling byte() n times.
+	{
+		size_t start = std::min(index, message->data.size());  // Past the end, don't form an iterator beyond end().
+		size_t have = std::min(n, message->data.size() - start);
+		std::copy(message->data.begin() + start, message->data.begin() + start + have, v);
+		std::fill(v + have, v + n, 0x00);
+		index += n;
+	}
+	size_t remaining() const  ///< Number of bytes left to read.
+	{
+		return index >= message->data.size() ? 0 : message->data.size() - index;
+	}
 	bool valid() const
 	{
 		return index <= message->data.size();
@@ -114,6 +133,8 @@ public:
 	void popMessage();                                                 ///< Pops the last returned message.
 
 private:
+	NetMessage &pushSlot(uint8_t type);                                ///< Adds an empty message with the given type to the queue, reusing the storage of an old message if possible.
+	NetMessage &at(size_t pos) const;                                  ///< Returns the message at the given position.
 	void popOldMessages();                                             ///< Pops any messages that are no longer needed.
 
 	// Disable copy constructor and assignment operator.
@@ -123,10 +144,14 @@ private:
 	bool canGetMessagesForNet;                                         ///< True if we will send the messages over the network, false if we don't.
 	bool canGetMessages;                                               ///< True if we will get the messages, false if we don't use them ourselves.
 
-	typedef std::list<NetMessage> List;
-	List::iterator                dataPos;                             ///< Last message which was sent over the network.
-	List::iterator                messagePos;                          ///< Last message which was popped.
-	List                          messages;                            ///< List of messages. Messages are added to the front and read from the back.
+	// Messages are stored in a ring, at position % ring.size(), and positions only ever increase. Popped messages stay allocated, so their
+	// data buffers are reused by later messages, and references to stored messages stay valid when the ring grows.
+	typedef std::vector<std::unique_ptr<NetMessage>> Ring;
+	Ring                          ring;                                ///< Message storage, size is zero or a power of two.
+	size_t                        oldestPos;                           ///< Position of the oldest message still needed.
+	size_t                        dataPos;                             ///< Position of the next message to send over the network.
+	size_t                        messagePos;                          ///< Position of the next message to get.
+	size_t                        endPos;                              ///< Position the next added message will be stored at.
 	std::vector<uint8_t>          incompleteReceivedMessageData;       ///< Data from network which has not yet formed an entire message.
 };
 
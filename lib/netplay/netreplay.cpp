@@ -0,0 +1,254 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+// ////////////////////////////////////////////////////////////////////////
+// Includes
+#include "lib/framework/frame.h"
+
+#include <time.h>
+#include <string.h>
+#include <physfs.h>
+#include "lib/framework/physfs_ext.h"
+
+#include "netreplay.h"
+#include "netplay.h"
+#include "netqueue.h"
+
+// File layout, all numbers big endian:
+//   "WZrp", uint32_t version, uint32_t settings length, settings message
+//   Then per game queue message: uint8_t player, message (as NetMessage::rawDataAppendToVector)
+//   Then REPLAY_END.
+// Messages are already compactly encoded, so the file is not compressed further.
+
+static const char replayMagic[4] = {'W', 'Z', 'r', 'p'};
+static const uint32_t replayVersion = 1;
+#define REPLAY_END 0xFF                 ///< In place of a player, marks the end of the recorded messages.
+#define REPLAY_WRITE_BUFFER 65536       ///< Recorded messages are written in chunks of about this many bytes.
+
+static PHYSFS_file *saveHandle = nullptr;
+static std::vector<uint8_t> saveBuffer;  ///< Recorded messages not yet written to the file.
+
+static std::vector<uint8_t> loadData;    ///< The whole replay being played back.
+static size_t loadPos = 0;               ///< Position of the next message in loadData.
+static bool isReplay = false;
+
+static bool replayFlushSaveBuffer()
+{
+	bool ok = saveBuffer.empty() || WZ_PHYSFS_writeBytes(saveHandle, &saveBuffer[0], saveBuffer.size()) == (PHYSFS_sint64)saveBuffer.size();
+	saveBuffer.clear();
+	return ok;
+}
+
+bool NETreplaySaveStart(char const *name, NetMessage const &settings)
+{
+	NETreplaySaveStop();
+
+	time_t aclock;
+	time(&aclock);
+	struct tm *newtime = localtime(&aclock);
+
+	char filename[256];
+	snprintf(filename, sizeof(filename), "replay/%04d%02d%02d_%02d%02d%02d_%s.wzrp", newtime->tm_year + 1900, newtime->tm_mon + 1, newtime->tm_mday, newtime->tm_hour, newtime->tm_min, newtime->tm_sec, name);
+	saveHandle = PHYSFS_openWrite(filename);
+	if (!saveHandle)
+	{
+		debug(LOG_ERROR, "Could not create replay %s: %s", filename, WZ_PHYSFS_getLastError());
+		return false;
+	}
+
+	std::vector<uint8_t> settingsData;
+	settings.rawDataAppendToVector(settingsData);
+
+	bool ok = WZ_PHYSFS_writeBytes(saveHandle, replayMagic, sizeof(replayMagic)) == sizeof(replayMagic)
+	          && PHYSFS_writeUBE32(saveHandle, replayVersion)
+	          && PHYSFS_writeUBE32(saveHandle, settingsData.size())
+	          && WZ_PHYSFS_writeBytes(saveHandle, &settingsData[0], settingsData.size()) == (PHYSFS_sint64)settingsData.size();
+	if (!ok)
+	{
+		debug(LOG_ERROR, "Could not write replay %s: %s", filename, WZ_PHYSFS_getLastError());
+		PHYSFS_close(saveHandle);
+		saveHandle = nullptr;
+		return false;
+	}
+
+	saveBuffer.clear();
+	saveBuffer.reserve(REPLAY_WRITE_BUFFER + 1024);
+	debug(LOG_NET, "Recording replay %s", filename);
+	return true;
+}
+
+bool NETreplaySaveStop()
+{
+	if (!saveHandle)
+	{
+		return false;
+	}
+
+	saveBuffer.push_back(REPLAY_END);
+	bool ok = replayFlushSaveBuffer();
+	ok = PHYSFS_close(saveHandle) != 0 && ok;
+	saveHandle = nullptr;
+	if (!ok)
+	{
+		debug(LOG_ERROR, "Could not finish replay: %s", WZ_PHYSFS_getLastError());
+	}
+	return ok;
+}
+
+void NETreplaySaveNetMessage(NetMessage const &message, uint8_t player)
+{
+	if (!saveHandle)
+	{
+		return;
+	}
+
+	saveBuffer.push_back(player);
+	message.rawDataAppendToVector(saveBuffer);
+
+	if (saveBuffer.size() >= REPLAY_WRITE_BUFFER && !replayFlushSaveBuffer())
+	{
+		debug(LOG_ERROR, "Could not write replay, stopping recording: %s", WZ_PHYSFS_getLastError());
+		PHYSFS_close(saveHandle);
+		saveHandle = nullptr;
+	}
+}
+
+/// Decodes the message at loadPos, as encoded by NetMessage::rawDataAppendToVector, and advances loadPos past it.
+static bool replayDecodeMessage(NetMessage &message)
+{
+	size_t pos = loadPos;
+	if (pos >= loadData.size())
+	{
+		return false;
+	}
+	message.type = loadData[pos++];
+
+	uint32_t len = 0;
+	bool moreBytes = true;
+	for (unsigned n = 0; moreBytes && n < 5; ++n)
+	{
+		if (pos >= loadData.size())
+		{
+			return false;
+		}
+		moreBytes = decode_uint32_t(loadData[pos++], len, n);
+	}
+	if (moreBytes || loadData.size() - pos < len)
+	{
+		return false;
+	}
+
+	message.data.assign(loadData.begin() + pos, loadData.begin() + pos + len);
+	loadPos = pos + len;
+	return true;
+}
+
+bool NETreplayLoadStart(char const *filename, NetMessage &settings)
+{
+	NETreplayLoadStop();
+
+	PHYSFS_file *handle = PHYSFS_openRead(filename);
+	if (!handle)
+	{
+		debug(LOG_ERROR, "Could not open replay %s: %s", filename, WZ_PHYSFS_getLastError());
+		return false;
+	}
+
+	PHYSFS_sint64 length = PHYSFS_fileLength(handle);
+	bool ok = length >= 0 && length < UINT32_MAX;
+	if (ok)
+	{
+		loadData.resize(length);
+		ok = length == 0 || WZ_PHYSFS_readBytes(handle, &loadData[0], length) == length;
+	}
+	PHYSFS_close(handle);
+
+	uint32_t version = 0;
+	uint32_t settingsLength = 0;
+	if (ok && loadData.size() >= sizeof(replayMagic) + 8 && memcmp(&loadData[0], replayMagic, sizeof(replayMagic)) == 0)
+	{
+		uint8_t const *p = &loadData[sizeof(replayMagic)];
+		version = p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+		settingsLength = p[4] << 24 | p[5] << 16 | p[6] << 8 | p[7];
+		loadPos = sizeof(replayMagic) + 8;
+	}
+	else
+	{
+		ok = false;
+	}
+
+	if (!ok || version != replayVersion || settingsLength > loadData.size() - loadPos || !replayDecodeMessage(settings))
+	{
+		debug(LOG_ERROR, "Could not read replay %s, or version %u is not %u", filename, version, replayVersion);
+		loadData.clear();
+		loadPos = 0;
+		return false;
+	}
+
+	isReplay = true;
+	debug(LOG_NET, "Playing back replay %s", filename);
+	return true;
+}
+
+bool NETreplayLoadNetMessage(NetMessage &message, uint8_t &player)
+{
+	if (!isReplay || loadPos >= loadData.size())
+	{
+		return false;
+	}
+
+	player = loadData[loadPos];
+	if (player == REPLAY_END)
+	{
+		return false;
+	}
+	++loadPos;
+
+	if (player >= MAX_PLAYERS || !replayDecodeMessage(message))
+	{
+		// A replay cut short by a crash also ends up here.
+		debug(LOG_ERROR, "Replay is truncated or corrupt at byte %u", (unsigned)loadPos);
+		loadPos = loadData.size();
+		return false;
+	}
+	return true;
+}
+
+bool NETreplayLoadStop()
+{
+	if (!isReplay)
+	{
+		return false;
+	}
+
+	isReplay = false;
+	loadData.clear();
+	loadData.shrink_to_fit();
+	loadPos = 0;
+	return true;
+}
+
+bool NETreplayLoadIsDone()
+{
+	return isReplay && (loadPos >= loadData.size() || loadData[loadPos] == REPLAY_END);
+}
+
+bool NETisReplay()
+{
+	return isReplay;
+}
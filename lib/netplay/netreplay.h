@@ -0,0 +1,53 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/**
+ * @file netreplay.h
+ *
+ * Recording and playback of the game queue messages of a game.
+ */
+#ifndef _netreplay_h
+#define _netreplay_h
+
+#include "lib/framework/frame.h"
+
+class NetMessage;
+
+// A replay is the settings needed to start the game, followed by every message read from the game queues, in the order they were processed.
+// Since the game is deterministic, processing the same messages from the same start gives the same game, without any network.
+
+/// Starts recording to replay/<date>_<name>.wzrp in the write directory. The settings are stored as given, and handed back by NETreplayLoadStart.
+bool NETreplaySaveStart(char const *name, NetMessage const &settings);
+/// Finishes the replay being recorded, if any.
+bool NETreplaySaveStop();
+/// Records a message processed from the game queue of the given player. Does nothing if not recording.
+void NETreplaySaveNetMessage(NetMessage const &message, uint8_t player);
+
+/// Opens a replay for playback. The path is relative to the search path, such as replay/<file>.wzrp.
+bool NETreplayLoadStart(char const *filename, NetMessage &settings);
+/// Reads the next recorded message, and the player whose game queue it belongs in. Returns false once all messages are read.
+bool NETreplayLoadNetMessage(NetMessage &message, uint8_t &player);
+/// Closes the replay being played back, if any.
+bool NETreplayLoadStop();
+/// Returns true once all recorded messages have been read, which may be some time before they have all been processed.
+bool NETreplayLoadIsDone();
+
+/// Returns true while playing back a replay. Game queue messages are then read from the replay, instead of sent by the players.
+bool NETisReplay();
+
+#endif // _netreplay_h
@@ -36,6 +36,12 @@
 #endif
 #include <zlib.h>
 
+// On Linux, epoll is used instead of select() to find sockets ready for reading or writing, unless it fails to initialise.
+#if defined(WZ_OS_LINUX)
+# include <sys/epoll.h>
+# define WZ_SOCKET_EPOLL
+#endif
+
 enum
 {
 	SOCK_CONNECTION,
@@ -52,7 +58,7 @@ struct Socket
 	 *
 	 * All non-listening sockets will only use the first socket handle.
 	 */
-	Socket() : ready(false), writeError(false), deleteLater(false), isCompressed(false), readDisconnected(false), zDeflateInSize(0)
+	Socket() : ready(false), writeError(false), deleteLater(false), isCompressed(false), readDisconnected(false)
 	{
 		memset(&zDeflate, 0, sizeof(zDeflate));
 		memset(&zInflate, 0, sizeof(zInflate));
@@ -69,15 +75,22 @@ struct Socket
 	bool readDisconnected;  ///< True iff a call to recv() returned 0.
 	z_stream zDeflate;
 	z_stream zInflate;
-	unsigned zDeflateInSize;
 	bool zInflateNeedInput;
+	std::vector<uint8_t> zDeflateInBuf;   ///< Written since the last flush, compressed in one go by socketFlush().
 	std::vector<uint8_t> zDeflateOutBuf;
 	std::vector<uint8_t> zInflateInBuf;
 };
 
 struct SocketSet
 {
+	SocketSet();
+	~SocketSet();
+
 	std::vector<Socket *> fds;
+#if defined(WZ_SOCKET_EPOLL)
+	int epollFd;                                    ///< Watches the sockets for reading, or -1 to use select().
+	mutable std::vector<struct epoll_event> events;
+#endif
 };
 
 
@@ -86,7 +99,10 @@ static WZ_SEMAPHORE *socketThreadSemaphore;
 static WZ_THREAD *socketThread = nullptr;
 static bool socketThreadQuit;
 typedef std::map<Socket *, std::vector<uint8_t> > SocketThreadWriteMap;
-static SocketThreadWriteMap socketThreadWrites;
+static SocketThreadWriteMap socketThreadWrites;  ///< Data which could not be sent right away, waiting for the socket to become writable.
+#if defined(WZ_SOCKET_EPOLL)
+static int socketThreadEpollFd = -1;             ///< Watches the sockets in socketThreadWrites for writing, or -1 to use select().
+#endif
 
 
 static void socketCloseNow(Socket *sock);
@@ -332,7 +348,8 @@ const char *strSockError(int error)
  */
 static bool connectionIsOpen(Socket *sock)
 {
-	const SocketSet set = {std::vector<Socket *>(1, sock)};
+	SocketSet set;
+	set.fds.push_back(sock);
 
 	ASSERT_OR_RETURN((setSockErr(EBADF), false),
 	                 sock && sock->fd[SOCK_CONNECTION] != INVALID_SOCKET, "Invalid socket");
@@ -374,100 +391,185 @@ static bool connectionIsOpen(Socket *sock)
 	return true;
 }
 
-static int socketThreadFunction(void *)
+/// Starts or stops watching the socket for writing, when it gets or loses its entry in socketThreadWrites. Call with socketThreadMutex locked.
+static void socketThreadWatch(Socket *sock, bool watch)
 {
-	wzMutexLock(socketThreadMutex);
-	while (!socketThreadQuit)
+#if defined(WZ_SOCKET_EPOLL)
+	if (socketThreadEpollFd != -1)
 	{
-#if   defined(WZ_OS_UNIX)
-		SOCKET maxfd = INT_MIN;
-#elif defined(WZ_OS_WIN)
-		SOCKET maxfd = 0;
+		struct epoll_event event;
+		event.events = EPOLLOUT;
+		event.data.ptr = sock;
+		if (epoll_ctl(socketThreadEpollFd, watch ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, sock->fd[SOCK_CONNECTION], &event) != 0 && watch)
+		{
+			debug(LOG_ERROR, "epoll_ctl failed: %s", strSockError(getSockErr()));
+		}
+	}
+#else
+	(void)sock;
+	(void)watch;
 #endif
-		fd_set fds;
-		FD_ZERO(&fds);
-		for (SocketThreadWriteMap::iterator i = socketThreadWrites.begin(); i != socketThreadWrites.end(); ++i)
+}
+
+/// Writes as much as possible of the data queued for the socket, which should be ready for writing. Call with socketThreadMutex locked.
+static void socketThreadWrite(SocketThreadWriteMap::iterator w)
+{
+	Socket *sock = w->first;
+	std::vector<uint8_t> &writeQueue = w->second;
+	ASSERT(!writeQueue.empty(), "writeQueue[sock] must not be empty.");
+
+	// Write data.
+	// FIXME SOMEHOW AAARGH This send() call can't block, but unless the socket is not set to blocking (setting the socket to nonblocking had better work, or else), does anyway (at least sometimes, when someone quits). Not reproducible except in public releases.
+	ssize_t ret = send(sock->fd[SOCK_CONNECTION], reinterpret_cast<char *>(&writeQueue[0]), writeQueue.size(), MSG_NOSIGNAL);
+	if (ret != SOCKET_ERROR)
+	{
+		// Erase as much data as written.
+		writeQueue.erase(writeQueue.begin(), writeQueue.begin() + ret);
+		if (writeQueue.empty())
 		{
-			if (!i->second.empty())
+			socketThreadWatch(sock, false);
+			socketThreadWrites.erase(w);  // Nothing left to write, delete from pending list.
+			if (sock->deleteLater)
 			{
-				SOCKET fd = i->first->fd[SOCK_CONNECTION];
-				maxfd = std::max(maxfd, fd);
-				ASSERT(!FD_ISSET(fd, &fds), "Duplicate file descriptor!");  // Shouldn't be possible, but blocking in send, after select says it won't block, shouldn't be possible either.
-				FD_SET(fd, &fds);
+				socketCloseNow(sock);
 			}
 		}
-		struct timeval tv = {0, 50 * 1000};
+	}
+	else
+	{
+		switch (getSockErr())
+		{
+		case EAGAIN:
+#if defined(EWOULDBLOCK) && EAGAIN != EWOULDBLOCK
+		case EWOULDBLOCK:
+#endif
+			if (!connectionIsOpen(sock))
+			{
+				debug(LOG_NET, "Socket error");
+				sock->writeError = true;
+				socketThreadWatch(sock, false);
+				socketThreadWrites.erase(w);  // Socket broken, don't try writing to it again.
+				if (sock->deleteLater)
+				{
+					socketCloseNow(sock);
+				}
+				break;
+			}
+		case EINTR:
+			break;
+#if defined(EPIPE)
+		case EPIPE:
+#endif
+		default:
+			sock->writeError = true;
+			socketThreadWatch(sock, false);
+			socketThreadWrites.erase(w);  // Socket broken, don't try writing to it again.
+			if (sock->deleteLater)
+			{
+				socketCloseNow(sock);
+			}
+			break;
+		}
+	}
+}
 
-		// Check if we can write to any sockets.
-		wzMutexUnlock(socketThreadMutex);
-		int ret = select(maxfd + 1, nullptr, &fds, nullptr, &tv);
-		wzMutexLock(socketThreadMutex);
+/// Sends what can be sent right away, and queues the rest for the socket thread. Call with socketThreadMutex locked.
+static void socketWriteOrQueue(Socket *sock, const uint8_t *data, size_t size)
+{
+	SocketThreadWriteMap::iterator w = socketThreadWrites.find(sock);
+	if (w == socketThreadWrites.end())
+	{
+		// Nothing waiting to be written first. If send() fails, queue everything, and let the socket thread deal with the error.
+		ssize_t ret;
+		do
+		{
+			ret = send(sock->fd[SOCK_CONNECTION], reinterpret_cast<char const *>(data), size, MSG_NOSIGNAL);
+		}
+		while (ret == SOCKET_ERROR && getSockErr() == EINTR);
+		if (ret != SOCKET_ERROR)
+		{
+			data += ret;
+			size -= ret;
+		}
+		if (size == 0)
+		{
+			return;
+		}
 
-		// We can write to some sockets. (Ignore errors from select, we may have deleted the socket after unlocking the mutex, and before calling select.)
-		if (ret > 0)
+		if (socketThreadWrites.empty())
 		{
-			for (SocketThreadWriteMap::iterator i = socketThreadWrites.begin(); i != socketThreadWrites.end();)
-			{
-				SocketThreadWriteMap::iterator w = i;
-				++i;
+			wzSemaphorePost(socketThreadSemaphore);
+		}
+		w = socketThreadWrites.insert(std::make_pair(sock, std::vector<uint8_t>())).first;
+		socketThreadWatch(sock, true);
+	}
+	w->second.insert(w->second.end(), data, data + size);
+}
 
-				Socket *sock = w->first;
-				std::vector<uint8_t> &writeQueue = w->second;
-				ASSERT(!writeQueue.empty(), "writeQueue[sock] must not be empty.");
+static int socketThreadFunction(void *)
+{
+	wzMutexLock(socketThreadMutex);
+	while (!socketThreadQuit)
+	{
+#if defined(WZ_SOCKET_EPOLL)
+		if (socketThreadEpollFd != -1 && !socketThreadWrites.empty())
+		{
+			struct epoll_event events[64];
+
+			// Check if we can write to any sockets.
+			wzMutexUnlock(socketThreadMutex);
+			int ret = epoll_wait(socketThreadEpollFd, events, ARRAY_SIZE(events), 50);
+			wzMutexLock(socketThreadMutex);
 
-				if (!FD_ISSET(sock->fd[SOCK_CONNECTION], &fds))
+			// Only this thread removes sockets from socketThreadWrites, so they are all still there, unless we are shutting down.
+			for (int n = 0; n < ret; ++n)
+			{
+				SocketThreadWriteMap::iterator w = socketThreadWrites.find(static_cast<Socket *>(events[n].data.ptr));
+				if (w != socketThreadWrites.end())
 				{
-					continue;  // This socket is not ready for writing, or we don't have anything to write.
+					socketThreadWrite(w);
 				}
-
-				// Write data.
-				// FIXME SOMEHOW AAARGH This send() call can't block, but unless the socket is not set to blocking (setting the socket to nonblocking had better work, or else), does anyway (at least sometimes, when someone quits). Not reproducible except in public releases.
-				ssize_t ret = send(sock->fd[SOCK_CONNECTION], reinterpret_cast<char *>(&writeQueue[0]), writeQueue.size(), MSG_NOSIGNAL);
-				if (ret != SOCKET_ERROR)
+			}
+		}
+		else
+#endif
+		if (!socketThreadWrites.empty())
+		{
+#if   defined(WZ_OS_UNIX)
+			SOCKET maxfd = INT_MIN;
+#elif defined(WZ_OS_WIN)
+			SOCKET maxfd = 0;
+#endif
+			fd_set fds;
+			FD_ZERO(&fds);
+			for (SocketThreadWriteMap::iterator i = socketThreadWrites.begin(); i != socketThreadWrites.end(); ++i)
+			{
+				if (!i->second.empty())
 				{
-					// Erase as much data as written.
-					writeQueue.erase(writeQueue.begin(), writeQueue.begin() + ret);
-					if (writeQueue.empty())
-					{
-						socketThreadWrites.erase(w);  // Nothing left to write, delete from pending list.
-						if (sock->deleteLater)
-						{
-							socketCloseNow(sock);
-						}
-					}
+					SOCKET fd = i->first->fd[SOCK_CONNECTION];
+					maxfd = std::max(maxfd, fd);
+					ASSERT(!FD_ISSET(fd, &fds), "Duplicate file descriptor!");  // Shouldn't be possible, but blocking in send, after select says it won't block, shouldn't be possible either.
+					FD_SET(fd, &fds);
 				}
-				else
+			}
+			struct timeval tv = {0, 50 * 1000};
+
+			// Check if we can write to any sockets.
+			wzMutexUnlock(socketThreadMutex);
+			int ret = select(maxfd + 1, nullptr, &fds, nullptr, &tv);
+			wzMutexLock(socketThreadMutex);
+
+			// We can write to some sockets. (Ignore errors from select, we may have deleted the socket after unlocking the mutex, and before calling select.)
+			if (ret > 0)
+			{
+				for (SocketThreadWriteMap::iterator i = socketThreadWrites.begin(); i != socketThreadWrites.end();)
 				{
-					switch (getSockErr())
+					SocketThreadWriteMap::iterator w = i;
+					++i;
+
+					if (FD_ISSET(w->first->fd[SOCK_CONNECTION], &fds))
 					{
-					case EAGAIN:
-#if defined(EWOULDBLOCK) && EAGAIN != EWOULDBLOCK
-					case EWOULDBLOCK:
-#endif
-						if (!connectionIsOpen(sock))
-						{
-							debug(LOG_NET, "Socket error");
-							sock->writeError = true;
-							socketThreadWrites.erase(w);  // Socket broken, don't try writing to it again.
-							if (sock->deleteLater)
-							{
-								socketCloseNow(sock);
-							}
-							break;
-						}
-					case EINTR:
-						break;
-#if defined(EPIPE)
-					case EPIPE:
-#endif
-					default:
-						sock->writeError = true;
-						socketThreadWrites.erase(w);  // Socket broken, don't try writing to it again.
-						if (sock->deleteLater)
-						{
-							socketCloseNow(sock);
-						}
-						break;
+						socketThreadWrite(w);
 					}
 				}
 			}
@@ -614,60 +716,14 @@ ssize_t writeAll(Socket *sock, const void *buf, size_t size, size_t *rawByteCoun
 		if (!sock->isCompressed)
 		{
 			wzMutexLock(socketThreadMutex);
-			if (socketThreadWrites.empty())
-			{
-				wzSemaphorePost(socketThreadSemaphore);
-			}
-			std::vector<uint8_t> &writeQueue = socketThreadWrites[sock];
-			writeQueue.insert(writeQueue.end(), static_cast<char const *>(buf), static_cast<char const *>(buf) + size);
+			socketWriteOrQueue(sock, static_cast<uint8_t const *>(buf), size);
 			wzMutexUnlock(socketThreadMutex);
 			rawBytes = size;
 		}
 		else
 		{
-		#if ZLIB_VERNUM < 0x1252
-			// zlib < 1.2.5.2 does not support `#define ZLIB_CONST`
-			// Unfortunately, some OSes (ex. OpenBSD) ship with zlib < 1.2.5.2
-			// Workaround: cast away the const of the input, and disable the resulting -Wcast-qual warning
-			#if defined(__clang__)
-			#  pragma clang diagnostic push
-			#  pragma clang diagnostic ignored "-Wcast-qual"
-			#elif defined(__GNUC__)
-			#  pragma GCC diagnostic push
-			#  pragma GCC diagnostic ignored "-Wcast-qual"
-			#endif
-
-			// cast away the const for earlier zlib versions
-			sock->zDeflate.next_in = (Bytef *)buf; // -Wcast-qual
-
-			#if defined(__clang__)
-			#  pragma clang diagnostic pop
-			#elif defined(__GNUC__)
-			#  pragma GCC diagnostic pop
-			#endif
-		#else
-			// zlib >= 1.2.5.2 supports ZLIB_CONST
-			sock->zDeflate.next_in = (const Bytef *)buf;
-		#endif
-
-			sock->zDeflate.avail_in = size;
-			sock->zDeflateInSize += sock->zDeflate.avail_in;
-			do
-			{
-				size_t alreadyHave = sock->zDeflateOutBuf.size();
-				sock->zDeflateOutBuf.resize(alreadyHave + size + 20);  // A bit more than size should be enough to always do everything in one go.
-				sock->zDeflate.next_out = (Bytef *)&sock->zDeflateOutBuf[alreadyHave];
-				sock->zDeflate.avail_out = sock->zDeflateOutBuf.size() - alreadyHave;
-
-				int ret = deflate(&sock->zDeflate, Z_NO_FLUSH);
-				ASSERT(ret != Z_STREAM_ERROR, "zlib compression failed!");
-
-				// Remove unused part of buffer.
-				sock->zDeflateOutBuf.resize(sock->zDeflateOutBuf.size() - sock->zDeflate.avail_out);
-			}
-			while (sock->zDeflate.avail_out == 0);
-
-			ASSERT(sock->zDeflate.avail_in == 0, "zlib didn't compress everything!");
+			// Compressed when flushed, so that all messages since the last flush cost a single deflate() call.
+			sock->zDeflateInBuf.insert(sock->zDeflateInBuf.end(), static_cast<char const *>(buf), static_cast<char const *>(buf) + size);
 		}
 	}
 
@@ -685,13 +741,13 @@ void socketFlush(Socket *sock, size_t *rawByteCount)
 		return;  // Not compressed, so don't mess with zlib.
 	}
 
-	// Flush data out of zlib compression state.
+	// Compress everything written since the last flush, and flush it out of zlib compression state.
+	sock->zDeflate.next_in = sock->zDeflateInBuf.empty() ? nullptr : &sock->zDeflateInBuf[0];
+	sock->zDeflate.avail_in = sock->zDeflateInBuf.size();
 	do
 	{
-		sock->zDeflate.next_in = (Bytef *)nullptr;
-		sock->zDeflate.avail_in = 0;
 		size_t alreadyHave = sock->zDeflateOutBuf.size();
-		sock->zDeflateOutBuf.resize(alreadyHave + 1000);  // 100 bytes would probably be enough to flush the rest in one go.
+		sock->zDeflateOutBuf.resize(alreadyHave + sock->zDeflate.avail_in + 1000);  // Compressed data is rarely bigger than the input, and 100 bytes would probably be enough to flush the rest in one go.
 		sock->zDeflate.next_out = (Bytef *)&sock->zDeflateOutBuf[alreadyHave];
 		sock->zDeflate.avail_out = sock->zDeflateOutBuf.size() - alreadyHave;
 
@@ -703,28 +759,26 @@ void socketFlush(Socket *sock, size_t *rawByteCount)
 	}
 	while (sock->zDeflate.avail_out == 0);
 
+	ASSERT(sock->zDeflate.avail_in == 0, "zlib didn't compress everything!");
+
 	if (sock->zDeflateOutBuf.empty())
 	{
+		sock->zDeflateInBuf.clear();
 		return;  // No data to flush out.
 	}
 
 	wzMutexLock(socketThreadMutex);
-	if (socketThreadWrites.empty())
-	{
-		wzSemaphorePost(socketThreadSemaphore);
-	}
-	std::vector<uint8_t> &writeQueue = socketThreadWrites[sock];
-	writeQueue.insert(writeQueue.end(), sock->zDeflateOutBuf.begin(), sock->zDeflateOutBuf.end());
+	socketWriteOrQueue(sock, &sock->zDeflateOutBuf[0], sock->zDeflateOutBuf.size());
 	wzMutexUnlock(socketThreadMutex);
 
 	// Primitive network logging, uncomment to use.
-	//printf("Size %3u ->%3zu, buf =", sock->zDeflateInSize, sock->zDeflateOutBuf.size());
+	//printf("Size %3u ->%3zu, buf =", (unsigned)sock->zDeflateInBuf.size(), sock->zDeflateOutBuf.size());
 	//for (unsigned n = 0; n < std::min<unsigned>(sock->zDeflateOutBuf.size(), 40); ++n) printf(" %02X", sock->zDeflateOutBuf[n]);
 	//printf("\n");
 
 	// Data sent, don't send again.
 	rawBytes = sock->zDeflateOutBuf.size();
-	sock->zDeflateInSize = 0;
+	sock->zDeflateInBuf.clear();
 	sock->zDeflateOutBuf.clear();
 }
 
@@ -767,9 +821,34 @@ Socket::~Socket()
 	}
 }
 
+SocketSet::SocketSet()
+#if defined(WZ_SOCKET_EPOLL)
+	: epollFd(-1)
+#endif
+{
+}
+
+SocketSet::~SocketSet()
+{
+#if defined(WZ_SOCKET_EPOLL)
+	if (epollFd != -1)
+	{
+		close(epollFd);
+	}
+#endif
+}
+
 SocketSet *allocSocketSet()
 {
-	return new SocketSet;
+	SocketSet *set = new SocketSet;
+#if defined(WZ_SOCKET_EPOLL)
+	set->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (set->epollFd == -1)
+	{
+		debug(LOG_WARNING, "epoll_create1 failed, using select instead: %s", strSockError(getSockErr()));
+	}
+#endif
+	return set;
 }
 
 void deleteSocketSet(SocketSet *set)
@@ -796,6 +875,21 @@ void SocketSet_AddSocket(SocketSet *set, Socket *socket)
 
 	set->fds.push_back(socket);
 	debug(LOG_NET, "Socket added: set->fds[%lu] = %p", (unsigned long)i, static_cast<void *>(socket));
+
+#if defined(WZ_SOCKET_EPOLL)
+	if (set->epollFd != -1)
+	{
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.ptr = socket;
+		if (epoll_ctl(set->epollFd, EPOLL_CTL_ADD, socket->fd[SOCK_CONNECTION], &event) != 0)
+		{
+			debug(LOG_WARNING, "epoll_ctl failed, using select instead: %s", strSockError(getSockErr()));
+			close(set->epollFd);
+			set->epollFd = -1;
+		}
+	}
+#endif
 }
 
 /**
@@ -808,6 +902,22 @@ void SocketSet_DelSocket(SocketSet *set, Socket *socket)
 	{
 		debug(LOG_NET, "Socket %p erased (set->fds[%lu])", static_cast<void *>(socket), (unsigned long)i);
 		set->fds.erase(set->fds.begin() + i);
+
+#if defined(WZ_SOCKET_EPOLL)
+		if (set->epollFd != -1)
+		{
+			struct epoll_event event;  // Ignored, but must not be null for old kernels.
+			if (epoll_ctl(set->epollFd, EPOLL_CTL_DEL, socket->fd[SOCK_CONNECTION], &event) != 0)
+			{
+				int err = getSockErr();
+				// ENOENT or EBADF just mean the descriptor was already closed, which drops it from the set.
+				if (err != ENOENT && err != EBADF)
+				{
+					debug(LOG_ERROR, "epoll_ctl failed: %s", strSockError(err));
+				}
+			}
+		}
+#endif
 	}
 }
 
@@ -903,6 +1013,37 @@ int checkSockets(const SocketSet *set, unsigned int timeout)
 		return ret;
 	}
 
+#if defined(WZ_SOCKET_EPOLL)
+	if (set->epollFd != -1)
+	{
+		for (size_t i = 0; i < set->fds.size(); ++i)
+		{
+			set->fds[i]->ready = false;
+		}
+		set->events.resize(set->fds.size());
+
+		int ret;
+		do
+		{
+			ret = epoll_wait(set->epollFd, &set->events[0], set->events.size(), timeout);
+		}
+		while (ret == SOCKET_ERROR && getSockErr() == EINTR);
+
+		if (ret == SOCKET_ERROR)
+		{
+			debug(LOG_ERROR, "epoll_wait failed: %s", strSockError(getSockErr()));
+			return SOCKET_ERROR;
+		}
+
+		for (int i = 0; i < ret; ++i)
+		{
+			static_cast<Socket *>(set->events[i].data.ptr)->ready = true;
+		}
+
+		return ret;
+	}
+#endif
+
 	int ret;
 	fd_set fds;
 	do
@@ -953,7 +1094,8 @@ ssize_t readAll(Socket *sock, void *buf, size_t size, unsigned int timeout)
 {
 	ASSERT(!sock->isCompressed, "readAll on compressed sockets not implemented.");
 
-	const SocketSet set = {std::vector<Socket *>(1, sock)};
+	SocketSet set;
+	set.fds.push_back(sock);
 
 	size_t received = 0;
 
@@ -1500,6 +1642,13 @@ void SOCKETinit()
 		socketThreadQuit = false;
 		socketThreadMutex = wzMutexCreate();
 		socketThreadSemaphore = wzSemaphoreCreate(0);
+#if defined(WZ_SOCKET_EPOLL)
+		socketThreadEpollFd = epoll_create1(EPOLL_CLOEXEC);
+		if (socketThreadEpollFd == -1)
+		{
+			debug(LOG_WARNING, "epoll_create1 failed, using select instead: %s", strSockError(getSockErr()));
+		}
+#endif
 		socketThread = wzThreadCreate(socketThreadFunction, nullptr);
 		wzThreadStart(socketThread);
 	}
@@ -1517,6 +1666,13 @@ void SOCKETshutdown()
 		wzThreadJoin(socketThread);
 		wzMutexDestroy(socketThreadMutex);
 		wzSemaphoreDestroy(socketThreadSemaphore);
+#if defined(WZ_SOCKET_EPOLL)
+		if (socketThreadEpollFd != -1)
+		{
+			close(socketThreadEpollFd);
+			socketThreadEpollFd = -1;
+		}
+#endif
 		socketThread = nullptr;
 	}
 
@@ -39,6 +39,7 @@
 #include "nettypes.h"
 #include "netqueue.h"
 #include "netlog.h"
+#include "netreplay.h"
 #include "src/order.h"
 #include <cstring>
 
@@ -265,6 +266,28 @@ static void queue(const Q &q, std::vector<T> &v)
 	}
 }
 
+// Byte vectors are copied in one go, instead of a byte at a time.
+static void queue(const MessageWriter &q, std::vector<uint8_t> &v)
+{
+	uint32_t len = v.size();
+	queue(q, len);
+	q.bytes(v.data(), len);
+}
+
+static void queue(const MessageReader &q, std::vector<uint8_t> &v)
+{
+	uint32_t len = 0;
+	queue(q, len);
+	v.clear();
+	if (q.valid())
+	{
+		// Same result as the generic version, which stops after the first byte past the end of the message.
+		size_t have = std::min<size_t>(len, q.remaining());
+		v.resize(have < len ? have + 1 : have);
+		q.bytes(v.data(), v.size());
+	}
+}
+
 template<class Q>
 static void queue(const Q &q, NetMessage &v)
 {
@@ -285,6 +308,19 @@ static void queueAuto(T &v)
 	}
 }
 
+/// Like queueAuto, for n bytes at once.
+static void queueBytesAuto(uint8_t *v, size_t n)
+{
+	if (NETgetPacketDir() == PACKET_ENCODE)
+	{
+		writer.bytes(v, n);
+	}
+	else if (NETgetPacketDir() == PACKET_DECODE)
+	{
+		reader.bytes(v, n);
+	}
+}
+
 // Queue selection functions
 
 /// Gets the &NetQueuePair::send or NetQueue *, corresponding to queue.
@@ -455,7 +491,8 @@ void NETbeginEncode(NETQUEUE queue, uint8_t type)
 	NETsetPacketDir(PACKET_ENCODE);
 
 	queueInfo = queue;
-	message = type;
+	message.type = type;
+	message.data.clear();  // Keeps the buffer from the previous message.
 	writer = MessageWriter(message);
 }
 
@@ -475,6 +512,13 @@ bool NETend()
 	// If we are encoding just return true
 	if (NETgetPacketDir() == PACKET_ENCODE)
 	{
+		if ((queueInfo.queueType == QUEUE_GAME || queueInfo.queueType == QUEUE_GAME_FORCED) && NETisReplay())
+		{
+			// The replay already has the game queue messages that were sent, so don't add our own.
+			NETsetPacketDir(PACKET_INVALID);
+			return true;
+		}
+
 		// Push the message onto the list.
 		NetQueue *queue = sendQueue(queueInfo);
 		if (queue == nullptr) {
@@ -553,6 +597,33 @@ bool NETend()
 	return false;
 }
 
+void NETbeginEncodeMessage(uint8_t type)
+{
+	NETsetPacketDir(PACKET_ENCODE);
+
+	queueInfo = NETQUEUE();
+	message.type = type;
+	message.data.clear();
+	writer = MessageWriter(message);
+}
+
+void NETendEncodeMessage(NetMessage *output)
+{
+	ASSERT(NETgetPacketDir() == PACKET_ENCODE, "Not encoding a message.");
+	*output = message;
+
+	NETsetPacketDir(PACKET_INVALID);
+}
+
+void NETbeginDecodeMessage(NetMessage const *input)
+{
+	NETsetPacketDir(PACKET_DECODE);
+
+	queueInfo = NETQUEUE();
+	message = *input;
+	reader = MessageReader(message);
+}
+
 void NETflushGameQueues()
 {
 	for (uint8_t player = 0; player < MAX_PLAYERS; ++player)
@@ -586,6 +657,10 @@ void NETflushGameQueues()
 
 void NETpop(NETQUEUE queue)
 {
+	if (queue.queueType == QUEUE_GAME)
+	{
+		NETreplaySaveNetMessage(receiveQueue(queue)->getMessage(), queue.index);  // Game queue messages are recorded in the order they are processed.
+	}
 	receiveQueue(queue)->popMessage();
 }
 
@@ -667,10 +742,7 @@ void NETstring(char *str, uint16_t maxlen)
 		len = maxlen - 1;
 	}
 
-	for (unsigned i = 0; i < len; ++i)
-	{
-		queueAuto(str[i]);
-	}
+	queueBytesAuto(reinterpret_cast<uint8_t *>(str), len);
 
 	if (NETgetPacketDir() == PACKET_DECODE)
 	{
@@ -746,18 +818,12 @@ void NETbytes(std::vector<uint8_t> *vec, unsigned maxLen)
 		vec->resize(len);  // vec->assign(len, 0) would call the wrong version of assign, here.
 	}
 
-	for (unsigned i = 0; i < len; ++i)
-	{
-		queueAuto((*vec)[i]);
-	}
+	queueBytesAuto(vec->data(), len);
 }
 
 void NETbin(uint8_t *str, uint32_t len)
 {
-	for (unsigned i = 0; i < len; ++i)
-	{
-		queueAuto(str[i]);
-	}
+	queueBytesAuto(str, len);
 }
 
 void NETPosition(Position *vp)
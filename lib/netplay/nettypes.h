@@ -76,6 +76,9 @@ void NETdeleteQueue();					///< Delete queues for cleanup
 void NETbeginEncode(NETQUEUE queue, uint8_t type);
 void NETbeginDecode(NETQUEUE queue, uint8_t type);
 bool NETend();
+void NETbeginEncodeMessage(uint8_t type);               ///< Like NETbeginEncode, but into a message which doesn't go in any queue. Finish with NETendEncodeMessage.
+void NETendEncodeMessage(NetMessage *message);          ///< Finishes NETbeginEncodeMessage, copying the encoded message to message.
+void NETbeginDecodeMessage(NetMessage const *message);  ///< Like NETbeginDecode, but from a message which isn't in any queue. Finish with NETend.
 void NETflushGameQueues();
 void NETpop(NETQUEUE queue);
 
@@ -1088,6 +1088,11 @@ void wzYieldCurrentThread()
 #endif
 }
 
+int wzGetCPUCount()
+{
+	return QThread::idealThreadCount();
+}
+
 WZ_MUTEX *wzMutexCreate()
 {
 	return new WZ_MUTEX;
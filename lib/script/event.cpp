@@ -24,6 +24,8 @@
  */
 #include "lib/framework/frame.h"
 
+#include <algorithm>
+
 #include "event.h"
 #include "script.h"
 
@@ -32,11 +34,17 @@ static VAL_CREATE_FUNC	*asCreateFuncs = nullptr;
 static VAL_RELEASE_FUNC	*asReleaseFuncs = nullptr;
 static UDWORD		numFuncs;
 
-/** The list of currently active triggers */
-ACTIVE_TRIGGER		*psTrigList = nullptr;
+/** The currently active timed triggers, in a heap ordered by eventTriggerFiresAfter */
+static std::vector<ACTIVE_TRIGGER *> apsTrigHeap;
+
+/** Counts the triggers added to the heap, to keep the order of those due at the same time */
+static UDWORD		trigSequence = 0;
+
+/** The callback triggers, a list for each type starting at TR_CALLBACKSTART, newest first */
+static std::vector<ACTIVE_TRIGGER *> apsCallbacks;
 
-/** The list of callback triggers */
-ACTIVE_TRIGGER		*psCallbackList = nullptr;
+/** Whether any trigger in the heap or lists has been marked for deletion since they were last pruned */
+static bool			triggersMarked = false;
 
 /** The new triggers added this loop */
 static ACTIVE_TRIGGER	*psAddedTriggers = nullptr;
@@ -99,13 +107,42 @@ static void eventFreeTrigger(ACTIVE_TRIGGER *psTrigger);
 
 // Remove triggers marked for deletion
 static void eventPruneList(ACTIVE_TRIGGER **psList);
+static void eventPruneHeap();
 static void eventPruneLists(void)
 {
-	eventPruneList(&psTrigList);
-	eventPruneList(&psCallbackList);
+	if (!triggersMarked)
+	{
+		return;
+	}
+	triggersMarked = false;
+
+	eventPruneHeap();
+	for (ACTIVE_TRIGGER *&psList : apsCallbacks)
+	{
+		eventPruneList(&psList);
+	}
 	eventPruneList(&psAddedTriggers);
 }
 
+// Whether trigger a fires after trigger b. Of the triggers due at the same time, the one added last fires first.
+static bool eventTriggerFiresAfter(const ACTIVE_TRIGGER *psA, const ACTIVE_TRIGGER *psB)
+{
+	if (psA->testTime != psB->testTime)
+	{
+		return psA->testTime > psB->testTime;
+	}
+	return psA->sequence < psB->sequence;
+}
+
+// Take the next trigger to fire off the heap
+static ACTIVE_TRIGGER *eventPopTrigger()
+{
+	std::pop_heap(apsTrigHeap.begin(), apsTrigHeap.end(), eventTriggerFiresAfter);
+	ACTIVE_TRIGGER *psTrigger = apsTrigHeap.back();
+	apsTrigHeap.pop_back();
+	return psTrigger;
+}
+
 //resets the event timer - updateTime
 void eventTimeReset(UDWORD initTime)
 {
@@ -115,14 +152,16 @@ void eventTimeReset(UDWORD initTime)
 /* Initialise the event system */
 bool eventInitialise()
 {
-	psTrigList = nullptr;
-	psCallbackList = nullptr;
+	apsTrigHeap.clear();
+	trigSequence = 0;
+	apsCallbacks.clear();
+	triggersMarked = false;
 	psContList = nullptr;
 	eventTraceLevel = 0;
 	asCreateFuncs = nullptr;
 	asReleaseFuncs = nullptr;
 	numFuncs = 0;
-	sstrcpy(last_called_script_event, "<none>");
+	last_called_script_event = "<none>";
 	return true;
 }
 
@@ -132,11 +171,10 @@ void eventReset(void)
 	SDWORD			count = 0;
 
 	// Free any active triggers and their context's
-	while (psTrigList)
+	while (!apsTrigHeap.empty())
 	{
-		ACTIVE_TRIGGER	*psCurr = psTrigList;
+		ACTIVE_TRIGGER	*psCurr = eventPopTrigger();
 
-		psTrigList = psTrigList->psNext;
 		if (!psCurr->psContext->release)
 		{
 			count += 1;
@@ -144,18 +182,22 @@ void eventReset(void)
 		eventRemoveContext(psCurr->psContext);
 		free(psCurr);
 	}
+	trigSequence = 0;
 	// Free any active callback triggers and their context's
-	while (psCallbackList)
+	for (ACTIVE_TRIGGER *&psList : apsCallbacks)
 	{
-		ACTIVE_TRIGGER	*psCurr = psCallbackList;
-
-		psCallbackList = psCallbackList->psNext;
-		if (!psCurr->psContext->release)
+		while (psList)
 		{
-			count += 1;
+			ACTIVE_TRIGGER	*psCurr = psList;
+
+			psList = psList->psNext;
+			if (!psCurr->psContext->release)
+			{
+				count += 1;
+			}
+			eventRemoveContext(psCurr->psContext);
+			free(psCurr);
 		}
-		eventRemoveContext(psCurr->psContext);
-		free(psCurr);
 	}
 	// Now free any contexts that are left
 	while (psContList)
@@ -526,52 +568,44 @@ void eventRemoveContext(SCRIPT_CONTEXT *psContext)
 	SDWORD			i, chunkStart;
 	INTERP_VAL		*psVal;
 
-	// Get rid of all it's triggers
-	while (psTrigList && psTrigList->psContext == psContext)
+	// Get rid of all it's triggers. They are only freed, since the context is going anyway.
+	auto trigEnd = std::remove_if(apsTrigHeap.begin(), apsTrigHeap.end(), [psContext](ACTIVE_TRIGGER *psTrigger)
 	{
-		psNext = psTrigList->psNext;
-		eventFreeTrigger(psTrigList);
-		psTrigList = psNext;
-	}
-
-	for (psPrev = nullptr, psCurr = psTrigList; psCurr; psCurr = psNext)
-	{
-		psNext = psCurr->psNext;
-		if (psCurr->psContext == psContext)
-		{
-			eventFreeTrigger(psCurr);
-			if (psPrev)
-			{
-				psPrev->psNext = psNext;
-			}
-		}
-		else
+		if (psTrigger->psContext != psContext)
 		{
-			psPrev = psCurr;
+			return false;
 		}
-	}
-	// Get rid of all it's callback triggers
-	while (psCallbackList && psCallbackList->psContext == psContext)
+		free(psTrigger);
+		return true;
+	});
+	if (trigEnd != apsTrigHeap.end())
 	{
-		psNext = psCallbackList->psNext;
-		eventFreeTrigger(psCallbackList);
-		psCallbackList = psNext;
+		apsTrigHeap.erase(trigEnd, apsTrigHeap.end());
+		std::make_heap(apsTrigHeap.begin(), apsTrigHeap.end(), eventTriggerFiresAfter);
 	}
 
-	for (psPrev = nullptr, psCurr = psCallbackList; psCurr; psCurr = psNext)
+	// Get rid of all it's callback triggers
+	for (ACTIVE_TRIGGER *&psList : apsCallbacks)
 	{
-		psNext = psCurr->psNext;
-		if (psCurr->psContext == psContext)
+		for (psPrev = nullptr, psCurr = psList; psCurr; psCurr = psNext)
 		{
-			eventFreeTrigger(psCurr);
-			if (psPrev)
+			psNext = psCurr->psNext;
+			if (psCurr->psContext == psContext)
 			{
-				psPrev->psNext = psNext;
+				free(psCurr);
+				if (psPrev)
+				{
+					psPrev->psNext = psNext;
+				}
+				else
+				{
+					psList = psNext;
+				}
+			}
+			else
+			{
+				psPrev = psCurr;
 			}
-		}
-		else
-		{
-			psPrev = psCurr;
 		}
 	}
 
@@ -698,57 +732,54 @@ bool eventSetContextVar(SCRIPT_CONTEXT *psContext, UDWORD index, INTERP_VAL *dat
 	return true;
 }
 
-// Add a trigger to the list in order
+// Add a trigger to the heap, or to the front of the list for its callback
 static void eventAddTrigger(ACTIVE_TRIGGER *psTrigger)
 {
-	UDWORD	testTime = psTrigger->testTime;
-
 	if (psTrigger->type >= TR_CALLBACKSTART)
 	{
-		// Add this to the callback trigger list
-		if (psCallbackList == nullptr)
-		{
-			psTrigger->psNext = nullptr;
-			psCallbackList = psTrigger;
-		}
-		else if (psTrigger->type <= psCallbackList->type)
-		{
-			psTrigger->psNext = psCallbackList;
-			psCallbackList = psTrigger;
-		}
-		else
-		{
-			ACTIVE_TRIGGER *psCurr, *psPrev = nullptr;
+		size_t bucket = psTrigger->type - TR_CALLBACKSTART;
 
-			for (psCurr = psCallbackList; psCurr && psCurr->type < psTrigger->type; psCurr = psCurr->psNext)
-			{
-				psPrev = psCurr;
-			}
-			psTrigger->psNext = psPrev->psNext;
-			psPrev->psNext =  psTrigger;
+		if (bucket >= apsCallbacks.size())
+		{
+			apsCallbacks.resize(bucket + 1, nullptr);
 		}
+		psTrigger->psNext = apsCallbacks[bucket];
+		apsCallbacks[bucket] = psTrigger;
 	}
-	else if (psTrigList == nullptr)
+	else
 	{
 		psTrigger->psNext = nullptr;
-		psTrigList = psTrigger;
-	}
-	else if (testTime <= psTrigList->testTime)
-	{
-		psTrigger->psNext = psTrigList;
-		psTrigList = psTrigger;
+		psTrigger->sequence = trigSequence++;
+		apsTrigHeap.push_back(psTrigger);
+		std::push_heap(apsTrigHeap.begin(), apsTrigHeap.end(), eventTriggerFiresAfter);
 	}
-	else
+}
+
+// The timed triggers, in the order they will fire
+std::vector<ACTIVE_TRIGGER *> eventGetTriggers()
+{
+	std::vector<ACTIVE_TRIGGER *> apsTriggers = apsTrigHeap;
+
+	std::sort(apsTriggers.begin(), apsTriggers.end(), [](const ACTIVE_TRIGGER *psA, const ACTIVE_TRIGGER *psB)
 	{
-		ACTIVE_TRIGGER *psCurr, *psPrev = nullptr;
+		return eventTriggerFiresAfter(psB, psA);
+	});
+	return apsTriggers;
+}
 
-		for (psCurr = psTrigList; psCurr && psCurr->testTime < testTime; psCurr = psCurr->psNext)
+// The callback triggers, in order of type and then in the order they will fire
+std::vector<ACTIVE_TRIGGER *> eventGetCallbackTriggers()
+{
+	std::vector<ACTIVE_TRIGGER *> apsTriggers;
+
+	for (ACTIVE_TRIGGER *psList : apsCallbacks)
+	{
+		for (ACTIVE_TRIGGER *psCurr = psList; psCurr; psCurr = psCurr->psNext)
 		{
-			psPrev = psCurr;
+			apsTriggers.push_back(psCurr);
 		}
-		psTrigger->psNext = psPrev->psNext;
-		psPrev->psNext =  psTrigger;
 	}
+	return apsTriggers;
 }
 
 // Initialise a trigger
@@ -885,81 +916,82 @@ void eventFireCallbackTrigger(TRIGGER_TYPE callback)
 		ASSERT(false, "Script interpreter is already running");
 		return;
 	}
+	ASSERT_OR_RETURN(, callback >= TR_CALLBACKSTART, "Not a callback: %d", (int)callback);
+
+	size_t bucket = callback - TR_CALLBACKSTART;
+	if (bucket >= apsCallbacks.size())
+	{
+		apsCallbacks.resize(bucket + 1, nullptr);
+	}
 
 	//this can be called from eventProcessTriggers and so will wipe out all the current added ones
 	//psAddedTriggers = NULL;
-	for (psCurr = psCallbackList; psCurr && psCurr->type <= (int)callback; psCurr = psNext)
+	for (psCurr = apsCallbacks[bucket]; psCurr; psCurr = psNext)
 	{
 		psNext = psCurr->psNext;
-		if (psCurr->type == (int)callback)
+
+		// see if the callback should be fired
+		fired = false;
+		if (psCurr->type != TR_PAUSE)
+		{
+			ASSERT(psCurr->trigger >= 0 && psCurr->trigger < psCurr->psContext->psCode->numTriggers, "Invalid trigger number");
+			psTrigDat = psCurr->psContext->psCode->psTriggerData + psCurr->trigger;
+		}
+		else
+		{
+			psTrigDat = nullptr;
+		}
+		if (psTrigDat && psTrigDat->code)
 		{
-			// see if the callback should be fired
-			fired = false;
-			if (psCurr->type != TR_PAUSE)
+			if (!interpRunScript(psCurr->psContext, IRT_TRIGGER, psCurr->trigger, 0))
 			{
-				ASSERT(psCurr->trigger >= 0 && psCurr->trigger < psCurr->psContext->psCode->numTriggers, "Invalid trigger number");
-				psTrigDat = psCurr->psContext->psCode->psTriggerData + psCurr->trigger;
+				ASSERT(false, "Trigger %s: code failed", eventGetTriggerID(psCurr->psContext->psCode, psCurr->trigger));
+				psPrev = psCurr;
+				continue;
 			}
-			else
+			if (!stackPopParams(1, VAL_BOOL, &fired))
 			{
-				psTrigDat = nullptr;
+				ASSERT(false, "Trigger %s: code failed", eventGetTriggerID(psCurr->psContext->psCode, psCurr->trigger));
+				psPrev = psCurr;
+				continue;
 			}
-			if (psTrigDat && psTrigDat->code)
+		}
+		else
+		{
+			fired = true;
+		}
+
+		// run the event
+		if (fired)
+		{
+			DB_TRIGINF(psCurr, 1);
+			DB_TRACE(" fired", 1);
+
+			// remove the trigger from the list
+			if (psPrev == nullptr)
 			{
-				if (!interpRunScript(psCurr->psContext, IRT_TRIGGER, psCurr->trigger, 0))
-				{
-					ASSERT(false, "Trigger %s: code failed", eventGetTriggerID(psCurr->psContext->psCode, psCurr->trigger));
-					psPrev = psCurr;
-					continue;
-				}
-				if (!stackPopParams(1, VAL_BOOL, &fired))
-				{
-					ASSERT(false, "Trigger %s: code failed", eventGetTriggerID(psCurr->psContext->psCode, psCurr->trigger));
-					psPrev = psCurr;
-					continue;
-				}
+				apsCallbacks[bucket] = psNext;
 			}
 			else
 			{
-				fired = true;
+				psPrev->psNext = psNext;
 			}
 
-			// run the event
-			if (fired)
+			psFiringTrigger = psCurr;
+			if (!interpRunScript(psCurr->psContext, IRT_EVENT, psCurr->event, psCurr->offset)) // this could set psCurr->deactivated
 			{
-				DB_TRIGINF(psCurr, 1);
-				DB_TRACE(" fired", 1);
-
-				// remove the trigger from the list
-				if (psPrev == nullptr)
-				{
-					psCallbackList = psCallbackList->psNext;
-				}
-				else
-				{
-					psPrev->psNext = psNext;
-				}
-
-				psFiringTrigger = psCurr;
-				if (!interpRunScript(psCurr->psContext, IRT_EVENT, psCurr->event, psCurr->offset)) // this could set psCurr->deactivated
-				{
-					ASSERT(false, "Event %s: code failed", eventGetEventID(psCurr->psContext->psCode, psCurr->event));
-				}
-				if (psCurr->deactivated)
-				{
-					// don't need to add the trigger again - just free it
-					eventFreeTrigger(psCurr);
-				}
-				else
-				{
-					// make sure the trigger goes back into the system
-					psCurr->psNext = psAddedTriggers;
-					psAddedTriggers = psCurr;
-				}
+				ASSERT(false, "Event %s: code failed", eventGetEventID(psCurr->psContext->psCode, psCurr->event));
+			}
+			if (psCurr->deactivated)
+			{
+				// don't need to add the trigger again - just free it
+				eventFreeTrigger(psCurr);
 			}
 			else
 			{
-				psPrev = psCurr;
+				// make sure the trigger goes back into the system
+				psCurr->psNext = psAddedTriggers;
+				psAddedTriggers = psCurr;
 			}
 		}
 		else
@@ -1043,10 +1075,9 @@ void eventProcessTriggers(UDWORD currTime)
 	// Process all the current triggers
 	psAddedTriggers = nullptr;
 	updateTime = currTime;
-	while (psTrigList && psTrigList->testTime <= currTime)
+	while (!apsTrigHeap.empty() && apsTrigHeap.front()->testTime <= currTime)
 	{
-		psCurr = psTrigList;
-		psTrigList = psTrigList->psNext;
+		psCurr = eventPopTrigger();
 
 		// Run the trigger
 		if (eventFireTrigger(psCurr))	// This might mark the trigger for deletion
@@ -1115,33 +1146,72 @@ static void eventPruneList(ACTIVE_TRIGGER **ppsList)
 	}
 }
 
-// Mark a trigger for removal from a list
-static void eventMarkTriggerInList(ACTIVE_TRIGGER **ppsList, SCRIPT_CONTEXT *psContext, SDWORD event, SDWORD *pTrigger)
+// remove all marked triggers from the heap
+static void eventPruneHeap()
 {
-	ACTIVE_TRIGGER	**ppsCurr;
-
-	for (ppsCurr = ppsList;; ppsCurr = &(*ppsCurr)->psNext)
+	auto trigEnd = std::remove_if(apsTrigHeap.begin(), apsTrigHeap.end(), [](ACTIVE_TRIGGER *psTrigger)
 	{
-		if (!(*ppsCurr))
-		{
-			return;
-		}
-		else if ((*ppsCurr)->event == event &&
-		         (*ppsCurr)->psContext == psContext)
+		if (!psTrigger->deactivated)
 		{
-			break;
+			return false;
 		}
+		free(psTrigger);
+		return true;
+	});
+	if (trigEnd != apsTrigHeap.end())
+	{
+		apsTrigHeap.erase(trigEnd, apsTrigHeap.end());
+		std::make_heap(apsTrigHeap.begin(), apsTrigHeap.end(), eventTriggerFiresAfter);
 	}
-	if ((*ppsCurr)->type == TR_PAUSE)
+}
+
+// Mark a trigger for removal
+static void eventMarkTrigger(ACTIVE_TRIGGER *psTrigger, SDWORD *pTrigger)
+{
+	if (psTrigger->type == TR_PAUSE)
 	{
 		// pause trigger, don't remove it,
 		// just note the type for when the pause finishes
-		(*ppsCurr)->trigger = (SWORD) * pTrigger;
+		psTrigger->trigger = (SWORD) * pTrigger;
 		*pTrigger = -1;
 	}
 	else
 	{
-		(*ppsCurr)->deactivated = true;
+		psTrigger->deactivated = true;
+		triggersMarked = true;
+	}
+}
+
+// Mark a trigger for removal from a list
+static bool eventMarkTriggerInList(ACTIVE_TRIGGER **ppsList, SCRIPT_CONTEXT *psContext, SDWORD event, SDWORD *pTrigger)
+{
+	for (ACTIVE_TRIGGER *psCurr = *ppsList; psCurr; psCurr = psCurr->psNext)
+	{
+		if (psCurr->event == event && psCurr->psContext == psContext)
+		{
+			eventMarkTrigger(psCurr, pTrigger);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Mark the first trigger to fire for an event for removal from the heap
+static void eventMarkTriggerInHeap(SCRIPT_CONTEXT *psContext, SDWORD event, SDWORD *pTrigger)
+{
+	ACTIVE_TRIGGER	*psFirst = nullptr;
+
+	for (ACTIVE_TRIGGER *psCurr : apsTrigHeap)
+	{
+		if (psCurr->event == event && psCurr->psContext == psContext
+		    && (psFirst == nullptr || eventTriggerFiresAfter(psFirst, psCurr)))
+		{
+			psFirst = psCurr;
+		}
+	}
+	if (psFirst != nullptr)
+	{
+		eventMarkTrigger(psFirst, pTrigger);
 	}
 }
 
@@ -1173,8 +1243,14 @@ bool eventSetTrigger(void)
 	else
 	{
 		// Mark the old trigger in the lists
-		eventMarkTriggerInList(&psTrigList, psContext, event, &trigger);
-		eventMarkTriggerInList(&psCallbackList, psContext, event, &trigger);
+		eventMarkTriggerInHeap(psContext, event, &trigger);
+		for (ACTIVE_TRIGGER *&psList : apsCallbacks)
+		{
+			if (eventMarkTriggerInList(&psList, psContext, event, &trigger))
+			{
+				break;
+			}
+		}
 		eventMarkTriggerInList(&psAddedTriggers, psContext, event, &trigger);
 	}
 
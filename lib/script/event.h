@@ -26,6 +26,8 @@
 #ifndef _event_h
 #define _event_h
 
+#include <vector>
+
 #include "interpreter.h"
 
 /* The number of values in a context value chunk */
@@ -72,6 +74,7 @@ struct ACTIVE_TRIGGER
 	UWORD				event;
 	UWORD				offset;
 	int32_t				deactivated;	// Whether the trigger is marked for deletion
+	UDWORD				sequence;		// When it was added, to order timed triggers due at the same time
 	ACTIVE_TRIGGER         *psNext;
 };
 
@@ -114,11 +117,11 @@ enum SCR_USER_TYPES
 	ST_MAXTYPE,									// maximum possible type - should always be last
 };
 
-// The list of currently active triggers
-extern ACTIVE_TRIGGER	*psTrigList;
+// The currently active timed triggers, in the order they will fire
+extern std::vector<ACTIVE_TRIGGER *> eventGetTriggers();
 
-// The list of callback triggers
-extern ACTIVE_TRIGGER	*psCallbackList;
+// The callback triggers, in order of type and then in the order they will fire
+extern std::vector<ACTIVE_TRIGGER *> eventGetCallbackTriggers();
 
 // The currently allocated contexts
 extern SCRIPT_CONTEXT	*psContList;
@@ -26,24 +26,87 @@
 
 /* Control the execution trace printf's */
 #include "lib/framework/frame.h"
+#include "lib/framework/frameresource.h"
 #include "interpreter.h"
 #include "stack.h"
 #include "codeprint.h"
 #include "script.h"
 #include "event.h" //needed for eventGetEventID()
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <tuple>
+
 
 // the maximum number of instructions to execute before assuming
 // an infinite loop
 #define INTERP_MAXINSTRUCTIONS		300000
 #define MAX_FUNC_CALLS 300
 
+/* The operations of decoded code, in the order of the labels in interpRun */
+enum INTERP_OPERATION
+{
+	IOP_PUSH,
+	IOP_PUSHREF,
+	IOP_POP,
+	IOP_PUSHGLOBAL,
+	IOP_POPGLOBAL,
+	IOP_PUSHARRAYGLOBAL,
+	IOP_POPARRAYGLOBAL,
+	IOP_CALL,
+	IOP_VARCALL,
+	IOP_JUMP,			// also OP_EXIT, as a jump to the IOP_END
+	IOP_JUMPFALSE,
+	IOP_BINARYOP,
+	IOP_UNARYOP,
+	IOP_PAUSE,
+	IOP_FUNC,
+	IOP_POPLOCAL,
+	IOP_PUSHLOCAL,
+	IOP_PUSHLOCALREF,
+	IOP_TO_FLOAT,
+	IOP_TO_INT,
+	IOP_END,			// end of the code of a trigger or event
+	IOP_INVALID,		// anything which can't be run, including the values following an opcode
+
+	IOP_COUNT
+};
+
+/* An instruction decoded by interpPrepare, with its operand checked and looked up */
+struct INTERP_OP
+{
+	UBYTE			op;			// INTERP_OPERATION
+	UDWORD			data;		// variable index, jump target in the decoded code, pause time or operator
+	union
+	{
+		INTERP_VAL		*psVal;		// IOP_PUSH: the value to push
+		INTERP_TYPE		type;		// IOP_PUSHREF, IOP_PUSHLOCALREF: the type of the variable
+		SCRIPT_FUNC		pFunc;		// IOP_CALL
+		SCRIPT_VARFUNC	pVarFunc;	// IOP_VARCALL
+		ARRAY_DATA		*psArray;	// IOP_PUSHARRAYGLOBAL, IOP_POPARRAYGLOBAL
+		const char		*pError;	// IOP_INVALID: why it can't be run
+	} v;
+};
+
+/* The decoded code of a script. The code of each trigger and event is laid out as in the
+ * compiled code, so offsets within it are the same, and is followed by an IOP_END.
+ */
+struct INTERP_PROG
+{
+	std::vector<INTERP_OP>		ops;
+	std::vector<UDWORD>			triggerOps;		// index in ops of the code of each trigger
+	std::vector<UDWORD>			eventOps;		// index in ops of the code of each event
+	std::vector<std::string>	triggerNames;	// names for last_called_script_event
+	std::vector<std::string>	eventNames;
+};
+
 static INTERP_VAL	*varEnvironment[MAX_FUNC_CALLS];		//environments for local variables of events/functions
 
 struct ReturnAddressStack_t
 {
 	UDWORD CallerIndex;
-	INTERP_VAL *ReturnAddress;
+	const INTERP_OP *ReturnAddress;
 };
 
 /**
@@ -72,7 +135,7 @@ static inline bool retStackIsFull(void);
  * \param ReturnAddress Address to return to
  * \return False on failure (stack full)
  */
-static bool retStackPush(UDWORD CallerIndex, INTERP_VAL *ReturnAddress);
+static bool retStackPush(UDWORD CallerIndex, const INTERP_OP *ReturnAddress);
 
 /**
  * Pop an address/event pair from the return address stack
@@ -81,7 +144,7 @@ static bool retStackPush(UDWORD CallerIndex, INTERP_VAL *ReturnAddress);
  * \param ReturnAddress Address to return to
  * \return False on failure (stack empty)
  */
-static bool retStackPop(UDWORD *CallerIndex, INTERP_VAL **ReturnAddress);
+static bool retStackPop(UDWORD *CallerIndex, const INTERP_OP **ReturnAddress);
 
 /* Creates a new local var environment for a new function call */
 static inline void createVarEnvironment(SCRIPT_CONTEXT *psContext, UDWORD eventIndex);
@@ -159,28 +222,38 @@ static bool	interpTrace = false;
 static SCRIPT_CODE *psCurProg = nullptr;
 static bool bCurCallerIsEvent = false;
 
+/* The time taken by each event and trigger of each script, by script, run type and index */
+static std::map<std::tuple<SCRIPT_CODE *, INTERP_RUNTYPE, UDWORD>, INTERP_PROFILE> interpProfile;
+
 /* Print out trace info if tracing is turned on */
 #define TRCPRINTF(...) do { if (interpTrace) { fprintf( stderr, __VA_ARGS__ ); } } while (false)
 
-#define TRCPRINTVAL(x) \
-	if (interpTrace) \
-		cpPrintVal(x)
-
-#define TRCPRINTOPCODE(x) \
-	if (interpTrace) \
-		debug( LOG_NEVER, "%s", scriptOpcodeToString((OPCODE)x) )
-
-#define TRCPRINTSTACKTOP() \
-	if (interpTrace) \
-		stackPrintTop()
+/* With GCC and clang, each operation jumps straight to the code for the next through a table of
+ * label addresses, and tracing swaps in a table which goes through op_trace first. Elsewhere
+ * every operation goes back to a switch, which checks for tracing.
+ */
+#if defined(__GNUC__)
+#define INTERP_THREADED
+#endif
 
-#define TRCPRINTFUNC(x) \
-	if (interpTrace) \
-		debug( LOG_NEVER, "%s", scriptFunctionToString(x) )
+#ifdef INTERP_THREADED
+#define INTERP_DISPATCH()		goto *pDispatch[pOp->op]
+#define INTERP_CHECK_TRACE()	pDispatch = interpTrace ? aTraceLabels : aOpLabels
+#else
+#define INTERP_DISPATCH()		goto dispatch
+#define INTERP_CHECK_TRACE()	do {} while (false)
+#endif
 
-#define TRCPRINTVARFUNC(x, data) \
-	if (interpTrace) \
-		cpPrintVarFunc(x, data)
+/* Count an instruction, and give up if there have been too many */
+#define INTERP_COUNT() \
+	do \
+	{ \
+		if (instructionCount++ > INTERP_MAXINSTRUCTIONS) \
+		{ \
+			debug(LOG_ERROR, "interpRunScript: max instruction count exceeded - infinite loop ?"); \
+			goto exit_with_error; \
+		} \
+	} while (false)
 
 
 // true if the interpreter is currently running
@@ -204,67 +277,35 @@ static inline INTERP_VAL *interpGetVarData(VAL_CHUNK *psGlobals, UDWORD index)
 	return psChunk->asVals + index;
 }
 
-// get the array data for an array operation
-static bool interpGetArrayVarData(INTERP_VAL **pip, VAL_CHUNK *psGlobals, SCRIPT_CODE *psProg, INTERP_VAL **ppsVal)
+// get the array element for an array operation, popping its indexes from the stack
+static bool interpGetArrayVarData(const ARRAY_DATA *psArray, VAL_CHUNK *psGlobals, SCRIPT_CODE *psProg, INTERP_VAL **ppsVal)
 {
-	SDWORD		i, dimensions, vals[VAR_MAX_DIMENSIONS];
-	UBYTE		*elements;
-	SDWORD		size, val;
-	INTERP_VAL	*InstrPointer = *pip;
-	UDWORD		base, index;
-
-	// get the base index of the array
-	base = InstrPointer->v.ival & ARRAY_BASE_MASK;
-
-	// get the number of dimensions
-	dimensions = (InstrPointer->v.ival & ARRAY_DIMENSION_MASK) >> ARRAY_DIMENSION_SHIFT;
-
-	ASSERT_OR_RETURN(false, base < psProg->numArrays, "Arrray base index out of range (%d should be less than %d)", base, psProg->numArrays);
-	ASSERT_OR_RETURN(false, dimensions == psProg->psArrayInfo[base].dimensions, "Array dimensions do not match (%d vs %d)", dimensions, psProg->psArrayInfo[base].dimensions);
-
-	// get the number of elements for each dimension
-	elements = psProg->psArrayInfo[base].elements;
+	SDWORD		i, val;
+	UDWORD		size = 1, index = 0;
 
 	// calculate the index of the array element
-	size = 1;
-	index = 0;
-	for (i = dimensions - 1; i >= 0; i -= 1)
+	for (i = psArray->dimensions - 1; i >= 0; i -= 1)
 	{
 		if (!stackPopParams(1, VAL_INT, &val))
 		{
 			return false;
 		}
 
-		if ((val < 0) || (val >= elements[i]))
+		if ((val < 0) || (val >= psArray->elements[i]))
 		{
-			debug(LOG_ERROR, "interpGetArrayVarData: Array index for dimension %d out of range (passed index = %d, max index = %d)", i , val, elements[i]);
+			debug(LOG_ERROR, "interpGetArrayVarData: Array index for dimension %d out of range (passed index = %d, max index = %d)", i , val, psArray->elements[i]);
 			return false;
 		}
 
 		index += val * size;
-		size *= psProg->psArrayInfo[base].elements[i];
-		vals[i] = val;
-	}
-
-	// print out the debug trace
-	if (interpTrace)
-	{
-		debug(LOG_NEVER, "%d->", base);
-		for (i = 0; i < dimensions; i += 1)
-		{
-			debug(LOG_NEVER, "[%d/%d]", vals[i], elements[i]);
-		}
-		debug(LOG_NEVER, "(%d) ", index);
+		size *= psArray->elements[i];
 	}
 
 	// check the index is valid
 	ASSERT_OR_RETURN(false, index <= psProg->arraySize, "Array indexes out of variable space (%d)", index);
 
 	// get the variable data
-	*ppsVal = interpGetVarData(psGlobals, psProg->psArrayInfo[base].base + index);
-
-	// update the instruction pointer
-	*pip += 1;
+	*ppsVal = interpGetVarData(psGlobals, psArray->base + index);
 
 	return true;
 }
@@ -278,32 +319,368 @@ bool interpInitialise(void)
 	return true;
 }
 
-/* Run a compiled script */
-bool interpRunScript(SCRIPT_CONTEXT *psContext, INTERP_RUNTYPE runType, UDWORD index, UDWORD offset)
+/* The label of the code starting at the given offset, or nullptr if there is no debug info for it */
+static const char *interpGetLabel(SCRIPT_CODE *psProg, UDWORD offset)
 {
-	UDWORD			data;
-	OPCODE			opcode;
-	INTERP_VAL		sVal, *psVar, *InstrPointer;
-	VAL_CHUNK		*psGlobals;
-	UDWORD			numGlobals = 0;
-	INTERP_VAL		*pCodeStart, *pCodeEnd, *pCodeBase;
-	SCRIPT_FUNC		scriptFunc = nullptr;
-	SCRIPT_VARFUNC	scriptVarFunc = nullptr;
-	SCRIPT_CODE		*psProg;
-	SDWORD			instructionCount = 0;
+	for (UDWORD i = 0; psProg->psDebug != nullptr && i < psProg->debugEntries; i++)
+	{
+		if (psProg->psDebug[i].offset == offset)
+		{
+			return psProg->psDebug[i].pLabel;
+		}
+	}
+
+	return nullptr;
+}
+
+/* A decoded instruction which stops the script with the given error if it is run */
+static INTERP_OP interpInvalidOp(const char *pError)
+{
+	INTERP_OP	op;
+
+	op.op = IOP_INVALID;
+	op.data = 0;
+	op.v.pError = pError;
+
+	return op;
+}
+
+/* Decode the compiled code from start to end onto the end of the decoded code.
+ * event is the index of the event the code belongs to, or -1 for trigger code.
+ */
+static void interpDecodeRange(SCRIPT_CODE *psProg, INTERP_PROG *psDecoded, UDWORD start, UDWORD end, SDWORD event)
+{
+	UDWORD		base = psDecoded->ops.size();
+	UDWORD		i, data, target;
+	OPCODE		opcode;
+	INTERP_VAL	*ip;
+
+	// Anything which isn't the start of an instruction stays invalid, so that jumping into one fails
+	psDecoded->ops.resize(base + end - start + 1, interpInvalidOp("not the start of an instruction"));
+	psDecoded->ops[base + end - start].op = IOP_END;
+
+	for (i = start; i < end; i += aOpSize[opcode])
+	{
+		INTERP_OP &op = psDecoded->ops[base + i - start];
+
+		ip = psProg->pCode + i;
+		opcode = (OPCODE)((UDWORD)ip->v.ival >> OPCODE_SHIFT);
+		data = ip->v.ival & OPCODE_DATAMASK;
+
+		ASSERT(ip->type == VAL_PKOPCODE || ip->type == VAL_OPCODE, "Expected an opcode at %u (type=%d)", i, ip->type);
 
-	UDWORD			CurEvent = 0;
-	bool			bStop = false, bEvent = false;
-	UDWORD			callDepth = 0;
-	bool			bTraceOn = false;		//enable to debug function/event calls
-	size_t			last_called_script_eventsz = sizeof(last_called_script_event);
+		if (opcode > OP_TO_INT || aOpSize[opcode] <= 0 || i + aOpSize[opcode] > end)
+		{
+			// No way to know where the next instruction starts, so the rest stays invalid
+			op = interpInvalidOp("unknown opcode");
+			return;
+		}
+
+		op.data = data;
+
+		switch (opcode)
+		{
+		case OP_PUSH:
+			ASSERT(interpCheckEquiv(ip[1].type, (INTERP_TYPE)data),
+			       "wrong value type passed for OP_PUSH: %d, expected: %d", ip[1].type, data);
+
+			op.op = IOP_PUSH;
+			op.v.psVal = ip + 1;
+			break;
+		case OP_PUSHREF:
+			op.op = IOP_PUSHREF;
+			op.data = ip[1].v.ival;
+			op.v.type = (INTERP_TYPE)data;
+
+			if (op.data >= psProg->numGlobals)
+			{
+				op = interpInvalidOp("variable index out of range");
+			}
+
+			break;
+		case OP_POP:
+			op.op = IOP_POP;
+			break;
+		case OP_PUSHGLOBAL:
+		case OP_POPGLOBAL:
+			op.op = opcode == OP_PUSHGLOBAL ? IOP_PUSHGLOBAL : IOP_POPGLOBAL;
+
+			if (data >= psProg->numGlobals)
+			{
+				op = interpInvalidOp("variable index out of range");
+			}
+
+			break;
+		case OP_PUSHARRAYGLOBAL:
+		case OP_POPARRAYGLOBAL:
+			op.op = opcode == OP_PUSHARRAYGLOBAL ? IOP_PUSHARRAYGLOBAL : IOP_POPARRAYGLOBAL;
+			op.data = data & ARRAY_BASE_MASK;
+
+			if (op.data >= psProg->numArrays || psProg->psArrayInfo[op.data].dimensions != (data & ARRAY_DIMENSION_MASK) >> ARRAY_DIMENSION_SHIFT)
+			{
+				op = interpInvalidOp("array base index or dimensions out of range");
+			}
+			else
+			{
+				op.v.psArray = psProg->psArrayInfo + op.data;
+			}
 
-	ASSERT(psContext != nullptr, "Invalid context pointer");
+			break;
+		case OP_CALL:
+			op.op = IOP_CALL;
+			op.v.pFunc = ip[1].v.pFuncExtern;
+			break;
+		case OP_VARCALL:
+			ASSERT(ip[1].type == VAL_OBJ_GETSET,
+			       "wrong set/get function pointer type passed for OP_VARCALL: %d", ip[1].type);
+
+			op.op = IOP_VARCALL;
+			op.v.pVarFunc = ip[1].v.pObjGetSet;
+			break;
+		case OP_JUMP:
+		case OP_JUMPFALSE:
+			target = i + (SWORD)data;
+
+			if (target < start || target > end)
+			{
+				op = interpInvalidOp("jump out of range");
+			}
+			else
+			{
+				op.op = opcode == OP_JUMP ? IOP_JUMP : IOP_JUMPFALSE;
+				op.data = base + target - start;
+			}
+
+			break;
+		case OP_EXIT:
+			op.op = IOP_JUMP;
+			op.data = base + end - start;
+			break;
+		case OP_PAUSE:
+			op.op = IOP_PAUSE;
+			break;
+		case OP_BINARYOP:
+			op.op = IOP_BINARYOP;
+			break;
+		case OP_UNARYOP:
+			op.op = IOP_UNARYOP;
+			break;
+		case OP_FUNC:
+			ASSERT(ip[1].type == VAL_EVENT, "wrong value type passed for OP_FUNC: %d", ip[1].type);
+
+			op.op = IOP_FUNC;
+			op.data = ip[1].v.ival;
+
+			if (op.data >= psProg->numEvents)
+			{
+				op = interpInvalidOp("function index out of range");
+			}
+
+			break;
+		case OP_PUSHLOCAL:
+		case OP_POPLOCAL:
+			op.op = opcode == OP_PUSHLOCAL ? IOP_PUSHLOCAL : IOP_POPLOCAL;
+
+			if (event < 0 || data >= psProg->numLocalVars[event])
+			{
+				op = interpInvalidOp("local variable index out of range");
+			}
+
+			break;
+		case OP_PUSHLOCALREF:
+			ASSERT(ip[1].type == VAL_INT, "wrong value type passed for OP_PUSHLOCALREF: %d", ip[1].type);
+
+			op.op = IOP_PUSHLOCALREF;
+			op.data = ip[1].v.ival;
+			op.v.type = (INTERP_TYPE)data;
+
+			if (event < 0 || op.data >= psProg->numLocalVars[event])
+			{
+				op = interpInvalidOp("local variable index out of range");
+			}
+
+			break;
+		case OP_TO_FLOAT:
+			op.op = IOP_TO_FLOAT;
+			break;
+		case OP_TO_INT:
+			op.op = IOP_TO_INT;
+			break;
+		default:
+			op = interpInvalidOp("unknown opcode");
+			break;
+		}
+	}
+}
+
+/* Decode a newly compiled script for the interpreter */
+bool interpPrepare(SCRIPT_CODE *psProg)
+{
+	UDWORD		codeSize = psProg->size / sizeof(INTERP_VAL);
+	UDWORD		i, start, end;
+	const char	*pLabel;
+
+	ASSERT_OR_RETURN(false, psProg->psDecoded == nullptr, "Script already decoded");
+
+	INTERP_PROG *psDecoded = new INTERP_PROG;
+	psDecoded->ops.reserve(codeSize + psProg->numTriggers + psProg->numEvents);
+
+	for (i = 0; i < psProg->numTriggers; i++)
+	{
+		start = psProg->pTriggerTab[i];
+		end = psProg->pTriggerTab[i + 1];
+
+		if (start > end || end > codeSize)
+		{
+			debug(LOG_ERROR, "Code of trigger %u out of range", i);
+			delete psDecoded;
+			return false;
+		}
+
+		psDecoded->triggerOps.push_back(psDecoded->ops.size());
+		interpDecodeRange(psProg, psDecoded, start, end, -1);
+		psDecoded->triggerNames.push_back(eventGetTriggerID(psProg, i));
+	}
+
+	for (i = 0; i < psProg->numEvents; i++)
+	{
+		start = psProg->pEventTab[i];
+		end = psProg->pEventTab[i + 1];
+
+		if (start > end || end > codeSize)
+		{
+			debug(LOG_ERROR, "Code of event %u out of range", i);
+			delete psDecoded;
+			return false;
+		}
+
+		psDecoded->eventOps.push_back(psDecoded->ops.size());
+		interpDecodeRange(psProg, psDecoded, start, end, i);
+		pLabel = interpGetLabel(psProg, start);
+		psDecoded->eventNames.push_back(pLabel != nullptr ? pLabel : "event " + std::to_string(i));
+	}
+
+	psProg->psDecoded = psDecoded;
+	return true;
+}
+
+/* Free the decoded code of a script */
+void interpRelease(SCRIPT_CODE *psProg)
+{
+	last_called_script_event = "<none>";  // May point into the names freed here
+	delete psProg->psDecoded;
+	psProg->psDecoded = nullptr;
+}
+
+/* Print the instruction at the given offset in the compiled code, when tracing */
+static void interpTraceOp(SCRIPT_CODE *psProg, UDWORD offset, const INTERP_OP *pOp)
+{
+	INTERP_VAL	*ip = psProg->pCode + offset;
+	OPCODE		opcode;
+	UDWORD		data;
+
+	if (pOp->op == IOP_END)
+	{
+		fprintf(stderr, "%-6u  END\n", offset);
+		return;
+	}
+
+	opcode = (OPCODE)((UDWORD)ip->v.ival >> OPCODE_SHIFT);
+	data = ip->v.ival & OPCODE_DATAMASK;
+	fprintf(stderr, "%-6u  %-12s", offset, pOp->op == IOP_INVALID ? "INVALID" : scriptOpcodeToString(opcode));
+
+	switch (pOp->op)
+	{
+	case IOP_PUSH:
+	case IOP_PUSHREF:
+		cpPrintPackedVal(ip);
+		break;
+	case IOP_PUSHGLOBAL:
+	case IOP_POPGLOBAL:
+	case IOP_PUSHLOCAL:
+	case IOP_POPLOCAL:
+	case IOP_PUSHLOCALREF:
+	case IOP_FUNC:
+	case IOP_PAUSE:
+		fprintf(stderr, "%u", pOp->data);
+		break;
+	case IOP_PUSHARRAYGLOBAL:
+	case IOP_POPARRAYGLOBAL:
+		fprintf(stderr, "%u[%u]", pOp->data, (UDWORD)pOp->v.psArray->dimensions);
+		break;
+	case IOP_CALL:
+		fprintf(stderr, "%s", scriptFunctionToString(pOp->v.pFunc));
+		break;
+	case IOP_VARCALL:
+		cpPrintVarFunc(pOp->v.pVarFunc, data);
+		fprintf(stderr, "(%u)", data);
+		break;
+	case IOP_JUMP:
+	case IOP_JUMPFALSE:
+		if (opcode != OP_EXIT)
+		{
+			fprintf(stderr, "%d (%d)", (SWORD)data, (int)(offset + (SWORD)data));
+		}
+
+		break;
+	case IOP_BINARYOP:
+	case IOP_UNARYOP:
+		fprintf(stderr, "%s", scriptOpcodeToString((OPCODE)data));
+		break;
+	case IOP_INVALID:
+		fprintf(stderr, "%s", pOp->v.pError);
+		break;
+	default:
+		break;
+	}
+
+	fprintf(stderr, "\n");
+}
+
+#ifdef INTERP_THREADED
+// Label addresses and computed gotos are GNU extensions
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+/* Run the decoded code of a script, counting the instructions run */
+static bool interpRun(SCRIPT_CONTEXT *psContext, INTERP_RUNTYPE runType, UDWORD index, UDWORD offset, SDWORD &instructionCount)
+{
+	SCRIPT_CODE		*psProg;
+	INTERP_PROG		*psDecoded;
+	const INTERP_OP	*pOps, *pOpBase = nullptr, *pOp = nullptr;
+	INTERP_VAL		sVal, *psVar, *psLocals;
+	VAL_CHUNK		*psGlobals;
+	UDWORD			CurEvent = index, codeBase = 0;
+	bool			bEvent = false;
+#ifdef INTERP_THREADED
+	// In the order of INTERP_OPERATION
+	static void *const aOpLabels[] =
+	{
+		&&op_push, &&op_pushref, &&op_pop, &&op_pushglobal, &&op_popglobal, &&op_pusharrayglobal, &&op_poparrayglobal,
+		&&op_call, &&op_varcall, &&op_jump, &&op_jumpfalse, &&op_binaryop, &&op_unaryop, &&op_pause, &&op_func,
+		&&op_poplocal, &&op_pushlocal, &&op_pushlocalref, &&op_to_float, &&op_to_int, &&op_end, &&op_invalid
+	};
+	static void *const aTraceLabels[] =
+	{
+		&&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace,
+		&&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace,
+		&&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace, &&op_trace
+	};
+	static_assert(sizeof(aOpLabels) / sizeof(aOpLabels[0]) == IOP_COUNT, "aOpLabels doesn't match INTERP_OPERATION");
+	static_assert(sizeof(aTraceLabels) / sizeof(aTraceLabels[0]) == IOP_COUNT, "aTraceLabels doesn't match INTERP_OPERATION");
+	void *const		*pDispatch = aOpLabels;
+#endif
+
+	ASSERT_OR_RETURN(false, psContext != nullptr, "Invalid context pointer");
 
 	psProg = psContext->psCode;
 	psCurProg = psProg;		//remember for future use
 
-	ASSERT(psProg != nullptr, "Invalid script code pointer");
+	ASSERT_OR_RETURN(false, psProg != nullptr && psProg->psDecoded != nullptr, "Invalid script code pointer");
+
+	psDecoded = psProg->psDecoded;
+	pOps = psDecoded->ops.data();
 
 	if (bInterpRunning)
 	{
@@ -312,6 +689,36 @@ bool interpRunScript(SCRIPT_CONTEXT *psContext, INTERP_RUNTYPE runType, UDWORD i
 		goto exit_with_error;
 	}
 
+	// Find the code to run
+	switch (runType)
+	{
+	case IRT_TRIGGER:
+		ASSERT_OR_RETURN(false, index < psProg->numTriggers, "Trigger index out of range");
+
+		pOpBase = pOps + psDecoded->triggerOps[index];
+		codeBase = psProg->pTriggerTab[index];
+		pOp = pOpBase;
+
+		bCurCallerIsEvent = false;
+		last_called_script_event = psDecoded->triggerNames[index].c_str();
+		break;
+	case IRT_EVENT:
+		ASSERT_OR_RETURN(false, index < psProg->numEvents, "Event index out of range");
+		ASSERT_OR_RETURN(false, offset <= (UDWORD)(psProg->pEventTab[index + 1] - psProg->pEventTab[index]), "Event offset out of range");
+
+		pOpBase = pOps + psDecoded->eventOps[index];
+		codeBase = psProg->pEventTab[index];
+		pOp = pOpBase + offset;		//offset only used for pause() script function
+
+		bEvent = true; //remember it's an event
+		bCurCallerIsEvent = true;
+		last_called_script_event = psDecoded->eventNames[index].c_str();
+		break;
+	default:
+		ASSERT(false, "Unknown run type");
+		return false;
+	}
+
 	// note that the interpreter is running to stop recursive script calls
 	bInterpRunning = true;
 
@@ -325,588 +732,400 @@ bool interpRunScript(SCRIPT_CONTEXT *psContext, INTERP_RUNTYPE runType, UDWORD i
 	interpTrace = false;
 
 	/* Get the global variables */
-	numGlobals = psProg->numGlobals;
 	psGlobals = psContext->psGlobals;
 
-	bEvent = false;
+	instructionCount = 0;
 
-	// Find the code range
-	switch (runType)
+	// create new variable environment for this call
+	if (bEvent)
 	{
-	case IRT_TRIGGER:
-		if (index > psProg->numTriggers)
-		{
-			ASSERT(false, "Trigger index out of range");
-			return false;
-		}
-		pCodeBase = psProg->pCode + psProg->pTriggerTab[index];
-		pCodeStart = pCodeBase;
-		pCodeEnd  = psProg->pCode + psProg->pTriggerTab[index + 1];
+		createVarEnvironment(psContext, CurEvent);
+	}
 
-		bCurCallerIsEvent = false;
+	psLocals = varEnvironment[retStackCallDepth()];
 
-		// find the debug info for the trigger
-		strncpy(last_called_script_event, eventGetTriggerID(psProg, index), last_called_script_eventsz - 1);
-		last_called_script_event[last_called_script_eventsz - 1] = 0;
+	INTERP_DISPATCH();
 
-		if (bTraceOn)
-		{
-			debug(LOG_SCRIPT, "Trigger: %s", last_called_script_event);
-		}
+#ifdef INTERP_THREADED
+op_trace:
+	interpTraceOp(psProg, codeBase + (pOp - pOpBase), pOp);
+	goto *aOpLabels[pOp->op];
+#else
+dispatch:
+	if (interpTrace)
+	{
+		interpTraceOp(psProg, codeBase + (pOp - pOpBase), pOp);
+	}
 
-		break;
-	case IRT_EVENT:
-		if (index > psProg->numEvents)
-		{
-			ASSERT(false, "Trigger index out of range");
-			return false;
-		}
-		pCodeBase = psProg->pCode + psProg->pEventTab[index];
-		pCodeStart = pCodeBase + offset;		//offset only used for pause() script function
-		pCodeEnd  = psProg->pCode + psProg->pEventTab[index + 1];
+	switch (pOp->op)
+	{
+	case IOP_PUSH:
+		goto op_push;
+	case IOP_PUSHREF:
+		goto op_pushref;
+	case IOP_POP:
+		goto op_pop;
+	case IOP_PUSHGLOBAL:
+		goto op_pushglobal;
+	case IOP_POPGLOBAL:
+		goto op_popglobal;
+	case IOP_PUSHARRAYGLOBAL:
+		goto op_pusharrayglobal;
+	case IOP_POPARRAYGLOBAL:
+		goto op_poparrayglobal;
+	case IOP_CALL:
+		goto op_call;
+	case IOP_VARCALL:
+		goto op_varcall;
+	case IOP_JUMP:
+		goto op_jump;
+	case IOP_JUMPFALSE:
+		goto op_jumpfalse;
+	case IOP_BINARYOP:
+		goto op_binaryop;
+	case IOP_UNARYOP:
+		goto op_unaryop;
+	case IOP_PAUSE:
+		goto op_pause;
+	case IOP_FUNC:
+		goto op_func;
+	case IOP_POPLOCAL:
+		goto op_poplocal;
+	case IOP_PUSHLOCAL:
+		goto op_pushlocal;
+	case IOP_PUSHLOCALREF:
+		goto op_pushlocalref;
+	case IOP_TO_FLOAT:
+		goto op_to_float;
+	case IOP_TO_INT:
+		goto op_to_int;
+	case IOP_END:
+		goto op_end;
+	default:
+		goto op_invalid;
+	}
+#endif
 
-		bEvent = true; //remember it's an event
-		bCurCallerIsEvent = true;
+op_push:
+	INTERP_COUNT();
 
-		// remember last called event/function
-		strncpy(last_called_script_event, eventGetEventID(psProg, index), last_called_script_eventsz - 1);
-		last_called_script_event[last_called_script_eventsz - 1] = 0;
+	if (!stackPush(pOp->v.psVal))
+	{
+		// Eeerk, out of memory
+		debug(LOG_ERROR, "interpRunScript: out of memory!");
+		goto exit_with_error;
+	}
 
-		if (bTraceOn)
-		{
-			debug(LOG_SCRIPT, "Original event name: %s", last_called_script_event);
-		}
+	pOp += 2;
+	INTERP_DISPATCH();
 
-		break;
-	default:
-		ASSERT(false, "Unknown run type");
-		return false;
+op_pushref:
+	INTERP_COUNT();
+
+	// store pointer to INTERP_VAL
+	sVal.type = pOp->v.type;
+	sVal.v.oval = interpGetVarData(psGlobals, pOp->data);
+
+	if (!stackPush(&sVal))
+	{
+		// Eeerk, out of memory
+		debug(LOG_ERROR, "interpRunScript: out of memory!");
+		goto exit_with_error;
 	}
 
-	// Get the first opcode
-	InstrPointer = pCodeStart;
+	pOp += 2;
+	INTERP_DISPATCH();
 
-	/* Make sure we start with an opcode */
-	ASSERT(InstrPointer->type == VAL_PKOPCODE || InstrPointer->type == VAL_OPCODE,
-	       "Expected an opcode at the beginning of the interpreting process (type=%d)", InstrPointer->type);
+op_pop:
+	INTERP_COUNT();
 
-	//opcode = InstrPointer->v.ival >> OPCODE_SHIFT;
+	if (!stackPop(&sVal))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do stack pop");
+		goto exit_with_error;
+	}
 
-	instructionCount = 0;
+	pOp += 1;
+	INTERP_DISPATCH();
 
-	CurEvent = index;
-	bStop = false;
+op_pushglobal:
+	INTERP_COUNT();
 
-	// create new variable environment for this call
-	if (bEvent)
+	if (!stackPush(interpGetVarData(psGlobals, pOp->data)))
 	{
-		createVarEnvironment(psContext, CurEvent);
+		debug(LOG_ERROR, "interpRunScript: could not do stack push");
+		goto exit_with_error;
 	}
 
-	while (!bStop)
+	pOp += 1;
+	INTERP_DISPATCH();
+
+op_popglobal:
+	INTERP_COUNT();
+
+	if (!stackPopType(interpGetVarData(psGlobals, pOp->data)))
 	{
-		// Run the code
-		if (InstrPointer < pCodeEnd)// && opcode != OP_EXIT)
-		{
-			if (instructionCount > INTERP_MAXINSTRUCTIONS)
-			{
-				debug(LOG_ERROR, "interpRunScript: max instruction count exceeded - infinite loop ?");
-				goto exit_with_error;
-			}
-			instructionCount++;
+		debug(LOG_ERROR, "interpRunScript: could not do stack pop");
+		goto exit_with_error;
+	}
 
-			TRCPRINTF("%-6d  ", (int)(InstrPointer - psProg->pCode));
-			opcode = (OPCODE)(InstrPointer->v.ival >> OPCODE_SHIFT);			//get opcode
-			data = (SDWORD)(InstrPointer->v.ival & OPCODE_DATAMASK);		//get data - only used with packed opcodes
-			switch (opcode)
-			{
-			/* Custom function call */
-			case OP_FUNC:
-				//debug( LOG_SCRIPT, "-OP_FUNC" );
-				//debug( LOG_SCRIPT, "OP_FUNC: remember event %d, ip=%d", CurEvent, (ip + 2) );
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				if (!retStackPush(CurEvent, (InstrPointer + aOpSize[opcode]))) //Remember where to jump back later
-				{
-					debug(LOG_ERROR, "interpRunScript() - retStackPush() failed.");
-					return false;
-				}
+op_pusharrayglobal:
+	INTERP_COUNT();
 
-				ASSERT(((INTERP_VAL *)(InstrPointer + 1))->type == VAL_EVENT, "wrong value type passed for OP_FUNC: %d", ((INTERP_VAL *)(InstrPointer + 1))->type);
+	if (!interpGetArrayVarData(pOp->v.psArray, psGlobals, psProg, &psVar))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not get array var data, CurEvent=%d", CurEvent);
+		goto exit_with_error;
+	}
 
-				// get index of the new event
-				CurEvent = ((INTERP_VAL *)(InstrPointer + 1))->v.ival; //Current event = event to jump to
+	if (!stackPush(psVar))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do stack push");
+		goto exit_with_error;
+	}
 
-				if (CurEvent > psProg->numEvents)
-				{
-					debug(LOG_ERROR, "interpRunScript: trigger index out of range");
-					goto exit_with_error;
-				}
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				// create new variable environment for this call
-				createVarEnvironment(psContext, CurEvent);
+op_poparrayglobal:
+	INTERP_COUNT();
 
-				//Set new code execution boundaries
-				//----------------------------------
-				pCodeBase = psProg->pCode + psProg->pEventTab[CurEvent];
-				pCodeStart = pCodeBase;
-				pCodeEnd  = psProg->pCode + psProg->pEventTab[CurEvent + 1];
+	if (!interpGetArrayVarData(pOp->v.psArray, psGlobals, psProg, &psVar))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not get array var data");
+		goto exit_with_error;
+	}
 
-				InstrPointer = pCodeStart;				//Start at the beginning of the new event
+	if (!stackPopType(psVar))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do pop stack of type");
+		goto exit_with_error;
+	}
 
-				//remember last called event/index
-				strcpy(last_called_script_event, eventGetEventID(psProg, CurEvent));
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				if (bTraceOn)
-				{
-					debug(LOG_SCRIPT, "Called: '%s'", last_called_script_event);
-				}
+op_call:
+	INTERP_COUNT();
 
-				//debug( LOG_SCRIPT, "-OP_FUNC: jumped to event %d; ip=%d, numLocalVars: %d", CurEvent, ip, psContext->psCode->numLocalVars[CurEvent] );
-				//debug( LOG_SCRIPT, "-END OP_FUNC" );
+	if (!pOp->v.pFunc())
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do func");
+		goto exit_with_error;
+	}
 
-				break;
+	pOp += 2;
+	INTERP_CHECK_TRACE();	// tracing is switched on and off by script functions
+	INTERP_DISPATCH();
 
-			//handle local variables
-			case OP_PUSHLOCAL:
+op_varcall:
+	INTERP_COUNT();
 
-				//debug( LOG_SCRIPT, "OP_PUSHLOCAL");
-				//debug( LOG_SCRIPT, "OP_PUSHLOCAL, (CurEvent=%d, data =%d) num loc vars: %d; pushing: %d", CurEvent, data, psContext->psCode->numLocalVars[CurEvent], psContext->psCode->ppsLocalVarVal[CurEvent][data].v.ival);
+	if (!pOp->v.pVarFunc(pOp->data))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do var func");
+		goto exit_with_error;
+	}
 
-				if (data >= psContext->psCode->numLocalVars[CurEvent])
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_PUSHLOCAL: variable index out of range");
-					goto exit_with_error;
-				}
+	pOp += 2;
+	INTERP_DISPATCH();
 
-				//debug(LOG_SCRIPT, "OP_PUSHLOCAL type: %d", psContext->psCode->ppsLocalVarVal[CurEvent][data].type);
+op_jump:
+	INTERP_COUNT();
 
-				if (!stackPush(&(varEnvironment[retStackCallDepth()][data])))
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_PUSHLOCAL: push failed");
-					goto exit_with_error;
-				}
+	pOp = pOps + pOp->data;
+	INTERP_DISPATCH();
 
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_POPLOCAL:
+op_jumpfalse:
+	INTERP_COUNT();
 
-				//debug( LOG_SCRIPT, "OP_POPLOCAL, event index: '%d', data: '%d'", CurEvent, data);
-				//debug( LOG_SCRIPT, "OP_POPLOCAL, numLocalVars: '%d'", psContext->psCode->numLocalVars[CurEvent]);
+	if (!stackPop(&sVal))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do pop of stack");
+		goto exit_with_error;
+	}
 
-				if (data >= psContext->psCode->numLocalVars[CurEvent])
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_POPLOCAL: variable index out of range");
-					goto exit_with_error;
-				}
+	pOp = sVal.v.bval ? pOp + 1 : pOps + pOp->data;
+	INTERP_DISPATCH();
 
-				//DbgMsg("OP_POPLOCAL type: %d, CurEvent=%d, data=%d", psContext->psCode->ppsLocalVarVal[CurEvent][data].type, CurEvent, data);
+op_binaryop:
+	INTERP_COUNT();
 
-				if (!stackPopType(&(varEnvironment[retStackCallDepth()][data])))
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_POPLOCAL: pop failed");
-					goto exit_with_error;
-				}
+	if (!stackBinaryOp((OPCODE)pOp->data))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do binary op");
+		goto exit_with_error;
+	}
 
-				//debug(LOG_SCRIPT, "OP_POPLOCAL: type=%d, val=%d", psContext->psCode->ppsLocalVarVal[CurEvent][data].type, psContext->psCode->ppsLocalVarVal[CurEvent][data].v.ival);
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				InstrPointer += aOpSize[opcode];
+op_unaryop:
+	INTERP_COUNT();
 
-				break;
+	if (!stackUnaryOp((OPCODE)pOp->data))
+	{
+		debug(LOG_ERROR, "interpRunScript: could not do unary op");
+		goto exit_with_error;
+	}
 
-			case OP_PUSHLOCALREF:
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				// The type of the variable is stored in with the opcode
-				sVal.type = (INTERP_TYPE)(InstrPointer->v.ival & OPCODE_DATAMASK);
+op_pause:
+	INTERP_COUNT();
 
-				ASSERT(((INTERP_VAL *)(InstrPointer + 1))->type == VAL_INT,
-				       "wrong value type passed for OP_PUSHLOCALREF: %d", ((INTERP_VAL *)(InstrPointer + 1))->type);
+	ASSERT(stackEmpty(), "interpRunScript: OP_PAUSE without empty stack");
 
-				/* get local var index */
-				data = ((INTERP_VAL *)(InstrPointer + 1))->v.ival;
+	// tell the event system to reschedule this event
+	if (!eventAddPauseTrigger(psContext, index, (UDWORD)(pOp + 1 - pOpBase), pOp->data))	//only original caller can be paused since we pass index and not CurEvent (not sure if that's what we want)
+	{
+		debug(LOG_ERROR, "interpRunScript: could not add pause trigger");
+		goto exit_with_error;
+	}
 
-				if (data >= psContext->psCode->numLocalVars[CurEvent])
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_PUSHLOCALREF: variable index out of range");
-					goto exit_with_error;
-				}
+	// now jump out of the event
+	goto op_end;
 
-				/* get local variable */
-				sVal.v.oval = &(varEnvironment[retStackCallDepth()][data]);
+op_func:	/* Custom function call */
+	INTERP_COUNT();
 
-				TRCPRINTOPCODE(opcode);
-				TRCPRINTVAL(sVal);
-				TRCPRINTF("\n");
+	if (!retStackPush(CurEvent, pOp + 2)) //Remember where to jump back later
+	{
+		debug(LOG_ERROR, "interpRunScript() - retStackPush() failed.");
+		goto exit_with_error;
+	}
 
-				if (!stackPush(&sVal))
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_PUSHLOCALREF: push failed");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
+	// get index of the new event
+	CurEvent = pOp->data;
 
-			case OP_PUSH:
-				// The type of the value is stored in with the opcode
-				sVal.type = (INTERP_TYPE)(InstrPointer->v.ival & OPCODE_DATAMASK);
+	// create new variable environment for this call
+	createVarEnvironment(psContext, CurEvent);
+	psLocals = varEnvironment[retStackCallDepth()];
 
-				//ASSERT( ((INTERP_VAL *)(InstrPointer + 1))->type  == sVal.type,
-				//	"wrong value type passed for OP_PUSH: %d, expected: %d", ((INTERP_VAL *)(InstrPointer + 1))->type, sVal.type );
+	//Start at the beginning of the new event
+	pOpBase = pOps + psDecoded->eventOps[CurEvent];
+	codeBase = psProg->pEventTab[CurEvent];
+	pOp = pOpBase;
 
-				ASSERT(interpCheckEquiv(((INTERP_VAL *)(InstrPointer + 1))->type, sVal.type),
-				       "wrong value type passed for OP_PUSH: %d, expected: %d", ((INTERP_VAL *)(InstrPointer + 1))->type, sVal.type);
+	//remember last called event/index
+	last_called_script_event = psDecoded->eventNames[CurEvent].c_str();
+	INTERP_DISPATCH();
 
-				/* copy value */
-				memcpy(&sVal, (INTERP_VAL *)(InstrPointer + 1), sizeof(INTERP_VAL));
+op_pushlocal:
+	INTERP_COUNT();
 
-				TRCPRINTOPCODE(opcode);
-				TRCPRINTVAL(sVal);
-				TRCPRINTF("\n");
-				if (!stackPush(&sVal))
-				{
-					// Eeerk, out of memory
-					debug(LOG_ERROR, "interpRunScript: out of memory!");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_PUSHREF:
-				// The type of the variable is stored in with the opcode
-				sVal.type = (INTERP_TYPE)(InstrPointer->v.ival & OPCODE_DATAMASK);
-
-				// store pointer to INTERP_VAL
-				sVal.v.oval = interpGetVarData(psGlobals, ((INTERP_VAL *)(InstrPointer + 1))->v.ival);
-
-				TRCPRINTOPCODE(opcode);
-				TRCPRINTVAL(sVal);
-				TRCPRINTF("\n");
-				if (!stackPush(&sVal))
-				{
-					// Eeerk, out of memory
-					debug(LOG_ERROR, "interpRunScript: out of memory!");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_POP:
-				ASSERT(InstrPointer->type == VAL_OPCODE,
-				       "wrong value type passed for OP_POP: %d", InstrPointer->type);
-
-				TRCPRINTOPCODE(opcode);
-				if (!stackPop(&sVal))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do stack pop");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_BINARYOP:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_BINARYOP: %d", InstrPointer->type);
-
-				TRCPRINTOPCODE(data);
-				if (!stackBinaryOp((OPCODE)data))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do binary op");
-					goto exit_with_error;
-				}
-				TRCPRINTSTACKTOP();
-				TRCPRINTF("\n");
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_UNARYOP:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_UNARYOP: %d", InstrPointer->type);
-
-				TRCPRINTOPCODE(data);
-				if (!stackUnaryOp((OPCODE)data))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do unary op");
-					goto exit_with_error;
-				}
-				TRCPRINTSTACKTOP();
-				TRCPRINTF("\n");
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_PUSHGLOBAL:
+	if (!stackPush(&psLocals[pOp->data]))
+	{
+		debug(LOG_ERROR, "interpRunScript: OP_PUSHLOCAL: push failed");
+		goto exit_with_error;
+	}
 
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_PUSHGLOBAL: %d", InstrPointer->type);
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				TRCPRINTF("PUSHGLOBAL  %d\n", data);
-				if (data >= numGlobals)
-				{
-					debug(LOG_ERROR, "interpRunScript: variable index out of range");
-					goto exit_with_error;
-				}
-				if (!stackPush(interpGetVarData(psGlobals, data)))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do stack push");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_POPGLOBAL:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_POPGLOBAL: %d", InstrPointer->type);
-
-				TRCPRINTF("POPGLOBAL   %d ", data);
-				TRCPRINTSTACKTOP();
-				TRCPRINTF("\n");
-				if (data >= numGlobals)
-				{
-					debug(LOG_ERROR, "interpRunScript: variable index out of range");
-					goto exit_with_error;
-				}
-				if (!stackPopType(interpGetVarData(psGlobals, data)))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do stack pop");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_PUSHARRAYGLOBAL:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_PUSHARRAYGLOBAL: %d", InstrPointer->type);
-
-				TRCPRINTOPCODE(opcode);
-				if (!interpGetArrayVarData(&InstrPointer, psGlobals, psProg, &psVar))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not get array var data, CurEvent=%d", CurEvent);
-					goto exit_with_error;
-				}
-				TRCPRINTF("\n");
-				if (!stackPush(psVar))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do stack push");
-					goto exit_with_error;
-				}
-				break;
-			case OP_POPARRAYGLOBAL:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_POPARRAYGLOBAL: %d", InstrPointer->type);
+op_poplocal:
+	INTERP_COUNT();
 
-				TRCPRINTOPCODE(opcode);
-				if (!interpGetArrayVarData(&InstrPointer, psGlobals, psProg, &psVar))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not get array var data");
-					goto exit_with_error;
-				}
-				TRCPRINTSTACKTOP();
-				TRCPRINTF("\n");
-				if (!stackPopType(psVar))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do pop stack of type");
-					goto exit_with_error;
-				}
-				break;
+	if (!stackPopType(&psLocals[pOp->data]))
+	{
+		debug(LOG_ERROR, "interpRunScript: OP_POPLOCAL: pop failed");
+		goto exit_with_error;
+	}
 
-			case OP_JUMPFALSE:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_JUMPFALSE: %d", InstrPointer->type);
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				TRCPRINTF("JUMPFALSE   %d (%d)",
-				          (SWORD)data, (int)(InstrPointer - psProg->pCode + (SWORD)data));
+op_pushlocalref:
+	INTERP_COUNT();
 
-				if (!stackPop(&sVal))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do pop of stack");
-					goto exit_with_error;
-				}
-				if (!sVal.v.bval)
-				{
-					// Do the jump
-					TRCPRINTF(" - done -\n");
-					InstrPointer += (SWORD)data;
-					if (InstrPointer < pCodeStart || InstrPointer > pCodeEnd)
-					{
-						debug(LOG_ERROR, "interpRunScript: jump out of range");
-						goto exit_with_error;
-					}
-				}
-				else
-				{
-					TRCPRINTF("\n");
-					InstrPointer += aOpSize[opcode];
-				}
-				break;
-			case OP_JUMP:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_JUMP: %d", InstrPointer->type);
-
-				TRCPRINTF("JUMP        %d (%d)\n",
-				          (SWORD)data, (int)(InstrPointer - psProg->pCode + (SWORD)data));
-				// Do the jump
-				InstrPointer += (SWORD)data;
-				if (InstrPointer < pCodeStart || InstrPointer > pCodeEnd)
-				{
-					debug(LOG_ERROR, "interpRunScript: jump out of range");
-					goto exit_with_error;
-				}
-				break;
-			case OP_CALL:
-				//debug(LOG_SCRIPT, "OP_CALL");
-
-				ASSERT(InstrPointer->type == VAL_OPCODE,
-				       "wrong value type passed for OP_CALL: %d", InstrPointer->type);
-
-				scriptFunc = ((INTERP_VAL *)(InstrPointer + 1))->v.pFuncExtern;
-				TRCPRINTFUNC(scriptFunc);
-				TRCPRINTF("\n");
-				//debug(LOG_SCRIPT, "OP_CALL 1");
-				if (!scriptFunc())
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do func");
-					goto exit_with_error;
-				}
-				//debug(LOG_SCRIPT, "OP_CALL 2");
-				InstrPointer += aOpSize[opcode];
-				//debug(LOG_SCRIPT, "OP_CALL 3");
-				break;
-			case OP_VARCALL:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_VARCALL: %d", InstrPointer->type);
-
-				TRCPRINTOPCODE(opcode);
-				TRCPRINTVARFUNC(((INTERP_VAL *)(InstrPointer + 1))->v.pObjGetSet, data);
-				TRCPRINTF("(%d)\n", data);
-
-				ASSERT(((INTERP_VAL *)(InstrPointer + 1))->type == VAL_OBJ_GETSET,
-				       "wrong set/get function pointer type passed for OP_VARCALL: %d", ((INTERP_VAL *)(InstrPointer + 1))->type);
-
-				scriptVarFunc = ((INTERP_VAL *)(InstrPointer + 1))->v.pObjGetSet;
-				if (!scriptVarFunc(data))
-				{
-					debug(LOG_ERROR, "interpRunScript: could not do var func");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_EXIT:	/* end of function/event, "exit" or "return" statements */
-				ASSERT(InstrPointer->type == VAL_OPCODE,
-				       "wrong value type passed for OP_EXIT: %d", InstrPointer->type);
-
-				// jump out of the code
-				InstrPointer = pCodeEnd;
-				break;
-			case OP_PAUSE:
-				ASSERT(InstrPointer->type == VAL_PKOPCODE,
-				       "wrong value type passed for OP_PAUSE: %d", InstrPointer->type);
-
-				TRCPRINTF("PAUSE       %d\n", data);
-				ASSERT(stackEmpty(),
-				       "interpRunScript: OP_PAUSE without empty stack");
-
-				InstrPointer += aOpSize[opcode];
-				// tell the event system to reschedule this event
-				if (!eventAddPauseTrigger(psContext, index, (UDWORD)(InstrPointer - pCodeBase), data))	//only original caller can be paused since we pass index and not CurEvent (not sure if that's what we want)
-				{
-					debug(LOG_ERROR, "interpRunScript: could not add pause trigger");
-					goto exit_with_error;
-				}
-				// now jump out of the event
-				InstrPointer = pCodeEnd;
-				break;
-			case OP_TO_FLOAT:
-				ASSERT(InstrPointer->type == VAL_OPCODE,
-				       "wrong value type passed for OP_TO_FLOAT: %d", InstrPointer->type);
-
-				if (!stackCastTop(VAL_FLOAT))
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_TO_FLOAT failed");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			case OP_TO_INT:
-				ASSERT(InstrPointer->type == VAL_OPCODE,
-				       "wrong value type passed for OP_TO_INT: %d", InstrPointer->type);
+	/* get local variable */
+	sVal.type = pOp->v.type;
+	sVal.v.oval = &psLocals[pOp->data];
 
-				if (!stackCastTop(VAL_INT))
-				{
-					debug(LOG_ERROR, "interpRunScript: OP_TO_INT failed");
-					goto exit_with_error;
-				}
-				InstrPointer += aOpSize[opcode];
-				break;
-			default:
-				debug(LOG_ERROR, "interpRunScript: unknown opcode: %d, type: %d", opcode, InstrPointer->type);
-				goto exit_with_error;
-				break;
-			}
-		}
-		else	//End of the event reached, see if we have to jump back to the caller function or just exit
-		{
-			//debug(LOG_SCRIPT, "End of event reached");
+	if (!stackPush(&sVal))
+	{
+		debug(LOG_ERROR, "interpRunScript: OP_PUSHLOCALREF: push failed");
+		goto exit_with_error;
+	}
 
-			if (!retStackIsEmpty())		//There was a caller function before this one
-			{
-				// destroy current variable environment
-				destroyVarEnvironment(psContext, retStackCallDepth(), CurEvent);
+	pOp += 2;
+	INTERP_DISPATCH();
 
-				//pop caller function index and return address
-				if (!retStackPop(&CurEvent, &InstrPointer))
-				{
-					debug(LOG_ERROR, "interpRunScript() - retStackPop() failed.");
-					return false;
-				}
+op_to_float:
+	INTERP_COUNT();
 
-				//remember last called event/index
-				strncpy(last_called_script_event, eventGetEventID(psProg, CurEvent), last_called_script_eventsz - 1);
-				last_called_script_event[last_called_script_eventsz - 1]= 0;
+	if (!stackCastTop(VAL_FLOAT))
+	{
+		debug(LOG_ERROR, "interpRunScript: OP_TO_FLOAT failed");
+		goto exit_with_error;
+	}
 
-				if (bTraceOn)
-				{
-					debug(LOG_SCRIPT, "Returned to: '%s'", last_called_script_event);
-				}
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				//debug( LOG_SCRIPT, "RETURNED TO CALLER EVENT %d", CurEvent );
+op_to_int:
+	INTERP_COUNT();
 
-				//Set new boundaries
-				//--------------------------
-				if (retStackIsEmpty())	//if we jumped back to the original caller
-				{
-					if (!bEvent)		//original caller was a trigger (is it possible at all?)
-					{
-						pCodeBase = psProg->pCode + psProg->pTriggerTab[CurEvent];
-						pCodeStart = pCodeBase;
-						pCodeEnd  = psProg->pCode + psProg->pTriggerTab[CurEvent + 1];
-					}
-					else			//original caller was an event
-					{
-						pCodeBase = psProg->pCode + psProg->pEventTab[CurEvent];
-						pCodeStart = pCodeBase + offset;	//also use the offset passed, since it's an original caller event (offset is used for pause() )
-						pCodeEnd  = psProg->pCode + psProg->pEventTab[CurEvent + 1];
-					}
-				}
-				else	//we are still jumping thru functions (this can't be a callback, since it can't/should not be called)
-				{
-					pCodeBase = psProg->pCode + psProg->pEventTab[CurEvent];
-					pCodeStart = pCodeBase;
-					pCodeEnd  = psProg->pCode + psProg->pEventTab[CurEvent + 1];
-				}
-			}
-			else		//we have returned to the original caller event/function
-			{
-				//debug( LOG_SCRIPT, " *** CALL STACK EMPTY ***" );
+	if (!stackCastTop(VAL_INT))
+	{
+		debug(LOG_ERROR, "interpRunScript: OP_TO_INT failed");
+		goto exit_with_error;
+	}
 
-				//reset local vars only if original caller was an event, not a trigger
-				if (bEvent)
-				{
-					// destroy current variable environment
-					destroyVarEnvironment(psContext, retStackCallDepth(), CurEvent);
-				}
+	pOp += 1;
+	INTERP_DISPATCH();
 
-				bStop = true;		//Stop execution of this event here, no more calling functions stored
-			}
+op_invalid:
+	debug(LOG_ERROR, "interpRunScript: %s at %d", pOp->v.pError, (int)(codeBase + (pOp - pOpBase)));
+	goto exit_with_error;
+
+op_end:		/* End of the event reached, see if we have to jump back to the caller function or just exit */
+	if (retStackIsEmpty())
+	{
+		//reset local vars only if original caller was an event, not a trigger
+		if (bEvent)
+		{
+			// destroy current variable environment
+			destroyVarEnvironment(psContext, retStackCallDepth(), CurEvent);
 		}
 
+		psCurProg = nullptr;
+		TRCPRINTF("EXIT\n");
+
+		bInterpRunning = false;
+		return true;
 	}
 
-	psCurProg = nullptr;
-	TRCPRINTF("%-6d  EXIT\n", (int)(InstrPointer - psProg->pCode));
+	// destroy current variable environment
+	destroyVarEnvironment(psContext, retStackCallDepth(), CurEvent);
 
-	bInterpRunning = false;
-	return true;
+	//pop caller function index and return address
+	if (!retStackPop(&CurEvent, &pOp))
+	{
+		debug(LOG_ERROR, "interpRunScript() - retStackPop() failed.");
+		goto exit_with_error;
+	}
+
+	psLocals = varEnvironment[retStackCallDepth()];
+
+	if (retStackIsEmpty() && !bEvent)	//original caller was a trigger
+	{
+		pOpBase = pOps + psDecoded->triggerOps[CurEvent];
+		codeBase = psProg->pTriggerTab[CurEvent];
+		last_called_script_event = psDecoded->triggerNames[CurEvent].c_str();
+	}
+	else
+	{
+		pOpBase = pOps + psDecoded->eventOps[CurEvent];
+		codeBase = psProg->pEventTab[CurEvent];
+		last_called_script_event = psDecoded->eventNames[CurEvent].c_str();
+	}
+
+	INTERP_DISPATCH();
 
 exit_with_error:
 	// Deal with the script crashing or running out of memory
@@ -925,8 +1144,7 @@ exit_with_error:
 	}
 
 	debug(LOG_ERROR, "Current event ID: %d (of %d)", CurEvent, psProg->numEvents);
-	callDepth = retStackCallDepth();
-	debug(LOG_ERROR, "Call depth : %d", callDepth);
+	debug(LOG_ERROR, "Call depth : %d", retStackCallDepth());
 
 	/* Output script call trace */
 	scrOutputCallTrace(LOG_ERROR);
@@ -940,6 +1158,65 @@ exit_with_error:
 	return false;
 }
 
+#ifdef INTERP_THREADED
+#pragma GCC diagnostic pop
+#endif
+
+/* Run a compiled script, adding the time it takes to its profile */
+bool interpRunScript(SCRIPT_CONTEXT *psContext, INTERP_RUNTYPE runType, UDWORD index, UDWORD offset)
+{
+	auto start = std::chrono::steady_clock::now();
+	SDWORD instructionCount = 0;
+	bool result = interpRun(psContext, runType, index, offset, instructionCount);
+	UDWORD time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	if (psContext == nullptr || psContext->psCode == nullptr || psContext->psCode->psDecoded == nullptr)
+	{
+		return result;  // interpRun() refused to run it, so there is nothing to profile.
+	}
+
+	SCRIPT_CODE *psProg = psContext->psCode;
+	INTERP_PROFILE &profile = interpProfile[std::make_tuple(psProg, runType, index)];
+
+	if (profile.calls == 0)
+	{
+		// First run, so copy the names now rather than keeping pointers into the script.
+		const char *pScript = resGetNamefromData("SCRIPT", psProg);
+		const std::vector<std::string> &names = runType == IRT_EVENT ? psProg->psDecoded->eventNames : psProg->psDecoded->triggerNames;
+		profile.script = pScript != nullptr ? pScript : "";
+		profile.event = runType == IRT_EVENT;
+		profile.name = index < names.size() ? names[index] : std::to_string(index);
+	}
+
+	profile.calls++;
+	profile.time += time;
+	profile.worst = MAX(profile.worst, time);
+	profile.instructions += instructionCount;
+
+	return result;
+}
+
+std::vector<INTERP_PROFILE> interpGetProfile()
+{
+	std::vector<INTERP_PROFILE> result;
+
+	for (auto const &entry : interpProfile)
+	{
+		result.push_back(entry.second);
+	}
+
+	std::sort(result.begin(), result.end(), [](INTERP_PROFILE const &a, INTERP_PROFILE const &b)
+	{
+		return a.time > b.time;
+	});
+	return result;
+}
+
+void interpResetProfile()
+{
+	interpProfile.clear();
+}
+
 
 /* Set the type equivalence table */
 void scriptSetTypeEquiv(TYPE_EQUIV *psTypeTab)
@@ -1073,7 +1350,7 @@ static inline bool retStackIsFull(void)
 }
 
 
-static bool retStackPush(UDWORD CallerIndex, INTERP_VAL *ReturnAddress)
+static bool retStackPush(UDWORD CallerIndex, const INTERP_OP *ReturnAddress)
 {
 	if (retStackIsFull())
 	{
@@ -1091,7 +1368,7 @@ static bool retStackPush(UDWORD CallerIndex, INTERP_VAL *ReturnAddress)
 }
 
 
-static bool retStackPop(UDWORD *CallerIndex, INTERP_VAL **ReturnAddress)
+static bool retStackPop(UDWORD *CallerIndex, const INTERP_OP **ReturnAddress)
 {
 	if (retStackIsEmpty())
 	{
@@ -1128,7 +1405,7 @@ void scrOutputCallTrace(code_part part)
 		return;
 	}
 
-	debug(part, "%d: %s (current event)", retStackPos + 1, &(last_called_script_event[0]));
+	debug(part, "%d: %s (current event)", retStackPos + 1, last_called_script_event);
 
 	if (psCurProg->psDebug != nullptr)
 	{
@@ -1143,7 +1420,7 @@ void scrOutputCallTrace(code_part part)
 				pEvent = eventGetEventID(psCurProg, retStack[i].CallerIndex);
 			}
 
-			debug(part, "%d: %s (return address: %p)", i, pEvent, static_cast<void *>(retStack[i].ReturnAddress));
+			debug(part, "%d: %s (return address: %p)", i, pEvent, static_cast<const void *>(retStack[i].ReturnAddress));
 		}
 	}
 	else
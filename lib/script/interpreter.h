@@ -287,6 +287,9 @@ struct TRIGGER_DATA
 	UDWORD			time;		// How often to check the trigger
 };
 
+/* The code of a script decoded for the interpreter, built by interpPrepare */
+struct INTERP_PROG;
+
 /* A compiled script and its associated data */
 struct SCRIPT_CODE
 {
@@ -319,6 +322,8 @@ struct SCRIPT_CODE
 
 	UWORD			debugEntries;	// Number of entries in psDebug
 	SCRIPT_DEBUG	*psDebug;		// Debugging info for the script
+
+	INTERP_PROG		*psDecoded;		// The code decoded by interpPrepare
 };
 
 
@@ -339,6 +344,12 @@ extern bool interpCheckEquiv(INTERP_TYPE to, INTERP_TYPE from);
 // Initialise the interpreter
 extern bool interpInitialise();
 
+/* Decode a newly compiled script for the interpreter */
+extern bool interpPrepare(SCRIPT_CODE *psProg);
+
+/* Free the decoded code of a script */
+extern void interpRelease(SCRIPT_CODE *psProg);
+
 // true if the interpreter is currently running
 extern bool interpProcessorActive();
 
@@ -133,6 +133,8 @@ void scriptFreeCode(SCRIPT_CODE *psCode)
 
 	free(psCode->numParams);
 
+	interpRelease(psCode);
+
 	free(psCode);
 }
 
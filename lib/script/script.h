@@ -25,6 +25,9 @@
 #ifndef _script_h
 #define _script_h
 
+#include <string>
+#include <vector>
+
 #include "interpreter.h"
 #include "stack.h"
 #include "codeprint.h"
@@ -121,6 +124,24 @@ extern const char *scriptFunctionToString(SCRIPT_FUNC function) WZ_DECL_PURE;
 extern bool interpRunScript(SCRIPT_CONTEXT *psContext, INTERP_RUNTYPE runType,
                             UDWORD index, UDWORD offset);
 
+/* Time taken by one event or trigger of a script, over all the times interpRunScript has run it */
+struct INTERP_PROFILE
+{
+	std::string		script;				// Resource name of the script
+	std::string		name;				// Name of the event or trigger
+	bool			event = false;		// An event rather than a trigger
+	UDWORD			calls = 0;
+	uint64_t		time = 0;			// Total time, in microseconds
+	UDWORD			worst = 0;			// Longest single run, in microseconds
+	uint64_t		instructions = 0;	// Total number of instructions run
+};
+
+/* Get the time taken by each event and trigger since interpResetProfile, slowest first */
+extern std::vector<INTERP_PROFILE> interpGetProfile();
+
+/* Forget the times taken so far */
+extern void interpResetProfile();
+
 
 /***********************************************************************************
  *
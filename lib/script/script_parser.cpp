@@ -296,6 +296,7 @@ void script_debug(const char *pFormat, ...);
 	(psProg)->numGlobals = (UWORD)(numGlobs); \
 	(psProg)->numTriggers = (UWORD)(numTriggers); \
 	(psProg)->numEvents = (UWORD)(numEvnts); \
+	(psProg)->psDecoded = NULL; \
 	(psProg)->size = (codeSize) * sizeof(INTERP_VAL);
 
 /* Macro to allocate a code block, blockSize - number of INTERP_VALs we need*/
@@ -8922,6 +8923,12 @@ SCRIPT_CODE* scriptCompile(PHYSFS_file* fileHandle, SCR_DEBUGTYPE debugType)
 
 	scriptResetTables();
 
+	if (!interpPrepare(psFinalProg))
+	{
+		scriptFreeCode(psFinalProg);
+		return NULL;
+	}
+
 	return psFinalProg;
 }
 
@@ -586,7 +586,7 @@ int aiBestNearestTarget(DROID *psDroid, BASE_OBJECT **ppsObj, int weapon_slot, i
 	int droidRange = std::min(aiDroidRange(psDroid, weapon_slot) + extraRange, objSensorRange(psDroid) + 6 * TILE_UNITS);
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, droidRange);
+	gridFindObjects(gridList, psDroid->pos.x, psDroid->pos.y, droidRange);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -933,7 +933,7 @@ bool aiChooseTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget, int weapon_slot
 			}
 
 			static GridList gridList;  // static to avoid allocations.
-			gridList = gridStartIterate(psObj->pos.x, psObj->pos.y, srange);
+			gridFindObjects(gridList, psObj->pos.x, psObj->pos.y, srange);
 
 			for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 			{
@@ -1021,7 +1021,7 @@ bool aiChooseSensorTarget(BASE_OBJECT *psObj, BASE_OBJECT **ppsTarget)
 		unsigned tarDist = UINT32_MAX;
 
 		static GridList gridList;  // static to avoid allocations.
-		gridList = gridStartIterate(psObj->pos.x, psObj->pos.y, objSensorRange(psObj));
+		gridFindObjects(gridList, psObj->pos.x, psObj->pos.y, objSensorRange(psObj));
 
 		for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 		{
@@ -35,9 +35,10 @@
  *    is continued until the new source is reached.  If the new source is  not reached,
  *    the droid is  on a  different island than the previous droid,  and pathfinding is
  *    restarted from the first step.
- *  Up to 30 pathfinding maps from A* are cached, in a LRU list. The PathNode heap con-
- *  tains the  priority-heap-sorted  nodes which are to be explored.  The path back  is
- *  stored in the PathExploredTile 2D array of tiles.
+ *  Up to 8 pathfinding maps from A* are cached per context set, in a LRU list. Jobs to
+ *  the same destination always use the same context set,  so each set can be searched by
+ *  a different thread.  The PathNode heap contains the  priority-heap-sorted nodes which
+ *  are to be explored.  The path back is stored in the PathExploredTile 2D array of tiles.
  */
 
 #ifndef WZ_TESTING
@@ -49,11 +50,26 @@
 
 #include <list>
 #include <vector>
+#include <queue>
 #include <algorithm>
 #include <memory>
+#include <climits>
 
 #include "lib/netplay/netplay.h"
 
+/// Clusters used for planning coarse routes are squares of 2^FPATH_CLUSTER_SHIFT tiles.
+#define FPATH_CLUSTER_SHIFT 4
+#define FPATH_CLUSTER_SIZE (1 << FPATH_CLUSTER_SHIFT)
+/// Routes shorter than this many tiles (in both directions) are always found with plain A*.
+#define FPATH_CLUSTER_MIN_ROUTE (3 * FPATH_CLUSTER_SIZE)
+/// Refined coarse routes are only used if no longer than NUM/DEN times the straight line distance, so at most that much longer than the best route.
+#define FPATH_CLUSTER_BOUND_NUM 5
+#define FPATH_CLUSTER_BOUND_DEN 4
+/// If more tiles than this are marked as changed before the blocking maps are updated, the maps are made from scratch instead.
+#define FPATH_MAX_JOURNAL 4096
+/// If more tiles than this changed between two blocking maps, contexts using the old map are not moved over to the new one.
+#define FPATH_MAX_CHANGED_TILES 256
+
 /// A coordinate.
 struct PathCoord
 {
@@ -111,6 +127,116 @@ struct PathExploredTile
 	bool     visited;
 };
 
+/** Bitmap of the map tiles, padded by one tile around the edge of the map, so that the neighbours of any tile on the map can be
+ *  looked up without bounds checks. Each row is a whole number of 64 bit words, with tile x of the row at bit x + 1.
+ */
+struct PathBitmap
+{
+	/// Makes a width×height bitmap, with all tiles, including the padding, set to value.
+	void resize(int width_, int height_, bool value)
+	{
+		width = width_;
+		height = height_;
+		stride = (width + 2 + 63) / 64;
+		bits.assign(stride * (height + 2), value ? ~uint64_t(0) : 0);
+	}
+	bool empty() const
+	{
+		return bits.empty();
+	}
+	/// Valid for -1 <= x <= width and -1 <= y <= height.
+	bool get(int x, int y) const
+	{
+		const unsigned bit = x + 1;
+		return (bits[(y + 1) * stride + bit / 64] >> bit % 64 & 1) != 0;
+	}
+	/// Returns the 3×3 tiles around (x, y), with tile (x + dx, y + dy) in bit (dx + 1) + 3 * (dy + 1). Valid for tiles on the map.
+	unsigned neighbours(int x, int y) const
+	{
+		const unsigned bit = x;  // Bit of tile x - 1.
+		uint64_t const *word = &bits[y * stride + bit / 64];  // Row of tile y - 1.
+		return getThree(word, bit % 64) | getThree(word + stride, bit % 64) << 3 | getThree(word + 2 * stride, bit % 64) << 6;
+	}
+	void set(int x, int y, bool value)
+	{
+		const unsigned bit = x + 1;
+		uint64_t &word = bits[(y + 1) * stride + bit / 64];
+		word = (word & ~(uint64_t(1) << bit % 64)) | uint64_t(value) << bit % 64;
+	}
+	/// Sets row y from one byte per tile, 0 meaning unset.
+	void setRow(int y, uint8_t const *row)
+	{
+		uint64_t *word = &bits[(y + 1) * stride];
+
+		for (int w = 0; w < stride; ++w)
+		{
+			const int first = std::max(w * 64, 1), last = std::min(w * 64 + 64, width + 1);  // Bits of word w which are on the map.
+
+			if (first >= last)
+			{
+				continue;
+			}
+
+			uint64_t value = 0;
+
+			for (int bit = first; bit < last; ++bit)
+			{
+				value |= uint64_t(row[bit - 1] != 0) << bit % 64;
+			}
+
+			const uint64_t mask = (last - first == 64 ? ~uint64_t(0) : (uint64_t(1) << (last - first)) - 1) << first % 64;
+			word[w] = (word[w] & ~mask) | value;
+		}
+	}
+
+	/// Calls fn(x, y) for each tile on the map which differs from other, which must be the same size.
+	template <typename Fn>
+	void forEachDifference(PathBitmap const &other, Fn fn) const
+	{
+		for (int y = 0; y < height; ++y)
+			for (int w = 0; w < stride; ++w)
+			{
+				const unsigned i = (y + 1) * stride + w;
+
+				for (uint64_t changed = bits[i] ^ other.bits[i]; changed != 0; changed &= changed - 1)
+				{
+					int bit = 0;
+
+					while ((changed >> bit & 1) == 0)
+					{
+						++bit;
+					}
+
+					const int x = w * 64 + bit - 1;
+
+					if (x >= 0 && x < width)  // Otherwise padding.
+					{
+						fn(x, y);
+					}
+				}
+			}
+	}
+
+	std::vector<uint64_t> bits;
+	int width = 0, height = 0;  ///< Size in tiles, not counting the padding.
+	int stride = 0;             ///< Words per row.
+
+private:
+	static unsigned getThree(uint64_t const *word, unsigned shift)
+	{
+		uint64_t three = word[0] >> shift;
+
+		if (shift > 61)
+		{
+			three |= word[1] << (64 - shift);
+		}
+
+		return three & 7;
+	}
+};
+
+struct PathClusterMap;
+
 struct PathBlockingType
 {
 	uint32_t gameTime;
@@ -130,8 +256,14 @@ struct PathBlockingMap
 	}
 
 	PathBlockingType type;
-	std::vector<bool> map;
-	std::vector<bool> dangerMap;	// using threatBits
+	PathBitmap map;               ///< Padding is blocking.
+	PathBitmap dangerMap;	// using threatBits, empty if not used.
+	std::shared_ptr<PathClusterMap const> clusterMap;  ///< Cluster abstraction of this map, built by the main thread when first needed.
+	uint32_t id = 0;              ///< Unique, so that maps updated from this one can tell it was their parent.
+	uint32_t parentId = 0;        ///< id of the map this was updated from, if changed lists every difference from it, otherwise 0.
+	std::vector<PathCoord> changed;  ///< Tiles which are blocking or dangerous in this map but not the parent, or the other way around.
+	uint32_t journalPos = 0;      ///< Tiles marked in fpathJournal before this position are already taken into account.
+	uint32_t checksumMap = 0, checksumDangerMap = 0;
 };
 
 struct PathNonblockingArea
@@ -160,7 +292,7 @@ struct PathNonblockingArea
 // Data structures used for pathfinding, can contain cached results.
 struct PathfindContext
 {
-	PathfindContext() : myGameTime(0), iteration(0), blockingMap(nullptr) {}
+	PathfindContext() : myGameTime(0), iteration(0), blockingMap(nullptr), corridor(nullptr), corridorWidth(0) {}
 	bool isBlocked(int x, int y) const
 	{
 		if (dstIgnore.isNonblocking(x, y))
@@ -168,18 +300,76 @@ struct PathfindContext
 			return false;  // The path is actually blocked here by a structure, but ignore it since it's where we want to go (or where we came from).
 		}
 
-		// Not sure whether the out-of-bounds check is needed, can only happen if pathfinding is started on a blocking tile (or off the map).
-		return x < 0 || y < 0 || x >= mapWidth || y >= mapHeight || blockingMap->map[x + y * mapWidth];
+		// No bounds check needed, since the map has blocking padding, and we never look further than one tile off the map.
+		if (corridor != nullptr && unsigned(x) < unsigned(mapWidth) && unsigned(y) < unsigned(mapHeight) && !corridor[(x >> FPATH_CLUSTER_SHIFT) + (y >> FPATH_CLUSTER_SHIFT) * corridorWidth])
+		{
+			return true;  // Outside the clusters which the coarse route goes through.
+		}
+
+		return blockingMap->map.get(x, y);
+	}
+	/// Returns isBlocked() for the 3×3 tiles around (x, y), as PathBitmap::neighbours() does.
+	unsigned blockedNeighbours(int x, int y) const
+	{
+		bool exact = dstIgnore.x1 < dstIgnore.x2 && dstIgnore.y1 < dstIgnore.y2 &&
+		             x + 1 >= dstIgnore.x1 && x - 1 < dstIgnore.x2 && y + 1 >= dstIgnore.y1 && y - 1 < dstIgnore.y2;
+
+		if (corridor != nullptr && !exact)
+		{
+			int cx1 = std::max(x - 1, 0) >> FPATH_CLUSTER_SHIFT, cx2 = std::min(x + 1, mapWidth - 1) >> FPATH_CLUSTER_SHIFT;
+			int cy1 = std::max(y - 1, 0) >> FPATH_CLUSTER_SHIFT, cy2 = std::min(y + 1, mapHeight - 1) >> FPATH_CLUSTER_SHIFT;
+			exact = !corridor[cx1 + cy1 * corridorWidth] || !corridor[cx2 + cy1 * corridorWidth] || !corridor[cx1 + cy2 * corridorWidth] || !corridor[cx2 + cy2 * corridorWidth];
+		}
+
+		if (!exact)
+		{
+			return blockingMap->map.neighbours(x, y);  // Common case, nothing to ignore and nothing outside the corridor.
+		}
+
+		unsigned blocked = 0;
+
+		for (int dy = -1; dy <= 1; ++dy)
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				blocked |= unsigned(isBlocked(x + dx, y + dy)) << ((dx + 1) + 3 * (dy + 1));
+			}
+
+		return blocked;
 	}
 	bool isDangerous(int x, int y) const
 	{
-		return !blockingMap->dangerMap.empty() && blockingMap->dangerMap[x + y * mapWidth];
+		return !blockingMap->dangerMap.empty() && blockingMap->dangerMap.get(x, y);
 	}
 	bool matches(std::shared_ptr<PathBlockingMap> &blockingMap_, PathCoord tileS_, PathNonblockingArea dstIgnore_) const
 	{
 		// Must check myGameTime == blockingMap_->type.gameTime, otherwise blockingMap could be a deleted pointer which coincidentally compares equal to the valid pointer blockingMap_.
 		return myGameTime == blockingMap_->type.gameTime && blockingMap == blockingMap_ && tileS == tileS_ && dstIgnore == dstIgnore_;
 	}
+	/// Moves the context over to blockingMap_, if it was updated from the map the context was using, and none of the tiles
+	/// which changed were explored yet, so that exploring the new map would have given the same results so far.
+	bool rebase(std::shared_ptr<PathBlockingMap> &blockingMap_, PathCoord tileS_, PathNonblockingArea dstIgnore_)
+	{
+		if (blockingMap == nullptr || blockingMap_->parentId != blockingMap->id || blockingMap_->parentId == 0 || tileS != tileS_ || dstIgnore != dstIgnore_)
+		{
+			return false;
+		}
+
+		for (PathCoord const &tile : blockingMap_->changed)
+		{
+			for (int y = std::max(tile.y - 1, 0); y <= std::min(tile.y + 1, mapHeight - 1); ++y)
+				for (int x = std::max(tile.x - 1, 0); x <= std::min(tile.x + 1, mapWidth - 1); ++x)
+				{
+					if (map[x + y * mapWidth].iteration == iteration)
+					{
+						return false;  // A changed tile was explored, or could have been reached from an explored tile.
+					}
+				}
+		}
+
+		blockingMap = blockingMap_;
+		myGameTime = blockingMap->type.gameTime;
+		return true;
+	}
 	void assign(std::shared_ptr<PathBlockingMap> &blockingMap_, PathCoord tileS_, PathNonblockingArea dstIgnore_)
 	{
 		blockingMap = blockingMap_;
@@ -213,13 +403,35 @@ struct PathfindContext
 	std::vector<PathExploredTile> map;  ///< Map, with paths leading back to tileS.
 	std::shared_ptr<PathBlockingMap> blockingMap; ///< Map of blocking tiles for the type of object which needs a path.
 	PathNonblockingArea dstIgnore;      ///< Area of structure at destination which should be considered nonblocking.
+	uint8_t const  *corridor;           ///< If not null, only tiles in clusters marked here can be entered.
+	int             corridorWidth;      ///< Width of corridor, in clusters.
 };
 
-/// Last recently used list of contexts.
-static std::list<PathfindContext> fpathContexts;
+/// Maximum number of contexts cached in each context set.
+#define FPATH_CONTEXTS_PER_SET 8
 
-/// Lists of blocking maps from current tick.
+/// A* data belonging to one context set. Only one path-finding thread uses a given set at any time.
+struct PathfindContextSet
+{
+	std::list<PathfindContext> contexts;  ///< Last recently used list of contexts.
+	std::vector<Vector2i> path;           ///< Route being built, kept here to save allocations.
+	PathfindContext corridorContext;      ///< Used for refining coarse routes, never reused for other jobs.
+	std::vector<uint8_t> corridor;        ///< Clusters the current coarse route may use.
+};
+
+static PathfindContextSet fpathContextSets[FPATH_CONTEXT_SETS];
+
+/// Latest blocking map for each type of blocking map. Maps from earlier ticks are updated using fpathJournal.
 static std::vector<std::shared_ptr<PathBlockingMap>> fpathBlockingMaps;
+/// Tiles which may have changed blocking since the oldest map in fpathBlockingMaps was made. Entry i is at position fpathJournalStart + i.
+static std::vector<PathCoord> fpathJournal;
+static uint32_t fpathJournalStart;
+/// Last PathBlockingMap::id used.
+static uint32_t fpathLastBlockingMapId;
+/// Scroll limits the maps in fpathBlockingMaps were made with.
+static int fpathScrollLimits[4];
+/// Most recent cluster map for each type of blocking map, to be updated for later ticks.
+static std::vector<std::shared_ptr<PathClusterMap const>> fpathClusterMaps;
 /// Game time for all blocking maps in fpathBlockingMaps.
 static uint32_t fpathCurrentGameTime;
 
@@ -236,11 +448,24 @@ static const Vector2i aDirOffset[] =
 	Vector2i(1, 0),
 	Vector2i(1, 1),
 };
+/// Bit of each direction in PathBitmap::neighbours().
+static const unsigned aDirBit[] = {7, 6, 3, 0, 1, 2, 5, 8};
 
 void fpathHardTableReset()
 {
-	fpathContexts.clear();
+	for (auto &contextSet : fpathContextSets)
+	{
+		contextSet.contexts.clear();
+		contextSet.path.clear();
+	}
+	fpathResetBlockingMaps();
+}
+
+void fpathResetBlockingMaps()
+{
 	fpathBlockingMaps.clear();
+	fpathClusterMaps.clear();
+	fpathJournal.clear();
 }
 
 /** Get the nearest entry in the open list
@@ -398,9 +623,20 @@ static PathCoord fpathAStarExplore(PathfindContext &context, PathCoord tileF)
 			foundIt = true;  // Break out of loop, but not before inserting neighbour nodes, since the neighbours may be important if the context gets reused.
 		}
 
+		// Look up all the neighbours at once, since they are next to each other in the blocking map.
+		const unsigned blocked = context.blockedNeighbours(node.p.x, node.p.y);
+		const bool nodeIgnored = context.dstIgnore.isNonblocking(node.p.x, node.p.y);
+
 		// loop through possible moves in 8 directions to find a valid move
 		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
 		{
+			// See if the node is a blocking tile
+			if ((blocked >> aDirBit[dir] & 1) != 0)
+			{
+				// tile is blocked, skip it
+				continue;
+			}
+
 			// Try a new location
 			int x = node.p.x + aDirOffset[dir].x;
 			int y = node.p.y + aDirOffset[dir].y;
@@ -413,35 +649,15 @@ static PathCoord fpathAStarExplore(PathfindContext &context, PathCoord tileF)
 			   3  2  1
 			   odd:orthogonal-adjacent tiles even:non-orthogonal-adjacent tiles
 			*/
-			if (dir % 2 != 0 && !context.dstIgnore.isNonblocking(node.p.x, node.p.y) && !context.dstIgnore.isNonblocking(x, y))
+			if (dir % 2 != 0 && !nodeIgnored && !context.dstIgnore.isNonblocking(x, y))
 			{
-				int x, y;
-
 				// We cannot cut corners
-				x = node.p.x + aDirOffset[(dir + 1) % 8].x;
-				y = node.p.y + aDirOffset[(dir + 1) % 8].y;
-
-				if (context.isBlocked(x, y))
-				{
-					continue;
-				}
-
-				x = node.p.x + aDirOffset[(dir + 7) % 8].x;
-				y = node.p.y + aDirOffset[(dir + 7) % 8].y;
-
-				if (context.isBlocked(x, y))
+				if ((blocked >> aDirBit[(dir + 1) % 8] & 1) != 0 || (blocked >> aDirBit[(dir + 7) % 8] & 1) != 0)
 				{
 					continue;
 				}
 			}
 
-			// See if the node is a blocking tile
-			if (context.isBlocked(x, y))
-			{
-				// tile is blocked, skip it
-				continue;
-			}
-
 			// Now insert the point into the appropriate list, if not already visited.
 			fpathNewNode(context, tileF, PathCoord(x, y), node.dist, node.p);
 		}
@@ -459,8 +675,493 @@ static void fpathInitContext(PathfindContext &context, std::shared_ptr<PathBlock
 	ASSERT(!context.nodes.empty(), "fpathNewNode failed to add node.");
 }
 
-ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
+/** Cluster/portal abstraction of a blocking map, used for planning long routes.
+ *
+ *  The map is divided into clusters of FPATH_CLUSTER_SIZE×FPATH_CLUSTER_SIZE tiles. Wherever a run of free tiles crosses
+ *  the border between two clusters, entrance nodes are placed on both sides of the border, and each cluster stores the cost
+ *  of moving between each pair of its entrances without leaving the cluster. A route through the entrances gives the
+ *  clusters which a path needs to go through, and A* restricted to those clusters then finds the actual path.
+ */
+struct PathCluster
+{
+	std::vector<PathCoord> nodes;   ///< Entrance tiles, sorted by y, then x.
+	std::vector<unsigned> cost;     ///< cost[a * nodes.size() + b] is the cost of moving from node a to node b inside the cluster, or UINT_MAX if impossible.
+};
+
+struct PathClusterMap
+{
+	bool isBlocked(int x, int y) const
+	{
+		return map.get(x, y);  // Only called for tiles on the map, or next to it.
+	}
+	unsigned costFactor(int x, int y) const
+	{
+		return !dangerMap.empty() && dangerMap.get(x, y) ? 5 : 1;
+	}
+	int clusterOf(PathCoord p) const
+	{
+		return (p.x >> FPATH_CLUSTER_SHIFT) + (p.y >> FPATH_CLUSTER_SHIFT) * width;
+	}
+	int clusterOfNode(unsigned node) const
+	{
+		return std::upper_bound(firstNode.begin(), firstNode.end(), node) - firstNode.begin() - 1;
+	}
+
+	PathBlockingType type;
+	int mapWidth, mapHeight;            ///< Size in tiles.
+	int width, height;                  ///< Size in clusters.
+	PathBitmap map;                     ///< Copy of the blocking map this was built from, to find out what changed later.
+	PathBitmap dangerMap;
+	std::vector<std::shared_ptr<PathCluster const>> clusters;  ///< Unchanged clusters are shared with older cluster maps.
+	std::vector<unsigned> firstNode;    ///< Number of nodes in all earlier clusters, for each cluster, followed by the total number of nodes.
+};
+
+static inline bool pathCoordLess(PathCoord const &a, PathCoord const &b)
+{
+	return a.y != b.y ? a.y < b.y : a.x < b.x;
+}
+
+static inline int fpathClusterOffset(PathCoord p)
+{
+	return (p.x & (FPATH_CLUSTER_SIZE - 1)) + (p.y & (FPATH_CLUSTER_SIZE - 1)) * FPATH_CLUSTER_SIZE;
+}
+
+/// Finds the cost of moving from tileS to each tile of the cluster containing tileS, without leaving the cluster.
+static void fpathClusterDistances(PathClusterMap const &clusterMap, PathCoord tileS, std::vector<unsigned> &dist)
+{
+	typedef std::pair<unsigned, int> Item;  // Distance, then tile offset, so that ties are broken the same way everywhere.
+
+	const int x0 = tileS.x & ~(FPATH_CLUSTER_SIZE - 1), x1 = std::min(x0 + FPATH_CLUSTER_SIZE, clusterMap.mapWidth);
+	const int y0 = tileS.y & ~(FPATH_CLUSTER_SIZE - 1), y1 = std::min(y0 + FPATH_CLUSTER_SIZE, clusterMap.mapHeight);
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+	dist.assign(FPATH_CLUSTER_SIZE * FPATH_CLUSTER_SIZE, UINT_MAX);
+	dist[fpathClusterOffset(tileS)] = 0;
+	open.push(Item(0, fpathClusterOffset(tileS)));
+
+	while (!open.empty())
+	{
+		Item item = open.top();
+		open.pop();
+
+		if (item.first != dist[item.second])
+		{
+			continue;  // Already found a shorter way here.
+		}
+
+		int x = x0 + item.second % FPATH_CLUSTER_SIZE;
+		int y = y0 + item.second / FPATH_CLUSTER_SIZE;
+
+		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); ++dir)
+		{
+			int nx = x + aDirOffset[dir].x;
+			int ny = y + aDirOffset[dir].y;
+
+			if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1 || clusterMap.isBlocked(nx, ny))
+			{
+				continue;
+			}
+
+			// We cannot cut corners, same as in fpathAStarExplore.
+			if (dir % 2 != 0 && (clusterMap.isBlocked(x + aDirOffset[(dir + 1) % 8].x, y + aDirOffset[(dir + 1) % 8].y) ||
+			                     clusterMap.isBlocked(x + aDirOffset[(dir + 7) % 8].x, y + aDirOffset[(dir + 7) % 8].y)))
+			{
+				continue;
+			}
+
+			unsigned newDist = item.first + (dir % 2 != 0 ? 198 : 140) * clusterMap.costFactor(nx, ny);
+			int offset = (nx - x0) + (ny - y0) * FPATH_CLUSTER_SIZE;
+
+			if (newDist < dist[offset])
+			{
+				dist[offset] = newDist;
+				open.push(Item(newDist, offset));
+			}
+		}
+	}
+}
+
+/// Finds the entrances of cluster (cx, cy), and the costs of moving between them.
+static std::shared_ptr<PathCluster const> fpathBuildCluster(PathClusterMap const &clusterMap, int cx, int cy)
+{
+	const int x0 = cx * FPATH_CLUSTER_SIZE, x1 = std::min(x0 + FPATH_CLUSTER_SIZE, clusterMap.mapWidth);
+	const int y0 = cy * FPATH_CLUSTER_SIZE, y1 = std::min(y0 + FPATH_CLUSTER_SIZE, clusterMap.mapHeight);
+	std::shared_ptr<PathCluster> cluster = std::make_shared<PathCluster>();
+	std::vector<PathCoord> &nodes = cluster->nodes;
+
+	// Walks len tiles from (x, y) in direction (sx, sy) along the border, adding entrances where runs of tiles are free on both
+	// sides of the border. The cluster on the other side of the border, at (dx, dy), finds the same runs, and so the same entrances.
+	auto addEntrances = [&](int x, int y, int sx, int sy, int dx, int dy, int len)
+	{
+		int runStart = -1;
+
+		for (int i = 0; i <= len; ++i)
+		{
+			bool free = i < len && !clusterMap.isBlocked(x + sx * i, y + sy * i) && !clusterMap.isBlocked(x + sx * i + dx, y + sy * i + dy);
+
+			if (free && runStart < 0)
+			{
+				runStart = i;
+			}
+			else if (!free && runStart >= 0)
+			{
+				int runEnd = i - 1;
+
+				if (runEnd - runStart >= FPATH_CLUSTER_SIZE / 2)
+				{
+					// Long run, use both ends so that routes along the border need no detour.
+					nodes.push_back(PathCoord(x + sx * runStart, y + sy * runStart));
+					nodes.push_back(PathCoord(x + sx * runEnd, y + sy * runEnd));
+				}
+				else
+				{
+					int mid = (runStart + runEnd) / 2;
+					nodes.push_back(PathCoord(x + sx * mid, y + sy * mid));
+				}
+
+				runStart = -1;
+			}
+		}
+	};
+
+	if (y0 > 0)
+	{
+		addEntrances(x0, y0, 1, 0, 0, -1, x1 - x0);
+	}
+
+	if (y1 < clusterMap.mapHeight)
+	{
+		addEntrances(x0, y1 - 1, 1, 0, 0, 1, x1 - x0);
+	}
+
+	if (x0 > 0)
+	{
+		addEntrances(x0, y0, 0, 1, -1, 0, y1 - y0);
+	}
+
+	if (x1 < clusterMap.mapWidth)
+	{
+		addEntrances(x1 - 1, y0, 0, 1, 1, 0, y1 - y0);
+	}
+
+	std::sort(nodes.begin(), nodes.end(), pathCoordLess);
+	nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());  // Corner tiles can be entrances on two borders.
+
+	const unsigned numNodes = nodes.size();
+	std::vector<unsigned> dist;
+
+	cluster->cost.resize(numNodes * numNodes);
+
+	for (unsigned a = 0; a < numNodes; ++a)
+	{
+		fpathClusterDistances(clusterMap, nodes[a], dist);
+
+		for (unsigned b = 0; b < numNodes; ++b)
+		{
+			cluster->cost[a * numNodes + b] = dist[fpathClusterOffset(nodes[b])];
+		}
+	}
+
+	return cluster;
+}
+
+/// Makes a cluster map for blockingMap, only rebuilding the clusters which differ from previous, if given.
+static std::shared_ptr<PathClusterMap const> fpathUpdateClusterMap(PathClusterMap const *previous, PathBlockingMap const &blockingMap)
+{
+	std::shared_ptr<PathClusterMap> clusterMap = std::make_shared<PathClusterMap>();
+
+	clusterMap->type = blockingMap.type;
+	clusterMap->mapWidth = mapWidth;
+	clusterMap->mapHeight = mapHeight;
+	clusterMap->width = (mapWidth + FPATH_CLUSTER_SIZE - 1) >> FPATH_CLUSTER_SHIFT;
+	clusterMap->height = (mapHeight + FPATH_CLUSTER_SIZE - 1) >> FPATH_CLUSTER_SHIFT;
+	clusterMap->map = blockingMap.map;
+	clusterMap->dangerMap = blockingMap.dangerMap;
+
+	const int width = clusterMap->width, height = clusterMap->height;
+	std::vector<bool> dirty(width * height, previous == nullptr);
+
+	// Tiles on a border also affect the entrances of the cluster on the other side.
+	auto markTile = [&](int x, int y)
+	{
+		int cx = x >> FPATH_CLUSTER_SHIFT, cy = y >> FPATH_CLUSTER_SHIFT;
+		int bx = x & (FPATH_CLUSTER_SIZE - 1), by = y & (FPATH_CLUSTER_SIZE - 1);
+		dirty[cx + cy * width] = true;
+
+		if (bx == 0 && cx > 0)
+		{
+			dirty[(cx - 1) + cy * width] = true;
+		}
+
+		if (bx == FPATH_CLUSTER_SIZE - 1 && cx < width - 1)
+		{
+			dirty[(cx + 1) + cy * width] = true;
+		}
+
+		if (by == 0 && cy > 0)
+		{
+			dirty[cx + (cy - 1) * width] = true;
+		}
+
+		if (by == FPATH_CLUSTER_SIZE - 1 && cy < height - 1)
+		{
+			dirty[cx + (cy + 1) * width] = true;
+		}
+	};
+
+	if (previous != nullptr)
+	{
+		// Compare whole words, and only look at the tiles which changed.
+		clusterMap->map.forEachDifference(previous->map, markTile);
+
+		if (clusterMap->dangerMap.empty() != previous->dangerMap.empty())
+		{
+			dirty.assign(width * height, true);
+		}
+		else if (!clusterMap->dangerMap.empty())
+		{
+			clusterMap->dangerMap.forEachDifference(previous->dangerMap, markTile);
+		}
+	}
+
+	clusterMap->clusters.resize(width * height);
+	clusterMap->firstNode.resize(width * height + 1);
+	clusterMap->firstNode[0] = 0;
+
+	for (int c = 0; c < width * height; ++c)
+	{
+		clusterMap->clusters[c] = dirty[c] ? fpathBuildCluster(*clusterMap, c % width, c / width) : previous->clusters[c];
+		clusterMap->firstNode[c + 1] = clusterMap->firstNode[c] + clusterMap->clusters[c]->nodes.size();
+	}
+
+	return clusterMap;
+}
+
+/// Plans a coarse route from tileS to tileF through the cluster entrances, and marks the clusters it uses, and their neighbours, in corridor.
+static bool fpathClusterPlan(PathClusterMap const &clusterMap, PathCoord tileS, PathCoord tileF, std::vector<uint8_t> &corridor)
+{
+	typedef std::pair<unsigned, unsigned> Item;  // Estimate, then node, so that ties are broken the same way everywhere.
+
+	const int clusterS = clusterMap.clusterOf(tileS);
+	const int clusterF = clusterMap.clusterOf(tileF);
+	const unsigned goal = clusterMap.firstNode.back();  // Extra node for tileF, after all the entrances.
+	std::vector<unsigned> distS, distF;
+	std::vector<unsigned> dist(goal + 1, UINT_MAX);
+	std::vector<unsigned> prev(goal + 1, UINT_MAX);
+	std::vector<bool> closed(goal + 1, false);
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+	auto relax = [&](unsigned node, unsigned newDist, unsigned from, PathCoord p)
+	{
+		if (newDist < dist[node])
+		{
+			dist[node] = newDist;
+			prev[node] = from;
+			open.push(Item(newDist + fpathGoodEstimate(p, tileF), node));
+		}
+	};
+
+	fpathClusterDistances(clusterMap, tileS, distS);
+	fpathClusterDistances(clusterMap, tileF, distF);
+
+	PathCluster const &startCluster = *clusterMap.clusters[clusterS];
+
+	for (unsigned i = 0; i < startCluster.nodes.size(); ++i)
+	{
+		unsigned d = distS[fpathClusterOffset(startCluster.nodes[i])];
+
+		if (d != UINT_MAX)
+		{
+			relax(clusterMap.firstNode[clusterS] + i, d, UINT_MAX, startCluster.nodes[i]);
+		}
+	}
+
+	while (!open.empty() && !closed[goal])
+	{
+		const unsigned node = open.top().second;
+		open.pop();
+
+		if (closed[node])
+		{
+			continue;
+		}
+
+		closed[node] = true;
+
+		if (node == goal)
+		{
+			break;
+		}
+
+		const int c = clusterMap.clusterOfNode(node);
+		PathCluster const &cluster = *clusterMap.clusters[c];
+		const unsigned numNodes = cluster.nodes.size();
+		const unsigned i = node - clusterMap.firstNode[c];
+		const PathCoord p = cluster.nodes[i];
+
+		// Move to another entrance of the same cluster.
+		for (unsigned j = 0; j < numNodes; ++j)
+		{
+			unsigned cost = cluster.cost[i * numNodes + j];
+
+			if (j != i && cost != UINT_MAX)
+			{
+				relax(clusterMap.firstNode[c] + j, dist[node] + cost, node, cluster.nodes[j]);
+			}
+		}
+
+		// Move to the destination.
+		if (c == clusterF && distF[fpathClusterOffset(p)] != UINT_MAX)
+		{
+			relax(goal, dist[node] + distF[fpathClusterOffset(p)], node, tileF);
+		}
+
+		// Move across the border, to an entrance of the neighbouring cluster.
+		for (unsigned dir = 0; dir < ARRAY_SIZE(aDirOffset); dir += 2)
+		{
+			PathCoord q(p.x + aDirOffset[dir].x, p.y + aDirOffset[dir].y);
+
+			if (clusterMap.isBlocked(q.x, q.y) || clusterMap.clusterOf(q) == c)
+			{
+				continue;
+			}
+
+			const int neighbour = clusterMap.clusterOf(q);
+			std::vector<PathCoord> const &neighbourNodes = clusterMap.clusters[neighbour]->nodes;
+			auto j = std::lower_bound(neighbourNodes.begin(), neighbourNodes.end(), q, pathCoordLess);
+
+			if (j != neighbourNodes.end() && *j == q)
+			{
+				relax(clusterMap.firstNode[neighbour] + (j - neighbourNodes.begin()), dist[node] + 140 * clusterMap.costFactor(q.x, q.y), node, q);
+			}
+		}
+	}
+
+	if (!closed[goal])
+	{
+		return false;  // No coarse route, let plain A* find the nearest reachable tile.
+	}
+
+	const int width = clusterMap.width, height = clusterMap.height;
+	auto markCluster = [&](int c)
+	{
+		int cx = c % width, cy = c / width;
+
+		for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, height - 1); ++y)
+			for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, width - 1); ++x)
+			{
+				corridor[x + y * width] = true;
+			}
+	};
+
+	corridor.assign(width * height, false);
+	markCluster(clusterS);
+	markCluster(clusterF);
+
+	for (unsigned node = prev[goal]; node != UINT_MAX; node = prev[node])
+	{
+		markCluster(clusterMap.clusterOfNode(node));
+	}
+
+	return true;
+}
+
+/// Gets the route from endCoord back to context.tileS, in that order.
+static bool fpathAStarBuildPath(PathfindContext const &context, PathCoord endCoord, std::vector<Vector2i> &path)
 {
+	path.clear();
+
+	Vector2i newP(0, 0);
+
+	for (Vector2i p(world_coord(endCoord.x) + TILE_UNITS / 2, world_coord(endCoord.y) + TILE_UNITS / 2); true; p = newP)
+	{
+		ASSERT_OR_RETURN(false, worldOnMap(p.x, p.y), "Assigned XY coordinates (%d, %d) not on map!", (int)p.x, (int)p.y);
+		ASSERT_OR_RETURN(false, path.size() < (unsigned)mapWidth * mapHeight, "Pathfinding got in a loop.");
+
+		path.push_back(p);
+
+		PathExploredTile const &tile = context.map[map_coord(p.x) + map_coord(p.y) * mapWidth];
+		newP = p - Vector2i(tile.dx, tile.dy) * (TILE_UNITS / 64);
+		Vector2i mapP = map_coord(newP);
+		int xSide = newP.x - world_coord(mapP.x) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on right-hand side of the tile, or -1 if newP is on the left-hand side of the tile.
+		int ySide = newP.y - world_coord(mapP.y) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on bottom side of the tile, or -1 if newP is on the top side of the tile.
+
+		if (context.isBlocked(mapP.x + xSide, mapP.y))
+		{
+			newP.x = world_coord(mapP.x) + TILE_UNITS / 2; // Point too close to a blocking tile on left or right side, so move the point to the middle.
+		}
+
+		if (context.isBlocked(mapP.x, mapP.y + ySide))
+		{
+			newP.y = world_coord(mapP.y) + TILE_UNITS / 2; // Point too close to a blocking tile on rop or bottom side, so move the point to the middle.
+		}
+
+		if (map_coord(p) == Vector2i(context.tileS.x, context.tileS.y) || p == newP)
+		{
+			break;  // We stopped moving, because we reached the destination or the closest reachable tile to context.tileS. Give up now.
+		}
+	}
+
+	return true;
+}
+
+/// Finds a route by planning a coarse route through the cluster map, and then refining it with A* restricted to the clusters used.
+static bool fpathClusterRoute(MOVE_CONTROL *psMove, PATHJOB *psJob, PathfindContextSet &contextSet, PathCoord tileOrig, PathCoord tileDest, PathNonblockingArea dstIgnore)
+{
+	PathClusterMap const &clusterMap = *psJob->clusterMap;
+
+	if (clusterMap.mapWidth != mapWidth || clusterMap.mapHeight != mapHeight || clusterMap.isBlocked(tileOrig.x, tileOrig.y) || clusterMap.isBlocked(tileDest.x, tileDest.y))
+	{
+		return false;  // Coarse routes only connect free tiles.
+	}
+
+	if (!fpathClusterPlan(clusterMap, tileOrig, tileDest, contextSet.corridor))
+	{
+		return false;
+	}
+
+	PathfindContext &context = contextSet.corridorContext;
+	fpathInitContext(context, psJob->blockingMap, tileOrig, tileOrig, tileDest, dstIgnore);
+	context.corridor = contextSet.corridor.data();
+	context.corridorWidth = clusterMap.width;
+	PathCoord endCoord = fpathAStarExplore(context, tileDest);
+	context.corridor = nullptr;  // Smooth the path using the real blocking map.
+
+	if (endCoord != tileDest)
+	{
+		return false;
+	}
+
+	// The distance can't be shorter than the straight line, so this bounds how much longer than the best route the refined route is.
+	uint64_t dist = context.map[tileDest.x + tileDest.y * mapWidth].dist;
+
+	if (dist * FPATH_CLUSTER_BOUND_DEN > uint64_t(fpathGoodEstimate(tileOrig, tileDest)) * FPATH_CLUSTER_BOUND_NUM)
+	{
+		return false;
+	}
+
+	std::vector<Vector2i> &path = contextSet.path;
+
+	if (!fpathAStarBuildPath(context, endCoord, path))
+	{
+		return false;
+	}
+
+	// Found exact path, so use exact coordinates for last point, no reason to lose precision
+	path.front() = Vector2i(psJob->destX, psJob->destY);
+
+	psMove->asPath.resize(path.size());
+	std::copy(path.rbegin(), path.rend(), psMove->asPath.data());
+	psMove->destination = psMove->asPath[path.size() - 1];
+
+	return true;
+}
+
+ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob, unsigned contextSet)
+{
+	ASSERT_OR_RETURN(ASR_FAILED, contextSet < FPATH_CONTEXT_SETS, "Bad context set %u", contextSet);
+
+	std::list<PathfindContext> &fpathContexts = fpathContextSets[contextSet].contexts;
 	ASR_RETVAL      retval = ASR_OK;
 
 	bool            mustReverse = true;
@@ -475,7 +1176,7 @@ ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
 
 	for (contextIterator = fpathContexts.begin(); contextIterator != fpathContexts.end(); ++contextIterator)
 	{
-		if (!contextIterator->matches(psJob->blockingMap, tileDest, dstIgnore))
+		if (!contextIterator->matches(psJob->blockingMap, tileDest, dstIgnore) && !contextIterator->rebase(psJob->blockingMap, tileDest, dstIgnore))
 		{
 			// This context is not for the same droid type and same destination.
 			continue;
@@ -508,9 +1209,15 @@ ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
 
 	if (contextIterator == fpathContexts.end())
 	{
-		// We did not find an appropriate context. Make one.
+		// We did not find an appropriate context. If the route is long, try planning it through the cluster map first.
+		if (psJob->clusterMap && fpathClusterRoute(psMove, psJob, fpathContextSets[contextSet], tileOrig, tileDest, dstIgnore))
+		{
+			return ASR_OK;
+		}
 
-		if (fpathContexts.size() < 30)
+		// Make a context.
+
+		if (fpathContexts.size() < FPATH_CONTEXTS_PER_SET)
 		{
 			fpathContexts.push_back(PathfindContext());
 		}
@@ -533,38 +1240,11 @@ ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
 	}
 
 	// Get route, in reverse order.
-	static std::vector<Vector2i> path;  // Declared static to save allocations.
-	path.clear();
-
-	Vector2i newP(0, 0);
+	std::vector<Vector2i> &path = fpathContextSets[contextSet].path;
 
-	for (Vector2i p(world_coord(endCoord.x) + TILE_UNITS / 2, world_coord(endCoord.y) + TILE_UNITS / 2); true; p = newP)
+	if (!fpathAStarBuildPath(context, endCoord, path))
 	{
-		ASSERT_OR_RETURN(ASR_FAILED, worldOnMap(p.x, p.y), "Assigned XY coordinates (%d, %d) not on map!", (int)p.x, (int)p.y);
-		ASSERT_OR_RETURN(ASR_FAILED, path.size() < (unsigned)mapWidth * mapHeight, "Pathfinding got in a loop.");
-
-		path.push_back(p);
-
-		PathExploredTile &tile = context.map[map_coord(p.x) + map_coord(p.y) * mapWidth];
-		newP = p - Vector2i(tile.dx, tile.dy) * (TILE_UNITS / 64);
-		Vector2i mapP = map_coord(newP);
-		int xSide = newP.x - world_coord(mapP.x) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on right-hand side of the tile, or -1 if newP is on the left-hand side of the tile.
-		int ySide = newP.y - world_coord(mapP.y) > TILE_UNITS / 2 ? 1 : -1; // 1 if newP is on bottom side of the tile, or -1 if newP is on the top side of the tile.
-
-		if (context.isBlocked(mapP.x + xSide, mapP.y))
-		{
-			newP.x = world_coord(mapP.x) + TILE_UNITS / 2; // Point too close to a blocking tile on left or right side, so move the point to the middle.
-		}
-
-		if (context.isBlocked(mapP.x, mapP.y + ySide))
-		{
-			newP.y = world_coord(mapP.y) + TILE_UNITS / 2; // Point too close to a blocking tile on rop or bottom side, so move the point to the middle.
-		}
-
-		if (map_coord(p) == Vector2i(context.tileS.x, context.tileS.y) || p == newP)
-		{
-			break;  // We stopped moving, because we reached the destination or the closest reachable tile to context.tileS. Give up now.
-		}
+		return ASR_FAILED;
 	}
 
 	if (retval == ASR_OK)
@@ -624,13 +1304,198 @@ ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob)
 	return retval;
 }
 
+/// Returns the factor which tile i is multiplied by in the blocking map checksums, the i-th value of factor = 3 * factor + 1, which is (3^(i + 1) - 1)/2.
+static uint32_t fpathChecksumFactor(uint32_t i)
+{
+	const uint64_t mask = (uint64_t(1) << 33) - 1;  // Work modulo 2^33, so that the division by 2 is exact.
+	uint64_t power = 1, base = 3;
+
+	for (uint64_t e = uint64_t(i) + 1; e != 0; e >>= 1)
+	{
+		if ((e & 1) != 0)
+		{
+			power = power * base & mask;
+		}
+
+		base = base * base & mask;
+	}
+
+	return uint32_t(((power - 1) & mask) >> 1);
+}
+
+/// Generates the danger map of blockMap, if the type of map needs one.
+static void fpathMakeDangerMap(PathBlockingMap &blockMap, std::vector<uint8_t> &row)
+{
+	PathBlockingType const &type = blockMap.type;
+
+	if (isHumanPlayer(type.owner) || type.moveType != FMT_MOVE)
+	{
+		return;
+	}
+
+	blockMap.dangerMap.resize(mapWidth, mapHeight, false);
+
+	for (int y = 0; y < mapHeight; ++y)
+	{
+		uint8_t const *aux = &psAuxMap[type.owner][y * mapWidth];
+
+		for (int x = 0; x < mapWidth; ++x)
+		{
+			row[x] = (aux[x] & AUXBITS_THREAT) != 0;
+		}
+
+		blockMap.dangerMap.setRow(y, row.data());
+	}
+}
+
+/// Generates blockMap from scratch.
+static void fpathMakeBlockingMap(PathBlockingMap &blockMap)
+{
+	PathBlockingType const &type = blockMap.type;
+	std::vector<uint8_t> row(mapWidth);
+	uint32_t checksumMap = 0, checksumDangerMap = 0, factor = 0;
+
+	// Generate a row at a time, and pack it into the bitmap.
+	blockMap.map.resize(mapWidth, mapHeight, true);
+
+	for (int y = 0; y < mapHeight; ++y)
+	{
+		fpathBaseBlockingRow(y, type.propulsion, type.owner, type.moveType, row.data());
+		blockMap.map.setRow(y, row.data());
+
+		for (int x = 0; x < mapWidth; ++x)
+		{
+			checksumMap ^= row[x] * (factor = 3 * factor + 1);
+		}
+	}
+
+	fpathMakeDangerMap(blockMap, row);
+
+	if (!blockMap.dangerMap.empty())
+	{
+		for (int y = 0; y < mapHeight; ++y)
+			for (int x = 0; x < mapWidth; ++x)
+			{
+				checksumDangerMap ^= blockMap.dangerMap.get(x, y) * (factor = 3 * factor + 1);
+			}
+	}
+
+	blockMap.checksumMap = checksumMap;
+	blockMap.checksumDangerMap = checksumDangerMap;
+}
+
+/// Makes blockMap by updating a copy of an older map of the same type, only looking at the tiles marked in the journal since then.
+static void fpathUpdateBlockingMap(PathBlockingMap &blockMap, PathBlockingMap const &old)
+{
+	PathBlockingType const &type = blockMap.type;
+	const uint32_t numTiles = mapWidth * mapHeight;
+	bool tooManyChanges = false;
+
+	auto markChanged = [&](int x, int y)
+	{
+		if (blockMap.changed.size() < FPATH_MAX_CHANGED_TILES)
+		{
+			blockMap.changed.push_back(PathCoord(x, y));
+		}
+		else
+		{
+			tooManyChanges = true;
+		}
+	};
+
+	blockMap.map = old.map;
+	blockMap.checksumMap = old.checksumMap;
+	blockMap.checksumDangerMap = old.checksumDangerMap;
+
+	for (unsigned i = old.journalPos - fpathJournalStart; i < fpathJournal.size(); ++i)
+	{
+		const PathCoord tile = fpathJournal[i];
+		const bool blocked = fpathBaseBlockingTile(tile.x, tile.y, type.propulsion, type.owner, type.moveType);
+
+		if (blocked != blockMap.map.get(tile.x, tile.y))
+		{
+			blockMap.map.set(tile.x, tile.y, blocked);
+			blockMap.checksumMap ^= fpathChecksumFactor(tile.x + tile.y * mapWidth);
+			markChanged(tile.x, tile.y);
+		}
+	}
+
+	// Threats are not journalled, so regenerate the danger map, and see what changed.
+	std::vector<uint8_t> row(mapWidth);
+	fpathMakeDangerMap(blockMap, row);
+
+	if (!blockMap.dangerMap.empty())
+	{
+		blockMap.dangerMap.forEachDifference(old.dangerMap, [&](int x, int y)
+		{
+			blockMap.checksumDangerMap ^= fpathChecksumFactor(numTiles + x + y * mapWidth);
+			markChanged(x, y);
+		});
+	}
+
+	if (tooManyChanges)
+	{
+		blockMap.changed.clear();  // Not worth checking whether contexts can be kept.
+	}
+	else
+	{
+		blockMap.parentId = old.id;
+	}
+}
+
+void fpathMarkBlockingChanged(StructureBounds const &area)
+{
+	if (fpathBlockingMaps.empty())
+	{
+		return;  // Nothing to update.
+	}
+
+	if (fpathJournal.size() + area.size.x * area.size.y > FPATH_MAX_JOURNAL)
+	{
+		// So much changed that it is cheaper to make new maps from scratch, so forget the journal. Start it past the position of every
+		// map made so far, including any made at the current end, so that none of them are updated from it, since area isn't in it.
+		fpathJournalStart += fpathJournal.size() + 1;
+		fpathJournal.clear();
+		return;
+	}
+
+	for (int y = std::max(area.map.y, 0); y < std::min(area.map.y + area.size.y, mapHeight); ++y)
+		for (int x = std::max(area.map.x, 0); x < std::min(area.map.x + area.size.x, mapWidth); ++x)
+		{
+			fpathJournal.push_back(PathCoord(x, y));
+		}
+}
+
 void fpathSetBlockingMap(PATHJOB *psJob)
 {
 	if (fpathCurrentGameTime != gameTime)
 	{
-		// New tick, remove maps which are no longer needed.
+		// New tick. Maps also depend on the map size and scroll limits, so can't be updated if those changed.
 		fpathCurrentGameTime = gameTime;
-		fpathBlockingMaps.clear();
+		const int scrollLimits[4] = {scrollMinX, scrollMinY, scrollMaxX, scrollMaxY};
+
+		if (!std::equal(scrollLimits, scrollLimits + 4, fpathScrollLimits) || std::any_of(fpathBlockingMaps.begin(), fpathBlockingMaps.end(), [](std::shared_ptr<PathBlockingMap> const & ptr)
+		{
+			return ptr->map.width != mapWidth || ptr->map.height != mapHeight;
+		}))
+		{
+			std::copy(scrollLimits, scrollLimits + 4, fpathScrollLimits);
+			fpathBlockingMaps.clear();
+		}
+
+		// Forget the part of the journal which all maps have seen.
+		uint32_t journalEnd = fpathJournalStart + fpathJournal.size(), oldest = journalEnd;
+
+		for (auto const &ptr : fpathBlockingMaps)
+		{
+			if (ptr->journalPos >= fpathJournalStart)
+			{
+				oldest = std::min(oldest, ptr->journalPos);
+			}
+		}
+
+		fpathJournal.erase(fpathJournal.begin(), fpathJournal.begin() + (oldest - fpathJournalStart));
+		fpathJournalStart = oldest;
 	}
 
 	// Figure out which map we are looking for.
@@ -640,47 +1505,45 @@ void fpathSetBlockingMap(PATHJOB *psJob)
 	type.owner = psJob->owner;
 	type.moveType = psJob->moveType;
 
-	// Find the map.
+	// Find the map, or an older map of the same type.
 	auto i = std::find_if(fpathBlockingMaps.begin(), fpathBlockingMaps.end(), [&](std::shared_ptr<PathBlockingMap> const & ptr)
 	{
-		return *ptr == type;
+		return fpathIsEquivalentBlocking(ptr->type.propulsion, ptr->type.owner, ptr->type.moveType,
+		                                 type.propulsion,      type.owner,      type.moveType);
 	});
 
-	if (i == fpathBlockingMaps.end())
+	if (i == fpathBlockingMaps.end() || !(**i == type))
 	{
-		// Didn't find the map, so i does not point to a map.
-		PathBlockingMap *blockMap = new PathBlockingMap();
-		fpathBlockingMaps.emplace_back(blockMap);
-
-		// blockMap now points to an empty map with no data. Fill the map.
+		// Didn't find the map for this tick, so make it.
+		std::shared_ptr<PathBlockingMap> blockMap = std::make_shared<PathBlockingMap>();
 		blockMap->type = type;
-		std::vector<bool> &map = blockMap->map;
-		map.resize(mapWidth * mapHeight);
-		uint32_t checksumMap = 0, checksumDangerMap = 0, factor = 0;
+		blockMap->id = ++fpathLastBlockingMapId;
+		blockMap->journalPos = fpathJournalStart + fpathJournal.size();
 
-		for (int y = 0; y < mapHeight; ++y)
-			for (int x = 0; x < mapWidth; ++x)
-			{
-				map[x + y * mapWidth] = fpathBaseBlockingTile(x, y, type.propulsion, type.owner, type.moveType);
-				checksumMap ^= map[x + y * mapWidth] * (factor = 3 * factor + 1);
-			}
+		const bool wantDangerMap = !isHumanPlayer(type.owner) && type.moveType == FMT_MOVE;
 
-		if (!isHumanPlayer(type.owner) && type.moveType == FMT_MOVE)
+		if (i != fpathBlockingMaps.end() && (*i)->journalPos >= fpathJournalStart && (*i)->dangerMap.empty() != wantDangerMap)
 		{
-			std::vector<bool> &dangerMap = blockMap->dangerMap;
-			dangerMap.resize(mapWidth * mapHeight);
+			fpathUpdateBlockingMap(*blockMap, **i);
+			*i = blockMap;
+		}
+		else
+		{
+			fpathMakeBlockingMap(*blockMap);
 
-			for (int y = 0; y < mapHeight; ++y)
-				for (int x = 0; x < mapWidth; ++x)
-				{
-					dangerMap[x + y * mapWidth] = auxTile(x, y, type.owner) & AUXBITS_THREAT;
-					checksumDangerMap ^= dangerMap[x + y * mapWidth] * (factor = 3 * factor + 1);
-				}
+			if (i != fpathBlockingMaps.end())
+			{
+				*i = blockMap;
+			}
+			else
+			{
+				fpathBlockingMaps.push_back(blockMap);
+			}
 		}
 
-		syncDebug("blockingMap(%d,%d,%d,%d) = %08X %08X", gameTime, psJob->propulsion, psJob->owner, psJob->moveType, checksumMap, checksumDangerMap);
+		syncDebug("blockingMap(%d,%d,%d,%d) = %08X %08X", gameTime, psJob->propulsion, psJob->owner, psJob->moveType, blockMap->checksumMap, blockMap->checksumDangerMap);
 
-		psJob->blockingMap = fpathBlockingMaps.back();
+		psJob->blockingMap = blockMap;
 	}
 	else
 	{
@@ -688,4 +1551,35 @@ void fpathSetBlockingMap(PATHJOB *psJob)
 
 		psJob->blockingMap = *i;
 	}
+
+	// Long routes are planned through the cluster map, which is updated from the last one built for the same type of blocking map.
+	const int routeLength = std::max(abs(map_coord(psJob->destX) - map_coord(psJob->origX)), abs(map_coord(psJob->destY) - map_coord(psJob->origY)));
+
+	if (routeLength >= FPATH_CLUSTER_MIN_ROUTE)
+	{
+		PathBlockingMap &blockingMap = *psJob->blockingMap;
+
+		if (!blockingMap.clusterMap)
+		{
+			auto j = std::find_if(fpathClusterMaps.begin(), fpathClusterMaps.end(), [&](std::shared_ptr<PathClusterMap const> const & ptr)
+			{
+				return ptr->mapWidth == mapWidth && ptr->mapHeight == mapHeight &&
+				       fpathIsEquivalentBlocking(ptr->type.propulsion, ptr->type.owner, ptr->type.moveType,
+				                                 type.propulsion,      type.owner,      type.moveType);
+			});
+
+			if (j == fpathClusterMaps.end())
+			{
+				blockingMap.clusterMap = fpathUpdateClusterMap(nullptr, blockingMap);
+				fpathClusterMaps.push_back(blockingMap.clusterMap);
+			}
+			else
+			{
+				blockingMap.clusterMap = fpathUpdateClusterMap(j->get(), blockingMap);
+				*j = blockingMap.clusterMap;
+			}
+		}
+
+		psJob->clusterMap = blockingMap.clusterMap;
+	}
 }
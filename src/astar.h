@@ -34,16 +34,30 @@ enum ASR_RETVAL
 	ASR_NEAREST,    ///< found a partial route to a nearby position
 };
 
+/** Number of independent sets of cached A* contexts.
+ *
+ *  Each path job is searched using the contexts of a single set, chosen from the job alone, so the
+ *  resulting paths do not depend on how many threads are used to process the sets. Must be a power of 2.
+ *
+ *  @ingroup pathfinding
+ */
+#define FPATH_CONTEXT_SETS 8
+
 /** Use the A* algorithm to find a path
+ *
+ *  Must not be called concurrently with the same contextSet.
  *
  *  @ingroup pathfinding
  */
-ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob);
+ASR_RETVAL fpathAStarRoute(MOVE_CONTROL *psMove, PATHJOB *psJob, unsigned contextSet);
 
 /// Call from main thread.
 /// Sets psJob->blockingMap for later use by pathfinding thread, generating the required map if not already generated.
 void fpathSetBlockingMap(PATHJOB *psJob);
 
+/// Call from main thread, whenever the blocking of the tiles in area may have changed, so that blocking maps made before can be updated.
+void fpathMarkBlockingChanged(StructureBounds const &area);
+
 /** Clean up the path finding node table.
  *
  *  @note Call this on shutdown to prevent memory from leaking, or if loading/saving, to prevent stale data from being reused.
@@ -52,4 +66,8 @@ void fpathSetBlockingMap(PATHJOB *psJob);
  */
 void fpathHardTableReset();
 
+/// Forget the cached blocking and cluster maps, and the journal of changes to them. Call from main thread whenever the map is replaced.
+/// Contexts are kept, since they are only reused with the blocking map they were made for.
+void fpathResetBlockingMaps();
+
 #endif // __INCLUDED_SRC_ASTART_H__
@@ -116,6 +116,8 @@ struct BASE_OBJECT : public SIMPLE_OBJECT
 	uint               selected;                   ///< Whether the object is selected (might want this elsewhere)
 	uint               visible[MAX_PLAYERS];       ///< Whether object is visible to specific player
 	UBYTE               seenThisTick[MAX_PLAYERS];  ///< Whether object has been seen this tick by the specific player.
+	int                 gridCell = -1;              ///< Cell of the map grid the object was last put in, see mapgrid.cpp.
+	unsigned            gridSlot = 0;               ///< Index of the object in that cell.
 	uint               numWatchedTiles;            ///< Number of watched tiles, zero for features
 	uint              lastEmission;               ///< When did it last puff out smoke?
 	WEAPON_SUBCLASS     lastHitWeapon;              ///< The weapon that last hit it
@@ -0,0 +1,184 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/*
+ * benchmark.cpp
+ *
+ * Runs of a fixed number of game ticks without rendering, timing each part of the simulation.
+ * A hidden window and GL context are still needed, since the renderer loads its data at startup.
+ * The game to run comes from -skirmish or -replay, the driver skips rendering while benchmarking.
+ */
+#include "lib/framework/frame.h"
+#include "lib/framework/rational.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/script/script.h"
+
+#include <chrono>
+
+#include "benchmark.h"
+#include "multiplay.h"
+
+#define BENCHMARK_TIME_MOD 1000         ///< Game time modifier, high enough to tick on every loop.
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+static const char *phaseNames[BENCH_COUNT] = {"other", "scripts", "visibility", "pathing", "droids", "structures", "projectiles", "objmem"};
+
+static int benchmarkTicks = 0;          ///< Ticks to run, 0 if not benchmarking.
+static int ticksRun = 0;
+static bool running = false;            ///< Set from loading the level until the report is printed.
+static bool finished = false;
+static bool inUpdate = false;           ///< Phases are only timed between benchmarkUpdateStart and benchmarkUpdateEnd.
+static BENCHMARK_PHASE currentPhase = BENCH_OTHER;
+static BenchmarkClock::time_point phaseStart;
+static BenchmarkClock::time_point updateStart;
+static BenchmarkClock::time_point runStart;
+static BenchmarkClock::duration phaseTime[BENCH_COUNT];
+static BenchmarkClock::duration updateTime;   ///< Sum of all phases.
+
+static double toMs(BenchmarkClock::duration d)
+{
+	return std::chrono::duration<double, std::milli>(d).count();
+}
+
+void setBenchmark(int ticks)
+{
+	benchmarkTicks = MAX(ticks, 1);
+}
+
+bool benchmark_enabled()
+{
+	return benchmarkTicks != 0;
+}
+
+bool benchmarkDone()
+{
+	return finished;
+}
+
+void benchmarkGameLoaded()
+{
+	if (!benchmark_enabled())
+	{
+		return;
+	}
+
+	for (auto &time : phaseTime)
+	{
+		time = BenchmarkClock::duration::zero();
+	}
+	updateTime = BenchmarkClock::duration::zero();
+	ticksRun = 0;
+	interpResetProfile();
+	running = true;
+	gameTimeSetMod(Rational(BENCHMARK_TIME_MOD));
+	runStart = BenchmarkClock::now();
+	debug(LOG_INFO, "Benchmarking %d ticks of %s", benchmarkTicks, game.map);
+}
+
+void benchmarkFinish()
+{
+	if (!running)
+	{
+		return;
+	}
+	running = false;
+	inUpdate = false;
+	finished = true;
+
+	double wallMs = toMs(BenchmarkClock::now() - runStart);
+	double updateMs = toMs(updateTime);
+	int ticks = MAX(ticksRun, 1);
+
+	printf("Benchmark of %s: %d ticks, %u ms of game time\n", game.map, ticksRun, gameTime);
+	printf("  %.1f ticks/s simulated (%.0f ms), %.1f ticks/s wall clock (%.0f ms)\n", ticksRun * 1000. / MAX(updateMs, 1.), updateMs, ticksRun * 1000. / MAX(wallMs, 1.), wallMs);
+	printf("  %-12s %10s %6s %10s\n", "phase", "ms", "%", "us/tick");
+	for (unsigned i = 0; i < BENCH_COUNT; ++i)
+	{
+		double ms = toMs(phaseTime[i]);
+		printf("  %-12s %10.1f %5.1f%% %10.1f\n", phaseNames[i], ms, 100. * ms / MAX(updateMs, 1.), 1000. * ms / ticks);
+	}
+
+	// Legacy .slo scripts, if any AI uses them.
+	uint64_t scriptCalls = 0, scriptTime = 0, scriptInstructions = 0;
+	for (auto const &profile : interpGetProfile())
+	{
+		scriptCalls += profile.calls;
+		scriptTime += profile.time;
+		scriptInstructions += profile.instructions;
+	}
+	if (scriptCalls != 0)
+	{
+		printf("  legacy scripts: %llu runs, %llu instructions, %.1f ms, %.1f ns/instruction\n", (unsigned long long)scriptCalls, (unsigned long long)scriptInstructions,
+		       scriptTime / 1000., 1000. * scriptTime / MAX(scriptInstructions, (uint64_t)1));
+	}
+	fflush(stdout);
+}
+
+void benchmarkUpdateStart()
+{
+	if (!running)
+	{
+		return;
+	}
+
+	inUpdate = true;
+	currentPhase = BENCH_OTHER;
+	updateStart = phaseStart = BenchmarkClock::now();
+}
+
+void benchmarkUpdateEnd()
+{
+	if (!inUpdate)
+	{
+		return;
+	}
+
+	BenchmarkClock::time_point now = BenchmarkClock::now();
+	phaseTime[currentPhase] += now - phaseStart;
+	updateTime += now - updateStart;
+	inUpdate = false;
+
+	if (deltaGameTime != 0 && ++ticksRun >= benchmarkTicks)
+	{
+		benchmarkFinish();
+	}
+}
+
+/// Charges the time since the last switch to the phase that was running, and starts timing the given phase.
+static BENCHMARK_PHASE benchmarkPhaseSwitch(BENCHMARK_PHASE phase)
+{
+	BENCHMARK_PHASE previous = currentPhase;
+	if (inUpdate && phase != previous)
+	{
+		BenchmarkClock::time_point now = BenchmarkClock::now();
+		phaseTime[previous] += now - phaseStart;
+		phaseStart = now;
+		currentPhase = phase;
+	}
+	return previous;
+}
+
+BenchmarkPhase::BenchmarkPhase(BENCHMARK_PHASE phase)
+	: previous(benchmarkPhaseSwitch(phase))
+{}
+
+BenchmarkPhase::~BenchmarkPhase()
+{
+	benchmarkPhaseSwitch(previous);
+}
@@ -0,0 +1,69 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/*
+ * benchmark.h
+ *
+ * Runs of a fixed number of game ticks without rendering, timing each part of the simulation.
+ * A hidden window and GL context are still needed, since the renderer loads its data at startup.
+ */
+
+#ifndef __INCLUDED_SRC_BENCHMARK_H__
+#define __INCLUDED_SRC_BENCHMARK_H__
+
+/// Parts of a game tick, timed separately. Time is charged to the innermost phase running.
+enum BENCHMARK_PHASE
+{
+	BENCH_OTHER,        ///< Everything not in one of the phases below.
+	BENCH_SCRIPTS,
+	BENCH_VISIBILITY,
+	BENCH_PATHING,      ///< Requesting routes and collecting them from the path threads.
+	BENCH_DROIDS,
+	BENCH_STRUCTURES,
+	BENCH_PROJECTILES,
+	BENCH_OBJMEM,
+	BENCH_COUNT
+};
+
+/// Runs the given number of ticks as fast as possible without rendering, prints the timings, then quits.
+void setBenchmark(int ticks) asm ("setBenchmark");
+/// Returns true if running a benchmark, in which case the game is never rendered.
+bool benchmark_enabled() asm ("benchmark_enabled");
+/// Returns true once all the ticks have run and the timings have been printed.
+bool benchmarkDone() asm ("benchmarkDone");
+
+/// Call once the level is loaded, to start counting ticks.
+void benchmarkGameLoaded();
+/// Prints the timings so far, if not already done. Called when the game ends before all the ticks have run.
+void benchmarkFinish();
+/// Call at the start of gameStatePreUpdate and at the end of gameStatePostUpdate, respectively.
+void benchmarkUpdateStart();
+void benchmarkUpdateEnd();
+
+/// Charges the time until it goes out of scope to the given phase, then returns to the phase it interrupted.
+class BenchmarkPhase
+{
+public:
+	BenchmarkPhase(BENCHMARK_PHASE phase);
+	~BenchmarkPhase();
+
+private:
+	BENCHMARK_PHASE previous;
+};
+
+#endif // __INCLUDED_SRC_BENCHMARK_H__
@@ -143,6 +143,10 @@ bool loadConfig()
 	radarRotationArrow = ini.value("radarRotationArrow", true).toBool();
 	quitConfirmation = ini.value("quitConfirmation", true).toBool();
 	war_SetPauseOnFocusLoss(ini.value("PauseOnFocusLoss", false).toBool());
+	war_SetPathfindingThreads(ini.value("pathfindingThreads", 0).toInt());
+	war_SetRecordReplays(ini.value("recordReplays", false).toBool());
+	war_SetEffectBudget(ini.value("effectBudget", 3000).toInt());
+	war_SetScriptTimerBudget(ini.value("scriptTimerBudget", 0).toInt());
 	NETsetMasterserverName(ini.value("masterserver_name", "lobby.wz2100.net").toString().toUtf8().constData());
 	iV_font(ini.value("fontname", "DejaVu Sans").toString().toUtf8().constData(),
 	        ini.value("fontface", "Book").toString().toUtf8().constData(),
@@ -304,6 +308,10 @@ bool saveConfig()
 	ini.setValue("radarRotationArrow", radarRotationArrow);
 	ini.setValue("quitConfirmation", quitConfirmation);
 	ini.setValue("PauseOnFocusLoss", war_GetPauseOnFocusLoss());
+	ini.setValue("pathfindingThreads", war_GetPathfindingThreads());
+	ini.setValue("recordReplays", war_GetRecordReplays());
+	ini.setValue("effectBudget", war_GetEffectBudget());
+	ini.setValue("scriptTimerBudget", war_GetScriptTimerBudget());
 	ini.setValue("masterserver_name", NETgetMasterserverName());
 	ini.setValue("masterserver_port", NETgetMasterserverPort());
 	ini.setValue("gameserver_port", NETgetGameserverPort());
@@ -2059,7 +2059,9 @@ void	dealWithLMB()
 			        mouseTileX, mouseTileY, world_coord(mouseTileX), world_coord(mouseTileY),
 			        (int)psTile->limitedContinent, (int)psTile->hoverContinent, psTile->level, (int)psTile->illumination,
 			        aux & AUXBITS_DANGER ? "danger" : "", aux & AUXBITS_THREAT ? "threat" : "",
-			        (int)psTile->watchers[selectedPlayer], (int)psTile->sensors[selectedPlayer], (int)psTile->jammers[selectedPlayer]);
+			        (int)visionMap(VISMAP_WATCHERS, selectedPlayer)[mouseTileX + mouseTileY * mapWidth],
+			        (int)visionMap(VISMAP_SENSORS, selectedPlayer)[mouseTileX + mouseTileY * mapWidth],
+			        (int)visionMap(VISMAP_JAMMERS, selectedPlayer)[mouseTileX + mouseTileY * mapWidth]);
 		}
 
 		return;
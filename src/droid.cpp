@@ -39,6 +39,7 @@
 #include "droid.h"
 #include "objects.h"
 #include "loop.h"
+#include "benchmark.h"
 #include "visibility.h"
 #include "map.h"
 #include "hci.h"
@@ -720,6 +721,7 @@ void syncDebugDroidOcaml(DROID const *psDroid, char ch)
 /* The main update routine for all droids */
 void droidUpdate(DROID *psDroid)
 {
+	BenchmarkPhase  phase(BENCH_DROIDS);
 	Vector3i        dv;
 	UDWORD          percentDamage, emissionInterval;
 	BASE_OBJECT     *psBeingTargetted = nullptr;
@@ -67,6 +67,7 @@
 
 #include "multiplay.h"
 #include "component.h"
+#include "warzoneconfig.h"
 #ifndef GLM_ENABLE_EXPERIMENTAL
 #define GLM_ENABLE_EXPERIMENTAL
 #endif
@@ -152,7 +153,11 @@
 #define SHOCKWAVE_SPEED	(GAME_TICKS_PER_SEC)
 #define	MAX_SHOCKWAVE_SIZE				500
 
-static std::list<EFFECT *> activeList;
+/// The effects in the world, one array per group, so that each group is updated together and kept close in memory.
+/// Each array is reserved once when first used and never grows past that, so effects don't move while pointers
+/// to them are in the render buckets, or while their update adds more effects.
+static std::vector<EFFECT> effectPools[EFFECT_FREED];
+static unsigned effectsThinned = 0;  ///< Counts effects considered for thinning out, to keep every other one.
 
 /* Tick counts for updates on a particular interval */
 static	UDWORD	lastUpdateStructures[EFFECT_STRUCTURE_DIVISION];
@@ -177,7 +182,21 @@ static bool updateDestruction(EFFECT *psEffect);
 static bool updateFire(EFFECT *psEffect);
 static bool updateSatLaser(EFFECT *psEffect);
 static bool updateFirework(EFFECT *psEffect);
-static bool updateEffect(EFFECT *psEffect);	// MASTER function
+
+/// Update functions for each group, in the order of EFFECT_GROUP. Each returns false if the effect should be deleted.
+static bool (*const updateEffectGroup[EFFECT_FREED])(EFFECT *psEffect) =
+{
+	updateExplosion,
+	updateConstruction,
+	updatePolySmoke,
+	updateGraviton,
+	updateWaypoint,
+	updateBlood,
+	updateDestruction,
+	updateSatLaser,
+	updateFire,
+	updateFirework,
+};
 
 // ----------------------------------------------------------------------------------------
 // ---- The render functions - every group type of effect has a distinct one
@@ -212,12 +231,48 @@ static UDWORD effectGetNumFrames(EFFECT *psEffect);
 
 void shutdownEffectsSystem()
 {
-	for (auto eff : activeList)
+	for (auto &pool : effectPools)
+	{
+		std::vector<EFFECT>().swap(pool);  // Free the memory too, the budget may have changed by the next game.
+	}
+}
+
+/// Returns a new effect in the group, or nullptr if there is no room for it. Unless essential, effects are
+/// thinned out once half the budget is used, and dropped once it's all used, keeping the ones which show
+/// what's going on (waypoints, destruction, fires and the laser satellite) for as long as possible.
+static EFFECT *allocEffect(EFFECT_GROUP group, bool essential)
+{
+	ASSERT_OR_RETURN(nullptr, group < EFFECT_FREED, "Weirdy group type %d for an effect", (int)group);
+
+	const unsigned budget = war_GetEffectBudget();
+	std::vector<EFFECT> &pool = effectPools[group];
+
+	if (pool.empty() && pool.capacity() < budget)
 	{
-		delete eff;
+		pool.reserve(budget);  // Nothing points into the pool yet, so safe to move it.
 	}
 
-	activeList.clear();
+	if (pool.size() >= pool.capacity())
+	{
+		return nullptr;  // Growing would move the effects.
+	}
+
+	if (!essential && group != EFFECT_WAYPOINT && group != EFFECT_DESTRUCTION && group != EFFECT_FIRE && group != EFFECT_SAT_LASER)
+	{
+		size_t numEffects = 0;
+		for (auto const &other : effectPools)
+		{
+			numEffects += other.size();
+		}
+
+		if (numEffects >= budget || (numEffects >= budget / 2 && ++effectsThinned % 2 != 0))
+		{
+			return nullptr;
+		}
+	}
+
+	pool.emplace_back();
+	return &pool.back();
 }
 
 /*!
@@ -306,7 +361,13 @@ void addEffect(const Vector3i *pos, EFFECT_GROUP group, EFFECT_TYPE type, bool s
 		return;
 	}
 
-	EFFECT *psEffect = new EFFECT();
+	EFFECT *psEffect = allocEffect(group, false);
+	if (psEffect == nullptr)
+	{
+		SetEffectForPlayer(0);	// reset it, as if the effect had been added
+		return;
+	}
+
 	/* Reset control bits */
 	psEffect->control = 0;
 
@@ -409,129 +470,50 @@ void addEffect(const Vector3i *pos, EFFECT_GROUP group, EFFECT_TYPE type, bool s
 	}
 
 	ASSERT(psEffect->imd != nullptr || group == EFFECT_DESTRUCTION || group == EFFECT_FIRE || group == EFFECT_SAT_LASER, "null effect imd");
-
-	activeList.push_back(psEffect);
 }
 
 
 /* Calls all the update functions for each different currently active effect */
 void processEffects(const glm::mat4 &viewMatrix)
 {
-	for (auto it = activeList.begin(); it != activeList.end();)
+	for (unsigned group = 0; group < EFFECT_FREED; ++group)
 	{
-		EFFECT *psEffect = *it;
+		std::vector<EFFECT> &pool = effectPools[group];
+		bool (*const update)(EFFECT *) = updateEffectGroup[group];
+		const bool paused = gamePaused() && group != EFFECT_EXPLOSION;  // Explosions finish even when paused.
 
-		if (psEffect->birthTime <= graphicsTime)  // Don't process, if it doesn't exist yet
+		// Effects added by the updates go on the end, and are processed in this loop too.
+		for (size_t i = 0; i < pool.size();)
 		{
-			if (!updateEffect(psEffect))
-			{
-				delete psEffect;
-				it = activeList.erase(it);
-				continue;
-			}
+			EFFECT *psEffect = &pool[i];
 
-			if (psEffect->group != EFFECT_FREED && clipXY(psEffect->position.x, psEffect->position.z))
+			if (psEffect->birthTime <= graphicsTime)  // Don't process, if it doesn't exist yet
 			{
-				bucketAddTypeToList(RENDER_EFFECT, psEffect, viewMatrix);
+				if (!paused && !update(psEffect))
+				{
+					// Fill the gap with the last effect, which hasn't been processed yet.
+					if (i != pool.size() - 1)
+					{
+						*psEffect = pool.back();
+					}
+					pool.pop_back();
+					continue;
+				}
+
+				if (clipXY(psEffect->position.x, psEffect->position.z))
+				{
+					bucketAddTypeToList(RENDER_EFFECT, psEffect, viewMatrix);
+				}
 			}
-		}
 
-		++it;
+			++i;
+		}
 	}
 
 	/* Add any structure effects */
 	effectStructureUpdates();
 }
 
-/* The general update function for all effects - calls a specific one for each. Returns false if effect should be deleted. */
-static bool updateEffect(EFFECT *psEffect)
-{
-	/* What type of effect are we dealing with? */
-	switch (psEffect->group)
-	{
-		case EFFECT_EXPLOSION:
-			return updateExplosion(psEffect);
-
-		case EFFECT_WAYPOINT:
-			if (!gamePaused())
-			{
-				return updateWaypoint(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_CONSTRUCTION:
-			if (!gamePaused())
-			{
-				return updateConstruction(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_SMOKE:
-			if (!gamePaused())
-			{
-				return updatePolySmoke(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_GRAVITON:
-			if (!gamePaused())
-			{
-				return updateGraviton(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_BLOOD:
-			if (!gamePaused())
-			{
-				return updateBlood(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_DESTRUCTION:
-			if (!gamePaused())
-			{
-				return updateDestruction(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_FIRE:
-			if (!gamePaused())
-			{
-				return updateFire(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_SAT_LASER:
-			if (!gamePaused())
-			{
-				return updateSatLaser(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_FIREWORK:
-			if (!gamePaused())
-			{
-				return updateFirework(psEffect);
-			}
-
-			return true;
-
-		case EFFECT_FREED:
-			break;
-	}
-
-	debug(LOG_ERROR, "Weirdy class of effect passed to updateEffect");
-	abort();
-}
-
 // ----------------------------------------------------------------------------------------
 // ALL THE UPDATE FUNCTIONS
 // ----------------------------------------------------------------------------------------
@@ -2342,34 +2324,36 @@ bool writeFXData(const char *fileName)
 	int i = 0;
 	WzConfig ini(WzString::fromUtf8(fileName), WzConfig::ReadAndWrite);
 
-	for (auto iter = activeList.cbegin(); iter != activeList.end(); ++iter, i++)
-	{
-		EFFECT *it = *iter;
-		ini.beginGroup("effect_" + WzString::number(i));
-		ini.setValue("control", it->control);
-		ini.setValue("group", it->group);
-		ini.setValue("type", it->type);
-		ini.setValue("frameNumber", it->frameNumber);
-		ini.setValue("size", it->size);
-		ini.setValue("baseScale", it->baseScale);
-		ini.setValue("specific", it->specific);
-		ini.setVector3f("position", it->position);
-		ini.setVector3f("velocity", it->velocity);
-		ini.setVector3i("rotation", it->rotation);
-		ini.setVector3i("spin", it->spin);
-		ini.setValue("birthTime", it->birthTime);
-		ini.setValue("lastFrame", it->lastFrame);
-		ini.setValue("frameDelay", it->frameDelay);
-		ini.setValue("lifeSpan", it->lifeSpan);
-		ini.setValue("radius", it->radius);
-
-		if (it->imd)
+	for (auto const &pool : effectPools)
+	{
+		for (auto it = pool.cbegin(); it != pool.cend(); ++it, i++)
 		{
-			ini.setValue("imd_name", modelName(it->imd));
-		}
+			ini.beginGroup("effect_" + WzString::number(i));
+			ini.setValue("control", it->control);
+			ini.setValue("group", it->group);
+			ini.setValue("type", it->type);
+			ini.setValue("frameNumber", it->frameNumber);
+			ini.setValue("size", it->size);
+			ini.setValue("baseScale", it->baseScale);
+			ini.setValue("specific", it->specific);
+			ini.setVector3f("position", it->position);
+			ini.setVector3f("velocity", it->velocity);
+			ini.setVector3i("rotation", it->rotation);
+			ini.setVector3i("spin", it->spin);
+			ini.setValue("birthTime", it->birthTime);
+			ini.setValue("lastFrame", it->lastFrame);
+			ini.setValue("frameDelay", it->frameDelay);
+			ini.setValue("lifeSpan", it->lifeSpan);
+			ini.setValue("radius", it->radius);
+
+			if (it->imd)
+			{
+				ini.setValue("imd_name", modelName(it->imd));
+			}
 
-		// Move on to reading the next effect
-		ini.endGroup();
+			// Move on to reading the next effect
+			ini.endGroup();
+		}
 	}
 
 	// Everything is just fine!
@@ -2388,10 +2372,18 @@ bool readFXData(const char *fileName)
 	for (int i = 0; i < list.size(); ++i)
 	{
 		ini.beginGroup(list[i]);
-		EFFECT *curEffect = new EFFECT();
+		EFFECT_GROUP group = (EFFECT_GROUP)ini.value("group").toInt();
+		EFFECT *curEffect = allocEffect(group, true);
+
+		if (curEffect == nullptr)
+		{
+			debug(LOG_WARNING, "Skipping %s, no room for effects of group %d", list[i].toUtf8().c_str(), (int)group);
+			ini.endGroup();
+			continue;
+		}
 
 		curEffect->control      = ini.value("control").toInt();
-		curEffect->group        = (EFFECT_GROUP)ini.value("group").toInt();
+		curEffect->group        = group;
 		curEffect->type         = (EFFECT_TYPE)ini.value("type").toInt();
 		curEffect->frameNumber  = ini.value("frameNumber").toInt();
 		curEffect->size         = ini.value("size").toInt();
@@ -2423,8 +2415,6 @@ bool readFXData(const char *fileName)
 
 		// Move on to reading the next effect
 		ini.endGroup();
-
-		activeList.push_back(curEffect);
 	}
 
 	/* Hopefully everything's just fine by now */
@@ -49,6 +49,7 @@
 #include "mapgrid.h"
 #include "display3d.h"
 #include "random.h"
+#include "astar.h"
 
 /* The statistics for the features */
 FEATURE_STATS	*asFeatureStats;
@@ -303,6 +304,8 @@ FEATURE *buildFeature(FEATURE_STATS *psStats, UDWORD x, UDWORD y, bool FromSave)
 		}
 	}
 
+	fpathMarkBlockingChanged(b);
+
 	psFeature->pos.z = map_TileHeight(b.map.x, b.map.y);//jps 18july97
 
 	return psFeature;
@@ -385,6 +388,8 @@ bool removeFeature(FEATURE *psDel)
 		}
 	}
 
+	fpathMarkBlockingChanged(b);
+
 	if (psDel->psStats->subType == FEAT_GEN_ARTE || psDel->psStats->subType == FEAT_OIL_DRUM)
 	{
 		pos.x = psDel->pos.x;
@@ -518,6 +523,8 @@ bool destroyFeature(FEATURE *psDel, unsigned impactTime)
 				}
 			}
 		}
+
+		fpathMarkBlockingChanged(b);
 	}
 
 	removeFeature(psDel);
@@ -37,6 +37,8 @@
 #include "map.h"
 #include "multiplay.h"
 #include "astar.h"
+#include "benchmark.h"
+#include "warzoneconfig.h"
 
 #include "fpath.h"
 
@@ -56,53 +58,96 @@ struct PATHRESULT
 
 
 // threading stuff
-static WZ_THREAD        *fpathThread = nullptr;
-static WZ_MUTEX         *fpathMutex = nullptr;
-static WZ_SEMAPHORE     *fpathSemaphore = nullptr;
 using packagedPathJob = wz::packaged_task<PATHRESULT()>;
-static std::list<packagedPathJob>    pathJobs;
+
+/// Jobs waiting to be processed using one context set. Processed in order, by one thread at a time.
+struct PATHJOBQUEUE
+{
+	std::list<packagedPathJob> jobs;
+};
+
+/// A path-finding thread, which processes the job queues of every context set where set % fpathNumWorkers == index.
+struct PATHWORKER
+{
+	unsigned        index = 0;
+	unsigned        nextSet = 0;          ///< Context set to look at first, so that no set starves.
+	unsigned        pendingJobs = 0;      ///< Total jobs queued for this worker. Guarded by fpathMutex.
+	WZ_THREAD       *thread = nullptr;
+	WZ_SEMAPHORE    *semaphore = nullptr;
+};
+
+static WZ_MUTEX         *fpathMutex = nullptr;
+static PATHJOBQUEUE     pathJobQueues[FPATH_CONTEXT_SETS];
+static PATHWORKER       pathWorkers[FPATH_CONTEXT_SETS];
+static unsigned         fpathNumWorkers = 0;
 static std::unordered_map<uint32_t, wz::future<PATHRESULT>> pathResults;
 
-static bool             waitingForResult = false;
-static uint32_t         waitingForResultId;
-static WZ_SEMAPHORE     *waitingForResultSemaphore = nullptr;
+static PATHRESULT fpathExecute(PATHJOB psJob, unsigned contextSet);
 
-static PATHRESULT fpathExecute(PATHJOB psJob);
 
+/// Returns the context set after set, out of the sets processed by worker.
+static unsigned fpathNextWorkerSet(PATHWORKER const &worker, unsigned set)
+{
+	set += fpathNumWorkers;
+	return set < FPATH_CONTEXT_SETS ? set : worker.index;
+}
 
 /** This runs in a separate thread */
-static int fpathThreadFunc(void *)
+static int fpathThreadFunc(void *data)
 {
+	PATHWORKER &worker = *static_cast<PATHWORKER *>(data);
+
 	wzMutexLock(fpathMutex);
 
 	while (!fpathQuit)
 	{
-		if (pathJobs.empty())
+		if (worker.pendingJobs == 0)
 		{
-			ASSERT(!waitingForResult, "Waiting for a result (id %u) that doesn't exist.", waitingForResultId);
 			wzMutexUnlock(fpathMutex);
-			wzSemaphoreWait(fpathSemaphore);  // Go to sleep until needed.
+			wzSemaphoreWait(worker.semaphore);  // Go to sleep until needed.
 			wzMutexLock(fpathMutex);
 			continue;
 		}
 
+		// Find the next context set with work to do.
+		unsigned set = worker.nextSet;
+		while (pathJobQueues[set].jobs.empty())
+		{
+			set = fpathNextWorkerSet(worker, set);
+		}
+		worker.nextSet = fpathNextWorkerSet(worker, set);
+
 		// Copy the first job from the queue.
-		packagedPathJob job = std::move(pathJobs.front());
-		pathJobs.pop_front();
+		packagedPathJob job = std::move(pathJobQueues[set].jobs.front());
+		pathJobQueues[set].jobs.pop_front();
+		--worker.pendingJobs;
 
 		wzMutexUnlock(fpathMutex);
 		job();
 		wzMutexLock(fpathMutex);
-
-		waitingForResult = false;
-		objTrace(waitingForResultId, "These are the droids you are looking for.");
-		wzSemaphorePost(waitingForResultSemaphore);
 	}
 
 	wzMutexUnlock(fpathMutex);
 	return 0;
 }
 
+/// Returns the context set to use for a job. Jobs to the same destination share a set, so that they can reuse cached contexts.
+static unsigned fpathJobContextSet(PATHJOB const &job)
+{
+	uint32_t tileX = map_coord(job.destX), tileY = map_coord(job.destY);
+	return (tileX * 0x9E3779B1u ^ tileY * 0x85EBCA77u) >> 16 & (FPATH_CONTEXT_SETS - 1);
+}
+
+static unsigned fpathWantedWorkers()
+{
+	int numWorkers = war_GetPathfindingThreads();
+	if (numWorkers <= 0)
+	{
+		numWorkers = wzGetCPUCount() - 1;  // Leave a core for the main thread.
+	}
+	return clip(numWorkers, 1, FPATH_CONTEXT_SETS);
+}
+
 
 // initialise the findpath module
 bool fpathInitialise()
@@ -110,13 +155,25 @@ bool fpathInitialise()
 	// The path system is up
 	fpathQuit = false;
 
-	if (!fpathThread)
+	if (fpathNumWorkers == 0)
 	{
 		fpathMutex = wzMutexCreate();
-		fpathSemaphore = wzSemaphoreCreate(0);
-		waitingForResultSemaphore = wzSemaphoreCreate(0);
-		fpathThread = wzThreadCreate(fpathThreadFunc, nullptr);
-		wzThreadStart(fpathThread);
+		fpathNumWorkers = fpathWantedWorkers();
+		for (unsigned i = 0; i < fpathNumWorkers; ++i)
+		{
+			PATHWORKER &worker = pathWorkers[i];
+			worker.index = i;
+			worker.nextSet = i;
+			worker.pendingJobs = 0;
+			for (unsigned set = i; set < FPATH_CONTEXT_SETS; set += fpathNumWorkers)
+			{
+				worker.pendingJobs += pathJobQueues[set].jobs.size();  // Jobs left over from before the last shutdown.
+			}
+			worker.semaphore = wzSemaphoreCreate(0);
+			worker.thread = wzThreadCreate(fpathThreadFunc, &worker);
+			wzThreadStart(worker.thread);
+		}
+		debug(LOG_INFO, "Using %u path-finding threads", fpathNumWorkers);
 	}
 
 	return true;
@@ -125,20 +182,26 @@ bool fpathInitialise()
 
 void fpathShutdown()
 {
-	if (fpathThread)
+	if (fpathNumWorkers != 0)
 	{
-		// Signal the path finding thread to quit
+		// Signal the path finding threads to quit
 		fpathQuit = true;
-		wzSemaphorePost(fpathSemaphore);  // Wake up thread.
+		for (unsigned i = 0; i < fpathNumWorkers; ++i)
+		{
+			wzSemaphorePost(pathWorkers[i].semaphore);  // Wake up thread.
+		}
 
-		wzThreadJoin(fpathThread);
-		fpathThread = nullptr;
+		for (unsigned i = 0; i < fpathNumWorkers; ++i)
+		{
+			PATHWORKER &worker = pathWorkers[i];
+			wzThreadJoin(worker.thread);
+			worker.thread = nullptr;
+			wzSemaphoreDestroy(worker.semaphore);
+			worker.semaphore = nullptr;
+		}
+		fpathNumWorkers = 0;
 		wzMutexDestroy(fpathMutex);
 		fpathMutex = nullptr;
-		wzSemaphoreDestroy(fpathSemaphore);
-		fpathSemaphore = nullptr;
-		wzSemaphoreDestroy(waitingForResultSemaphore);
-		waitingForResultSemaphore = nullptr;
 	}
 
 	fpathHardTableReset();
@@ -232,6 +295,24 @@ static uint8_t prop2bits(PROPULSION_TYPE propulsion)
 }
 
 // Check if the map tile at a location blocks a droid
+/// Aux map bits which block a route of the given type, if the propulsion can be blocked by structures.
+static uint8_t fpathAuxMask(FPATH_MOVETYPE moveType)
+{
+	switch (moveType)
+	{
+		case FMT_MOVE:
+			return AUXBITS_NONPASSABLE;    // do not wish to shoot our way through enemy buildings, but want to go through friendly gates (without shooting them)
+
+		case FMT_ATTACK:
+			return AUXBITS_OUR_BUILDING;   // move blocked by friendly building, assuming we do not want to shoot it up en route
+
+		case FMT_BLOCK:
+			return AUXBITS_BLOCKING;       // Do not wish to tunnel through closed gates or buildings.
+	}
+
+	return 0;
+}
+
 bool fpathBaseBlockingTile(SDWORD x, SDWORD y, PROPULSION_TYPE propulsion, int mapIndex, FPATH_MOVETYPE moveType)
 {
 	/* All tiles outside of the map and on map border are blocking. */
@@ -248,33 +329,49 @@ bool fpathBaseBlockingTile(SDWORD x, SDWORD y, PROPULSION_TYPE propulsion, int m
 	}
 
 	unsigned aux = auxTile(x, y, mapIndex);
+	unsigned auxMask = fpathAuxMask(moveType);
+	unsigned unitbits = prop2bits(propulsion);  // TODO - cache prop2bits to psDroid, and pass in instead of propulsion type
 
-	int auxMask = 0;
-
-	switch (moveType)
+	if ((unitbits & FEATURE_BLOCKED) != 0 && (aux & auxMask) != 0)
 	{
-		case FMT_MOVE:
-			auxMask = AUXBITS_NONPASSABLE;
-			break;   // do not wish to shoot our way through enemy buildings, but want to go through friendly gates (without shooting them)
+		return true;	// move blocked by building, and we cannot or do not want to shoot our way through anything
+	}
 
-		case FMT_ATTACK:
-			auxMask = AUXBITS_OUR_BUILDING;
-			break;  // move blocked by friendly building, assuming we do not want to shoot it up en route
+	// the MAX hack below is because blockTile() range does not include player-specific versions...
+	return (blockTile(x, y, MAX(0, mapIndex - MAX_PLAYERS)) & unitbits) != 0;  // finally check if move is blocked by propulsion related factors
+}
 
-		case FMT_BLOCK:
-			auxMask = AUXBITS_BLOCKING;
-			break;      // Do not wish to tunnel through closed gates or buildings.
+void fpathBaseBlockingRow(SDWORD y, PROPULSION_TYPE propulsion, int mapIndex, FPATH_MOVETYPE moveType, uint8_t *blocked)
+{
+	// Same tests as fpathBaseBlockingTile, but with everything which doesn't depend on x done once per row.
+	int xMin = 1, xMax = mapWidth - 1;  // Inclusive.
+
+	if (propulsion != PROPULSION_TYPE_LIFT)
+	{
+		xMin = MAX(xMin, scrollMinX + 1);
+		xMax = MIN(xMax, scrollMaxX - 2);
 	}
 
-	unsigned unitbits = prop2bits(propulsion);  // TODO - cache prop2bits to psDroid, and pass in instead of propulsion type
+	if (y < 1 || y > mapHeight - 1 || (propulsion != PROPULSION_TYPE_LIFT && (y < scrollMinY + 1 || y >= scrollMaxY - 1)) || xMin > xMax)
+	{
+		memset(blocked, 1, mapWidth);
+		return;
+	}
 
-	if ((unitbits & FEATURE_BLOCKED) != 0 && (aux & auxMask) != 0)
+	const uint8_t unitbits = prop2bits(propulsion);
+	const uint8_t auxMask = (unitbits & FEATURE_BLOCKED) != 0 ? fpathAuxMask(moveType) : 0;
+	const uint8_t *aux = &psAuxMap[mapIndex][y * mapWidth];
+	const uint8_t *block = &psBlockMap[MAX(0, mapIndex - MAX_PLAYERS)][y * mapWidth];
+
+	memset(blocked, 1, xMin);
+
+	// No branches, so that the compiler can vectorise this.
+	for (int x = xMin; x <= xMax; ++x)
 	{
-		return true;	// move blocked by building, and we cannot or do not want to shoot our way through anything
+		blocked[x] = ((aux[x] & auxMask) | (block[x] & unitbits)) != 0;
 	}
 
-	// the MAX hack below is because blockTile() range does not include player-specific versions...
-	return (blockTile(x, y, MAX(0, mapIndex - MAX_PLAYERS)) & unitbits) != 0;  // finally check if move is blocked by propulsion related factors
+	memset(blocked + xMax + 1, 1, mapWidth - xMax - 1);
 }
 
 bool fpathDroidBlockingTile(DROID *psDroid, int x, int y, FPATH_MOVETYPE moveType)
@@ -422,24 +519,37 @@ queuePathfinding:
 	// job or result for each droid in the system at any time.
 	fpathRemoveDroidData(id);
 
-	packagedPathJob task([job]()
+	// The context set depends only on the job, so each set sees the same jobs in the same order, no matter how many threads there are.
+	unsigned set = fpathJobContextSet(job);
+	packagedPathJob task([job, set]()
 	{
-		return fpathExecute(job);
+		return fpathExecute(job, set);
 	});
 	pathResults[id] = task.get_future();
 
-	// Add to end of list
-	wzMutexLock(fpathMutex);
-	bool isFirstJob = pathJobs.empty();
-	pathJobs.push_back(std::move(task));
-	wzMutexUnlock(fpathMutex);
-
-	if (isFirstJob)
+	bool isFirstJob = true;
+	if (fpathNumWorkers == 0)
 	{
-		wzSemaphorePost(fpathSemaphore);  // Wake up processing thread.
+		// No threads before fpathInitialise or after fpathShutdown, so find the route now. The result is collected as usual.
+		task();
+	}
+	else
+	{
+		// Add to end of list
+		PATHWORKER &worker = pathWorkers[set % fpathNumWorkers];
+		wzMutexLock(fpathMutex);
+		isFirstJob = worker.pendingJobs == 0;
+		pathJobQueues[set].jobs.push_back(std::move(task));
+		++worker.pendingJobs;
+		wzMutexUnlock(fpathMutex);
+
+		if (isFirstJob)
+		{
+			wzSemaphorePost(worker.semaphore);  // Wake up processing thread.
+		}
 	}
 
-	objTrace(id, "Queued up a path-finding request to (%d, %d), at least %d items earlier in queue", tX, tY, isFirstJob);
+	objTrace(id, "Queued up a path-finding request to (%d, %d) in set %u, at least %d items earlier in queue", tX, tY, set, isFirstJob);
 	syncDebug("fpathRoute(..., %d, %d, %d, %d, %d, %d, %d, %d, %d) = FPR_WAIT", id, startX, startY, tX, tY, propulsionType, droidType, moveType, owner);
 	return FPR_WAIT;	// wait while polling result queue
 }
@@ -448,6 +558,7 @@ queuePathfinding:
 // Find a route for an DROID to a location in world coordinates
 FPATH_RETVAL fpathDroidRoute(DROID *psDroid, SDWORD tX, SDWORD tY, FPATH_MOVETYPE moveType)
 {
+	BenchmarkPhase phase(BENCH_PATHING);
 	bool acceptNearest;
 	PROPULSION_STATS *psPropStats = getPropulsionStats(psDroid);
 
@@ -495,15 +606,15 @@ FPATH_RETVAL fpathDroidRoute(DROID *psDroid, SDWORD tX, SDWORD tY, FPATH_MOVETYP
 	                  psDroid->droidType, moveType, psDroid->player, acceptNearest, dstStructure);
 }
 
-// Run only from path thread
-PATHRESULT fpathExecute(PATHJOB job)
+// Run only from path threads
+PATHRESULT fpathExecute(PATHJOB job, unsigned contextSet)
 {
 	PATHRESULT result;
 	result.droidID = job.droidID;
 	result.retval = FPR_FAILED;
 	result.originalDest = Vector2i(job.destX, job.destY);
 
-	ASR_RETVAL retval = fpathAStarRoute(&result.sMove, &job);
+	ASR_RETVAL retval = fpathAStarRoute(&result.sMove, &job, contextSet);
 
 	ASSERT(retval != ASR_OK || result.sMove.asPath.size() > 0, "Ok result but no path in result");
 
@@ -555,7 +666,10 @@ static int fpathJobQueueLength()
 	int count = 0;
 
 	wzMutexLock(fpathMutex);
-	count = pathJobs.size();  // O(N) function call for std::list. .empty() is faster, but this function isn't used except in tests.
+	for (unsigned i = 0; i < fpathNumWorkers; ++i)
+	{
+		count += pathWorkers[i].pendingJobs;
+	}
 	wzMutexUnlock(fpathMutex);
 	return count;
 }
@@ -567,7 +681,7 @@ static int fpathResultQueueLength()
 	int count = 0;
 
 	wzMutexLock(fpathMutex);
-	count = pathResults.size();  // O(N) function call for std::list. .empty() is faster, but this function isn't used except in tests.
+	count = pathResults.size();
 	wzMutexUnlock(fpathMutex);
 	return count;
 }
@@ -589,10 +703,9 @@ void fpathTest(int x, int y, int x2, int y2)
 	(void)fpathJobQueueLength();
 
 	/* Check initial state */
-	assert(fpathThread != nullptr);
 	assert(fpathMutex != nullptr);
-	assert(fpathSemaphore != nullptr);
-	assert(pathJobs.empty());
+	assert(fpathNumWorkers == 0 || pathWorkers[0].semaphore != nullptr);
+	assert(fpathJobQueueLength() == 0);
 	assert(pathResults.empty());
 	fpathRemoveDroidData(0);	// should not crash
 
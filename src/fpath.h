@@ -43,6 +43,7 @@ enum FPATH_MOVETYPE
 };
 
 struct PathBlockingMap;
+struct PathClusterMap;
 
 struct PATHJOB
 {
@@ -55,6 +56,7 @@ struct PATHJOB
 	FPATH_MOVETYPE	moveType;
 	int		owner;		///< Player owner
 	std::shared_ptr<PathBlockingMap> blockingMap;   ///< Map of blocking tiles.
+	std::shared_ptr<PathClusterMap const> clusterMap;  ///< Cluster abstraction of blockingMap, only set for long routes.
 	bool		acceptNearest;
 	bool            deleted;        ///< Droid was deleted, so throw away result when complete. Must still process this PATHJOB, since processing order can affect resulting paths (but can't affect the path length).
 };
@@ -97,6 +99,8 @@ bool fpathIsEquivalentBlocking(PROPULSION_TYPE propulsion1, int player1, FPATH_M
 bool fpathBlockingTile(SDWORD x, SDWORD y, PROPULSION_TYPE propulsion);
 bool fpathDroidBlockingTile(DROID *psDroid, int x, int y, FPATH_MOVETYPE moveType);
 bool fpathBaseBlockingTile(SDWORD x, SDWORD y, PROPULSION_TYPE propulsion, int player, FPATH_MOVETYPE moveType);
+/// Sets blocked[x] to fpathBaseBlockingTile(x, y, ...) for each x in row y of the map, much faster than calling it for each tile.
+void fpathBaseBlockingRow(SDWORD y, PROPULSION_TYPE propulsion, int player, FPATH_MOVETYPE moveType, uint8_t *blocked);
 
 static inline bool fpathBlockingTile(Vector2i tile, PROPULSION_TYPE propulsion)
 {
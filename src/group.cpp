@@ -31,6 +31,7 @@
 #include "group.h"
 #include "droid.h"
 #include "order.h"
+#include "objmem.h"
 #include <map>
 
 // Group system variables: grpGlobalManager enables to remove all the groups to Shutdown the system
@@ -155,6 +156,12 @@ void DROID_GROUP::add(DROID *psDroid)
 			psList = psDroid;
 		}
 
+		if (type == GT_TRANSPORTER)
+		{
+			// Transporter cargo is indexed through the group list
+			objIdIndexInvalidate();
+		}
+
 		if (type == GT_COMMAND)
 		{
 			syncDebug("Droid %d joining command group %d", psDroid->id, psCommander != nullptr ? psCommander->id : 0);
@@ -181,6 +188,12 @@ void DROID_GROUP::remove(DROID *psDroid)
 		syncDebug("Droid %d leaving command group %d", psDroid->id, psCommander != nullptr ? psCommander->id : 0);
 	}
 
+	if (psDroid != nullptr && type == GT_TRANSPORTER)
+	{
+		// Transporter cargo is indexed through the group list
+		objIdIndexInvalidate();
+	}
+
 	refCount -= 1;
 
 	// if psDroid == NULL just decrease the refcount don't remove anything from the list
@@ -1079,6 +1079,7 @@ bool stageOneShutDown()
 
 	scrShutDown();
 	gridShutDown();
+	visShutdown();
 
 	debug(LOG_TEXTURE, "== stageOneShutDown ==");
 	modelShutdown();
@@ -45,6 +45,7 @@
 #include "lib/netplay/netplay.h"
 
 #include "loop.h"
+#include "benchmark.h"
 #include "objects.h"
 #include "display.h"
 #include "map.h"
@@ -454,6 +455,8 @@ int getBuildingId(STRUCTURE *ptr)
 
 void gameStatePreUpdate()
 {
+	benchmarkUpdateStart();
+
   syncDebug("map = \"%s\", pseudorandom 32-bit integer = 0x%08X, allocated = %d %d %d %d %d %d %d %d %d %d, position = %d %d %d %d %d %d %d %d %d %d", game.map, gameRandU32(), NetPlay.players[0].allocated, NetPlay.players[1].allocated, NetPlay.players[2].allocated, NetPlay.players[3].allocated, NetPlay.players[4].allocated, NetPlay.players[5].allocated, NetPlay.players[6].allocated, NetPlay.players[7].allocated, NetPlay.players[8].allocated, NetPlay.players[9].allocated, NetPlay.players[0].position, NetPlay.players[1].position, NetPlay.players[2].position, NetPlay.players[3].position, NetPlay.players[4].position, NetPlay.players[5].position, NetPlay.players[6].position, NetPlay.players[7].position, NetPlay.players[8].position, NetPlay.players[9].position);
 
 	for (unsigned n = 0; n < MAX_PLAYERS; ++n)
@@ -474,6 +477,8 @@ void gameStatePreUpdate()
 	NETflush();  // Make sure the game time tick message is really sent over the network.
 
 	if (!paused && !scriptPaused()) {
+    BenchmarkPhase phase(BENCH_SCRIPTS);
+
     /* Update the event system */
     if (!bInTutorial) {
       eventProcessTriggers(gameTime / SCR_TICKRATE);
@@ -484,13 +489,17 @@ void gameStatePreUpdate()
     updateScripts();
   }
 
-	// Update the visibility change stuff
-	visUpdateLevel();
-  // Put all droids/structures/features into the grid.
-	gridReset();
+	{
+		BenchmarkPhase phase(BENCH_VISIBILITY);
+
+		// Update the visibility change stuff
+		visUpdateLevel();
+		// Put all droids/structures/features into the grid.
+		gridReset();
 
-	// Check which objects are visible.
-	processVisibility();
+		// Check which objects are visible.
+		processVisibility();
+	}
 
 	// Update the map.
 	mapUpdate();
@@ -498,6 +507,7 @@ void gameStatePreUpdate()
 	// update the command droids
 	cmdDroidUpdate();
 
+	BenchmarkPhase phase(BENCH_SCRIPTS);
 	fireWaitingCallbacks(); //Now is the good time to fire waiting callbacks (since interpreter is off now)
 }
 
@@ -505,7 +515,10 @@ void gameStatePostUpdate()
 {
 	missionTimerUpdate();
 
-	proj_UpdateAll();
+	{
+		BenchmarkPhase phase(BENCH_PROJECTILES);
+		proj_UpdateAll();
+	}
 
 	FEATURE *psNFeat;
 
@@ -519,7 +532,12 @@ void gameStatePostUpdate()
 	hciUpdate();
 
 	// Free dead droid memory.
-	objmemUpdate();
+	{
+		BenchmarkPhase phase(BENCH_OBJMEM);
+		objmemUpdate();
+	}
+
+	benchmarkUpdateEnd();  // Before gameTimeUpdateEnd, which forgets whether this was a tick.
 
 	// Must end update, since we may or may not have ticked, and some message queue processing code may vary depending on whether it's in an update.
 	gameTimeUpdateEnd();
@@ -752,3 +770,81 @@ bool isLasSat(STRUCTURE *psCurr)
 {
   return asWeaponStats[psCurr->asWeaps[0].nStat].weaponSubClass == WSC_LAS_SAT;
 }
+
+static void snapshotObject(OBJECT_SNAPSHOT *snapshot, int capacity, int &count, BASE_OBJECT *psObj, int list, int carrier)
+{
+	if (count < capacity)
+	{
+		OBJECT_SNAPSHOT &record = snapshot[count];
+		record.pointer = psObj;
+		record.id = psObj->id;
+		record.objType = psObj->type;
+		record.player = psObj->player;
+		record.list = list;
+		record.carrier = carrier;
+		record.flags = 0;
+
+		if (psObj->type == OBJ_DROID)
+		{
+			record.type = castDroid(psObj)->droidType;
+			record.status = 0;
+		}
+		else
+		{
+			STRUCTURE *psStruct = castStructure(psObj);
+			record.type = psStruct->pStructureType->type;
+			record.status = psStruct->status;
+			record.flags |= isLasSat(psStruct) ? OBJECT_SNAPSHOT_LASSAT : 0;
+		}
+	}
+
+	++count;
+}
+
+int getObjectSnapshot(OBJECT_SNAPSHOT *snapshot, int capacity)
+{
+	int count = 0;
+
+	for (int list = 1; list <= 3; ++list)
+	{
+		for (int player = 0; player < MAX_PLAYERS; ++player)
+		{
+			DROID *psList = list == 1 ? apsDroidLists[player] : list == 2 ? mission.apsDroidLists[player] : apsLimboDroids[player];
+
+			for (DROID *psDroid = psList; psDroid != nullptr; psDroid = psDroid->psNext)
+			{
+				const int index = count;
+				snapshotObject(snapshot, capacity, count, psDroid, list, -1);
+
+				if (isTransporter(psDroid) && psDroid->psGroup != nullptr)
+				{
+					// Same walk as getDroidGroup().
+					for (DROID *psCargo = psDroid->psGroup->psList; psCargo != nullptr; psCargo = psCargo->psNext)
+					{
+						snapshotObject(snapshot, capacity, count, psCargo, list, index);
+					}
+				}
+			}
+		}
+	}
+
+	for (int list = 1; list <= 2; ++list)
+	{
+		for (int player = 0; player < MAX_PLAYERS; ++player)
+		{
+			STRUCTURE *psList = list == 1 ? apsStructLists[player] : mission.apsStructLists[player];
+
+			for (STRUCTURE *psStruct = psList; psStruct != nullptr; psStruct = psStruct->psNext)
+			{
+				snapshotObject(snapshot, capacity, count, psStruct, list, -1);
+			}
+		}
+	}
+
+	return count;
+}
+
+int getObjectSnapshotSize()
+{
+	return sizeof(OBJECT_SNAPSHOT);
+}
@@ -102,4 +102,28 @@ int getBuildingId(STRUCTURE *ptr) asm ("getBuildingId");
 int getBuildingType(STRUCTURE *ptr) asm ("getBuildingType");
 int getBuildingStatus(STRUCTURE *ptr) asm ("getBuildingStatus");
 bool isLasSat(STRUCTURE *psCurr) asm ("isLasSat");
+
+#define OBJECT_SNAPSHOT_LASSAT  0x01    ///< The structure is a laser satellite command post, see isLasSat()
+
+/// What the OCaml game loop needs to know about an object each tick, see getObjectSnapshot().
+/// The layout is mirrored by src/ocaml/bindings.ml.
+struct OBJECT_SNAPSHOT
+{
+	void *pointer;
+	int32_t id;
+	int32_t objType;        ///< OBJ_DROID or OBJ_STRUCTURE
+	int32_t type;           ///< DROID_TYPE or STRUCTURE_TYPE
+	int32_t status;         ///< STRUCT_STATES, or 0 for droids
+	int32_t player;
+	int32_t list;           ///< Which list the object is in, numbered as for getDroidList() and getBuildingList()
+	int32_t carrier;        ///< Index of the record of the transporter this droid is listed under, or -1
+	int32_t flags;          ///< OBJECT_SNAPSHOT_* bits
+};
+
+/// Fills snapshot with up to capacity records, and returns how many there are in total, so the caller can retry with
+/// a bigger array if needed. Lists droids (main, mission, then limbo lists) and then structures (main, then mission
+/// lists), player by player, each list in order. Transporters are followed by the droids getDroidGroup() would give.
+int getObjectSnapshot(OBJECT_SNAPSHOT *snapshot, int capacity) asm ("getObjectSnapshot");
+/// Returns sizeof(OBJECT_SNAPSHOT), so the OCaml mirror can check its layout at startup.
+int getObjectSnapshotSize() asm ("getObjectSnapshotSize");
 #endif // __INCLUDED_SRC_LOOP_H__
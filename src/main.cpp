@@ -44,6 +44,7 @@
 #include "lib/sound/audio.h"
 #include "lib/sound/cdaudio.h"
 
+#include "benchmark.h"
 #include "challenge.h"
 #include "configuration.h"
 #include "display.h"
@@ -58,6 +59,7 @@
 #include "mission.h"
 #include "modding.h"
 #include "multiplay.h"
+#include "multireplay.h"
 #include "qtscript.h"
 #include "research.h"
 #include "scripttabs.h"
@@ -110,6 +112,8 @@ void setRunning(bool value)
 static bool wz_autogame = false;
 static std::string wz_saveandquit;
 static std::string wz_test;
+static std::string wz_replay;
+static bool wz_replay_fast = false;
 
 void setConfigdir(char *arg)
 {
@@ -133,6 +137,24 @@ void setDebugfile(char *arg)
   customDebugfile = true;
 }
 
+void setReplay(char *arg)
+{
+	wz_replay = arg;
+}
+
+void setReplayFast(char *arg)
+{
+	wz_replay = arg;
+	wz_replay_fast = true;
+}
+
+void setSkirmish(char *arg)
+{
+	wz_test = arg;
+	hostlaunch = 2;
+	wz_autogame = true;  // The lobby only applies the settings file and starts the game by itself when autogaming.
+}
+
 void autogame()
 {
   wz_autogame = true;
@@ -153,6 +175,16 @@ const std::string &wz_skirmish_test()
 	return wz_test;
 }
 
+const std::string &replay_enabled()
+{
+	return wz_replay;
+}
+
+bool replay_fastforward()
+{
+	return wz_replay_fast;
+}
+
 // Retrieves the appropriate storage directory for application-created files / prefs
 // (Ensures the directory exists. Creates folders if necessary.)
 static std::string getPlatformPrefDir(const char * org, const std::string &app)
@@ -339,6 +371,8 @@ void startGameLoop()
 {
   setRunning(true);
 
+	replayStartRecording();  // Before loading, since replays start from the settings the level is loaded with.
+
 	// Not sure what aLevelName is, in relation to game.map. But need to use aLevelName here, to be able to start the right map for campaign, and need game.hash, to start the right non-campaign map, if there are multiple identically named maps.
 	if (!levLoadData(aLevelName, &game.hash, nullptr, GTYPE_SCENARIO_START))
 	{
@@ -346,6 +380,9 @@ void startGameLoop()
 		exit(EXIT_FAILURE);
 	}
 
+	replayGameLoaded();
+	benchmarkGameLoaded();
+
 	screen_StopBackDrop();
 
 	// Trap the cursor if cursor snapping is enabled
@@ -384,6 +421,7 @@ void startGameLoop()
  */
 void stopGameLoop()
 {
+	replayStop();
 	clearInfoMessages(); // clear CONPRINTF messages before each new game/mission
 
 	if (gameLoopStatus != GAMECODE_NEWLEVEL)
@@ -434,6 +472,7 @@ void initPhysFS()
 	PHYSFS_mkdir("mods/multiplay");	// multiplay only mods activated with --mod_mp=example.wz
 	PHYSFS_mkdir("mods/music");	// music mods that are automatically loaded
 	PHYSFS_mkdir("music");	// custom music overriding default music and music mods
+	PHYSFS_mkdir("replay");	// recorded skirmish and multiplayer games
 	PHYSFS_mkdir("savegames/campaign");		// campaign save games
 	PHYSFS_mkdir("savegames/skirmish");		// skirmish save games
 	PHYSFS_mkdir("tests");			// test games launched with --skirmish=game
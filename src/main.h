@@ -54,9 +54,14 @@ void setConfigdir(char *arg) asm ("setConfigdir");
 void setDatadir(char *arg) asm ("setDatadir");
 void setDebug(char *arg) asm ("setDebug");
 void setDebugfile(char *arg) asm ("setDebugfile");
+void setReplay(char *arg) asm ("setReplay");
+void setReplayFast(char *arg) asm ("setReplayFast");
+void setSkirmish(char *arg) asm ("setSkirmish");
 
 bool autogame_enabled();
 const std::string &saveandquit_enabled();
 const std::string &wz_skirmish_test();
+const std::string &replay_enabled();
+bool replay_fastforward();
 
 #endif // __INCLUDED_SRC_MAIN_H__
@@ -24,6 +24,7 @@
  *
  */
 #include <time.h>
+#include <algorithm>
 
 #include "lib/framework/frame.h"
 #include "lib/framework/endian_hack.h"
@@ -65,6 +66,7 @@ static struct floodtile *floodbucket = nullptr;
 static int bucketcounter;
 static UDWORD lastDangerUpdate = 0;
 static int lastDangerPlayer = -1;
+static FIRE_WHEEL fireWheel;
 
 //scroll min and max values
 SDWORD		scrollMinX, scrollMaxX, scrollMinY, scrollMaxY;
@@ -107,6 +109,7 @@ SDWORD	mapWidth = 0, mapHeight = 0;
 MAPTILE	*psMapTiles = nullptr;
 uint8_t *psBlockMap[AUX_MAX];
 uint8_t *psAuxMap[MAX_PLAYERS + AUX_MAX];        // yes, we waste one element... eyes wide open... makes API nicer
+uint8_t *psVisionMap[VISMAP_MAX * MAX_PLAYERS];
 
 #define WATER_MIN_DEPTH 500
 #define WATER_MAX_DEPTH (WATER_MIN_DEPTH + 400)
@@ -788,6 +791,8 @@ bool mapLoad(char *filename, bool preview)
 	PHYSFS_file	*fp = PHYSFS_openRead(filename);
 	MersenneTwister mt(12345);  // 12345 = random seed.
 
+	fpathResetBlockingMaps();  // The cached path-finding maps were for the old map.
+
 	if (!fp)
 	{
 		debug(LOG_ERROR, "%s not found", filename);
@@ -866,9 +871,8 @@ bool mapLoad(char *filename, bool preview)
 		psMapTiles[i].height = height * ELEVATION_SCALE;
 
 		// Visibility stuff
-		memset(psMapTiles[i].watchers, 0, sizeof(psMapTiles[i].watchers));
-		memset(psMapTiles[i].sensors, 0, sizeof(psMapTiles[i].sensors));
-		memset(psMapTiles[i].jammers, 0, sizeof(psMapTiles[i].jammers));
+		psMapTiles[i].watcherBits = 0;
+		psMapTiles[i].radarBits = 0;
 		psMapTiles[i].sensorBits = 0;
 		psMapTiles[i].jammerBits = 0;
 		psMapTiles[i].tileExploredBits = 0;
@@ -923,6 +927,12 @@ bool mapLoad(char *filename, bool preview)
 	scrollMaxX = mapWidth;
 	scrollMaxY = mapHeight;
 
+	/* No fires burning yet */
+	for (auto &bucket : fireWheel.buckets)
+	{
+		bucket.clear();
+	}
+
 	/* Allocate aux maps */
 	psBlockMap[AUX_MAP] = (uint8_t *)malloc(mapWidth * mapHeight * sizeof(*psBlockMap[0]));
 	psBlockMap[AUX_ASTARMAP] = (uint8_t *)malloc(mapWidth * mapHeight * sizeof(*psBlockMap[0]));
@@ -933,6 +943,11 @@ bool mapLoad(char *filename, bool preview)
 		psAuxMap[x] = (uint8_t *)malloc(mapWidth * mapHeight * sizeof(*psAuxMap[0]));
 	}
 
+	for (x = 0; x < VISMAP_MAX * MAX_PLAYERS; x++)
+	{
+		psVisionMap[x] = (uint8_t *)calloc(mapWidth * mapHeight, sizeof(*psVisionMap[0]));
+	}
+
 	// Set our blocking bits
 	for (y = 0; y < mapHeight; y++)
 	{
@@ -1104,6 +1119,17 @@ bool mapShutdown()
 		psAuxMap[x] = nullptr;
 	}
 
+	for (x = 0; x < VISMAP_MAX * MAX_PLAYERS; x++)
+	{
+		free(psVisionMap[x]);
+		psVisionMap[x] = nullptr;
+	}
+
+	for (auto &bucket : fireWheel.buckets)
+	{
+		bucket.clear();
+	}
+
 	map = nullptr;
 	floodbucket = nullptr;
 	psGroundTypes = nullptr;
@@ -1870,9 +1896,17 @@ void tileSetFire(int32_t x, int32_t y, uint32_t duration)
 	tile->tileInfoBits |= BITS_ON_FIRE;
 	tile->fireEndTime = fireEndTime;
 
+	BURNING_TILE burning = {uint16_t(posX), uint16_t(posY), fireEndTime};
+	fireWheel.buckets[fireEndTime % FIRE_WHEEL_SIZE].push_back(burning);
+
 	syncDebug("Fire tile{%d, %d} dur%u end%d", posX, posY, duration, fireEndTime);
 }
 
+FIRE_WHEEL &mapGetFireWheel()
+{
+	return fireWheel;
+}
+
 /** Check if tile contained within the given world coordinates is burning. */
 bool fireOnLocation(unsigned int x, unsigned int y)
 {
@@ -2105,21 +2139,51 @@ void mapInit()
 void mapUpdate()
 {
 	const uint16_t currentTime = gameTime / GAME_TICKS_PER_UPDATE;
-	int posX, posY;
+	std::vector<BURNING_TILE> &bucket = fireWheel.buckets[currentTime % FIRE_WHEEL_SIZE];
+	static std::vector<BURNING_TILE> extinguished;  // static to avoid allocations.
+	size_t numKept = 0;
 
-	for (posY = 0; posY < mapHeight; ++posY)
-		for (posX = 0; posX < mapWidth; ++posX)
+	extinguished.clear();
+
+	for (BURNING_TILE const &burning : bucket)
+	{
+		MAPTILE const *tile = mapTile(burning.x, burning.y);
+
+		if ((tile->tileInfoBits & BITS_ON_FIRE) == 0 || tile->fireEndTime != burning.endTime)
 		{
-			MAPTILE *const tile = mapTile(posX, posY);
+			continue;  // Already extinguished, or set on fire again since.
+		}
 
-			if ((tile->tileInfoBits & BITS_ON_FIRE) != 0 && tile->fireEndTime == currentTime)
-			{
-				// Extinguish, tile, extinguish!
-				tile->tileInfoBits &= ~BITS_ON_FIRE;
+		if (burning.endTime == currentTime)
+		{
+			extinguished.push_back(burning);
+		}
+		else
+		{
+			bucket[numKept++] = burning;  // Ends on a later turn of the wheel.
+		}
+	}
 
-				syncDebug("Extinguished tile{%d, %d}", posX, posY);
-			}
+	bucket.resize(numKept);
+
+	// Extinguish in map order, as the sync log used to show.
+	std::sort(extinguished.begin(), extinguished.end(), [](BURNING_TILE const &a, BURNING_TILE const &b)
+	{
+		return a.y < b.y || (a.y == b.y && a.x < b.x);
+	});
+
+	for (BURNING_TILE const &burning : extinguished)
+	{
+		MAPTILE *const tile = mapTile(burning.x, burning.y);
+
+		if ((tile->tileInfoBits & BITS_ON_FIRE) != 0)  // Might be listed twice.
+		{
+			// Extinguish, tile, extinguish!
+			tile->tileInfoBits &= ~BITS_ON_FIRE;
+
+			syncDebug("Extinguished tile{%d, %d}", burning.x, burning.y);
 		}
+	}
 
 	if (gameTime > lastDangerUpdate + GAME_TICKS_FOR_DANGER && game.type == SKIRMISH)
 	{
@@ -98,7 +98,8 @@ struct MAPTILE
 	PlayerMask              tileExploredBits;
 	PlayerMask              sensorBits;             ///< bit per player, who can see tile with sensor
 	uint8_t			illumination;	// How bright is this tile?
-	uint8_t			watchers[MAX_PLAYERS];		// player sees through fog of war here with this many objects
+	PlayerMask              watcherBits;            ///< bit per player, who has objects seeing this tile, see visionMap(VISMAP_WATCHERS, player)
+	PlayerMask              radarBits;              ///< bit per player, who has radar sensors covering this tile, see visionMap(VISMAP_SENSORS, player)
 	uint16_t		texture;		// Which graphics texture is on this tile
 	int32_t                 height;                 ///< The height at the top left of the tile
 	float                   level;                  ///< The visibility level of the top left of the tile, for this client.
@@ -110,8 +111,6 @@ struct MAPTILE
 	uint16_t                fireEndTime;            ///< The (uint16_t)(gameTime / GAME_TICKS_PER_UPDATE) that BITS_ON_FIRE should be cleared.
 	int32_t                 waterLevel;             ///< At what height is the water for this tile
 	PlayerMask		jammerBits;             ///< bit per player, who is jamming tile
-	uint8_t                 sensors[MAX_PLAYERS];   ///< player sees this tile with this many radar sensors
-	uint8_t                 jammers[MAX_PLAYERS];   ///< player jams the tile with this many objects
 };
 
 /* The size and contents of the map */
@@ -145,6 +144,20 @@ extern char *tilesetDir;
 extern uint8_t *psBlockMap[AUX_MAX];
 extern uint8_t *psAuxMap[MAX_PLAYERS + AUX_MAX];	// yes, we waste one element... eyes wide open... makes API nicer
 
+/* Vision counters, kept out of MAPTILE in one dense layer per player, since vision updates touch many tiles for one player at a time */
+#define VISMAP_WATCHERS	0	///< Player sees through fog of war here with this many objects
+#define VISMAP_SENSORS	1	///< Player sees this tile with this many radar sensors
+#define VISMAP_JAMMERS	2	///< Player jams the tile with this many objects
+#define VISMAP_MAX	3
+
+extern uint8_t *psVisionMap[VISMAP_MAX * MAX_PLAYERS];
+
+/// Find the vision counters of a given type for a player, indexed by x + y * mapWidth
+WZ_DECL_ALWAYS_INLINE static inline uint8_t *visionMap(int type, int player)
+{
+	return psVisionMap[type * MAX_PLAYERS + player];
+}
+
 /// Find aux bitfield for a given tile
 WZ_DECL_ALWAYS_INLINE static inline uint8_t auxTile(int x, int y, int player)
 {
@@ -560,6 +573,24 @@ void mapFloodFillContinents();
 
 void mapTest();
 
+/// A tile that was set on fire, and the fireEndTime it was given.
+struct BURNING_TILE
+{
+	uint16_t x, y;
+	uint16_t endTime;
+};
+
+#define FIRE_WHEEL_SIZE 64      ///< Fires lasting longer than this many updates are looked at more than once before ending.
+
+/// Burning tiles, bucketed by endTime % FIRE_WHEEL_SIZE, so that mapUpdate() only looks at tiles whose fire may end now.
+/// Entries are not removed when a tile is set on fire again, and are ignored if they no longer match the tile.
+struct FIRE_WHEEL
+{
+	std::vector<BURNING_TILE> buckets[FIRE_WHEEL_SIZE];
+};
+
+FIRE_WHEEL &mapGetFireWheel();
+
 void tileSetFire(int32_t x, int32_t y, uint32_t duration);
 bool fireOnLocation(unsigned int x, unsigned int y);
 
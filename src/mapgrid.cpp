@@ -20,39 +20,128 @@
 /*
  * mapgrid.cpp
  *
- * Functions for storing objects in a quad-tree like object over the map.
- * The objects are stored in the quad-tree.
+ * Functions for storing objects in a grid of cells over the map.
+ * The grid is kept between updates, and objects are only moved to
+ * another cell when their position changes enough.
  *
  */
 #include "lib/framework/types.h"
+#include <algorithm>
+
 #include "objects.h"
 #include "map.h"
 
 #include "mapgrid.h"
-#include "pointtree.h"
 
+/// Cells are squares of 2^GRID_CELL_SHIFT world units.
+#define GRID_CELL_SHIFT (TILE_SHIFT + 2)
+
+struct GridCell
+{
+	std::vector<GridEntry> entries;  ///< Sorted by gridEntryBefore, so that query results depend only on positions and list order.
+	unsigned numStamped = 0;         ///< Number of entries stamped by the current gridReset().
+};
 
-static PointTree *gridPointTree = nullptr;  // A quad-tree-like object.
-static PointTree::Filter *gridFiltersUnseen;
-static PointTree::Filter *gridFiltersDroidsByPlayer;
+static std::vector<GridCell> gridCells;
+static int gridWidth = 0, gridHeight = 0;  // In cells.
+static uint32_t gridStamp = 0;
+static GridList gridSharedList;  // Returned by the gridStartIterate functions.
 
 // initialise the grid system
 bool gridInitialise()
 {
-	ASSERT(gridPointTree == nullptr, "gridInitialise already called, without calling gridShutDown.");
-	gridPointTree = new PointTree;
-	gridFiltersUnseen = new PointTree::Filter[MAX_PLAYERS];
-	gridFiltersDroidsByPlayer = new PointTree::Filter[MAX_PLAYERS];
+	ASSERT(gridCells.empty(), "gridInitialise already called, without calling gridShutDown.");
 
 	return true;  // Yay, nothing failed!
 }
 
+static inline int gridCellCoord(int32_t coord, int size)
+{
+	return clip(coord >> GRID_CELL_SHIFT, 0, size - 1);
+}
+
+// Expands bit pattern abcd efgh to 0a0b 0c0d 0e0f 0g0h
+static uint64_t gridExpandBits(uint32_t x)
+{
+	uint64_t r = x;
+	r = (r | r << 16) & 0x0000FFFF0000FFFFULL;
+	r = (r | r << 8)  & 0x00FF00FF00FF00FFULL;
+	r = (r | r << 4)  & 0x0F0F0F0F0F0F0F0FULL;
+	r = (r | r << 2)  & 0x3333333333333333ULL;
+	r = (r | r << 1)  & 0x5555555555555555ULL;
+	return r;
+}
+
+/// Interleaves x and y, with x in the higher bits, after adding 0x80000000u to both to make their ranges unsigned.
+static uint64_t gridMorton(int32_t x, int32_t y)
+{
+	return gridExpandBits(x + 0x80000000u) << 1 | gridExpandBits(y + 0x80000000u);
+}
+
+/// Entries are in Morton order, then in list order, as they were when the grid was a sorted point tree.
+static bool gridEntryBefore(GridEntry const &a, GridEntry const &b)
+{
+	return a.morton < b.morton || (a.morton == b.morton && a.listPos < b.listPos);
+}
+
+/// Moves the grid entry of psObj to its current position, adding it if not already in the grid.
+static void gridUpdateObject(BASE_OBJECT *psObj, uint32_t listPos)
+{
+	const int cell = gridCellCoord(psObj->pos.x, gridWidth) + gridCellCoord(psObj->pos.y, gridHeight) * gridWidth;
+
+	// gridCell and gridSlot may be stale, if the object was removed from the grid since, so check that they really point to psObj.
+	if (psObj->gridCell >= 0 && psObj->gridCell < (int)gridCells.size() && psObj->gridSlot < gridCells[psObj->gridCell].entries.size()
+	    && gridCells[psObj->gridCell].entries[psObj->gridSlot].psObj == psObj)
+	{
+		GridEntry &entry = gridCells[psObj->gridCell].entries[psObj->gridSlot];
+
+		if (psObj->gridCell == cell)
+		{
+			if (entry.x != psObj->pos.x || entry.y != psObj->pos.y)
+			{
+				entry.x = psObj->pos.x;
+				entry.y = psObj->pos.y;
+				entry.morton = gridMorton(entry.x, entry.y);
+			}
+			entry.stamp = gridStamp;
+			entry.listPos = listPos;
+			++gridCells[cell].numStamped;
+			return;
+		}
+
+		entry.psObj = nullptr;  // Not stamped, so will be removed from the old cell.
+	}
+
+	GridEntry entry = {psObj, psObj->pos.x, psObj->pos.y, gridStamp, listPos, gridMorton(psObj->pos.x, psObj->pos.y)};
+	psObj->gridCell = cell;
+	psObj->gridSlot = gridCells[cell].entries.size();
+	gridCells[cell].entries.push_back(entry);
+	++gridCells[cell].numStamped;
+}
+
 // reset the grid system
 void gridReset()
 {
-	gridPointTree->clear();
+	const int width = (world_coord(mapWidth) + (1 << GRID_CELL_SHIFT) - 1) >> GRID_CELL_SHIFT;
+	const int height = (world_coord(mapHeight) + (1 << GRID_CELL_SHIFT) - 1) >> GRID_CELL_SHIFT;
+
+	if (width != gridWidth || height != gridHeight)
+	{
+		gridCells.clear();  // New map.
+		gridCells.resize(width * height);
+		gridWidth = width;
+		gridHeight = height;
+	}
+
+	++gridStamp;
+
+	for (GridCell &cell : gridCells)
+	{
+		cell.numStamped = 0;
+	}
 
-	// Put all existing objects into the point tree.
+	// Update the positions of all existing objects.
+	uint32_t listPos = 0;
 	for (unsigned player = 0; player < MAX_PLAYERS; player++)
 	{
 		BASE_OBJECT *start[3] = {(BASE_OBJECT *)apsDroidLists[player], (BASE_OBJECT *)apsStructLists[player], (BASE_OBJECT *)apsFeatureLists[player]};
@@ -63,7 +152,7 @@ void gridReset()
 			{
 				if (!psObj->died)
 				{
-					gridPointTree->insert(psObj, psObj->pos.x, psObj->pos.y);
+					gridUpdateObject(psObj, listPos++);
 
 					for (unsigned char &viewer : psObj->seenThisTick)
 					{
@@ -74,24 +163,47 @@ void gridReset()
 		}
 	}
 
-	gridPointTree->sort();
-
-	for (unsigned player = 0; player < MAX_PLAYERS; ++player)
+	// Remove objects which died or are no longer in the lists, and entries left behind by objects which changed cell.
+	// Objects which aren't stamped may have been freed already, so must not be looked at.
+	for (GridCell &cell : gridCells)
 	{
-		gridFiltersUnseen[player].reset(*gridPointTree);
-		gridFiltersDroidsByPlayer[player].reset(*gridPointTree);
+		if (cell.numStamped != cell.entries.size())
+		{
+			unsigned n = 0;
+
+			for (GridEntry const &entry : cell.entries)
+			{
+				if (entry.stamp == gridStamp)
+				{
+					cell.entries[n] = entry;
+					entry.psObj->gridSlot = n;
+					++n;
+				}
+			}
+
+			cell.entries.resize(n);
+		}
+
+		// Objects which moved, arrived or changed place in the lists may be out of order. Usually nothing is.
+		if (!std::is_sorted(cell.entries.begin(), cell.entries.end(), gridEntryBefore))
+		{
+			std::sort(cell.entries.begin(), cell.entries.end(), gridEntryBefore);
+
+			for (unsigned n = 0; n < cell.entries.size(); ++n)
+			{
+				cell.entries[n].psObj->gridSlot = n;
+			}
+		}
 	}
 }
 
 // shutdown the grid system
 void gridShutDown()
 {
-	delete gridPointTree;
-	gridPointTree = nullptr;
-	delete[] gridFiltersUnseen;
-	gridFiltersUnseen = nullptr;
-	delete[] gridFiltersDroidsByPlayer;
-	gridFiltersDroidsByPlayer = nullptr;
+	gridCells.clear();
+	gridWidth = 0;
+	gridHeight = 0;
+	gridSharedList.clear();
 }
 
 static bool isInRadius(int32_t x, int32_t y, uint32_t radius)
@@ -99,121 +211,114 @@ static bool isInRadius(int32_t x, int32_t y, uint32_t radius)
 	return (uint32_t)(x * x + y * y) <= radius * radius;
 }
 
-// initialise the grid system to start iterating through units that
-// could affect a location (x,y in world coords)
+/// Finds the objects in the rectangle from (minX, minY) to (maxX, maxY), using the positions from the last gridReset(), for which condition(object) is true.
 template<class Condition>
-static GridList const &gridStartIterateFiltered(int32_t x, int32_t y, uint32_t radius, PointTree::Filter *filter, Condition const &condition)
+static void gridFindFiltered(GridList &results, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, Condition const &condition)
 {
-	if (filter == nullptr)
-	{
-		gridPointTree->query(x, y, radius);
-	}
-	else
+	results.clear();
+
+	if (gridCells.empty())
 	{
-		gridPointTree->query(*filter, x, y, radius);
+		return;  // Grid not set up yet.
 	}
 
-	PointTree::ResultVector::iterator w = gridPointTree->lastQueryResults.begin(), i;
+	const int cx1 = gridCellCoord(minX, gridWidth), cx2 = gridCellCoord(maxX, gridWidth);
+	const int cy1 = gridCellCoord(minY, gridHeight), cy2 = gridCellCoord(maxY, gridHeight);
 
-	for (i = w; i != gridPointTree->lastQueryResults.end(); ++i)
+	gridForEachCell(cx1, cy1, cx2, cy2, [&](int cx, int cy)
 	{
-		BASE_OBJECT *obj = static_cast<BASE_OBJECT *>(*i);
-
-		if (!condition.test(obj))  // Check if we should skip this object.
-		{
-			filter->erase(gridPointTree->lastFilteredQueryIndices[i - gridPointTree->lastQueryResults.begin()]);  // Stop the object from appearing in future searches.
-		}
-		else if (isInRadius(obj->pos.x - x, obj->pos.y - y, radius))  // Check that search result is less than radius (since they can be up to a factor of sqrt(2) more).
+		for (GridEntry const &entry : gridCells[cx + cy * gridWidth].entries)
 		{
-			*w = *i;
-			++w;
+			if (entry.x >= minX && entry.x <= maxX && entry.y >= minY && entry.y <= maxY && condition(entry.psObj))
+			{
+				results.push_back(entry.psObj);
+			}
 		}
-	}
-
-	gridPointTree->lastQueryResults.erase(w, i);  // Erase all points that were a bit too far.
-	/*
-	// In case you are curious.
-	debug(LOG_WARNING, "gridStartIterateFiltered(%d, %d, %u) found %u objects", x, y, radius, (unsigned)gridPointTree->lastQueryResults.size());
-	*/
-	static GridList gridList;
-	gridList.resize(gridPointTree->lastQueryResults.size());
+	});
+}
 
-	for (unsigned n = 0; n < gridList.size(); ++n)
+void gridFindObjects(GridList &results, int32_t x, int32_t y, uint32_t radius)
+{
+	gridFindFiltered(results, x - radius, y - radius, x + radius, y + radius, [&](BASE_OBJECT *obj)
 	{
-		gridList[n] = (BASE_OBJECT *)gridPointTree->lastQueryResults[n];
-	}
-
-	return gridList;
+		return isInRadius(obj->pos.x - x, obj->pos.y - y, radius);
+	});
 }
 
-template<class Condition>
-static GridList const &gridStartIterateFilteredArea(int32_t x, int32_t y, int32_t x2, int32_t y2, Condition const &condition)
+void gridFindObjectsArea(GridList &results, int32_t x, int32_t y, int32_t x2, int32_t y2)
 {
-	gridPointTree->query(x, y, x2, y2);
-
-	static GridList gridList;
-	gridList.resize(gridPointTree->lastQueryResults.size());
+	gridFindFiltered(results, x, y, x2, y2, [](BASE_OBJECT *)
+	{
+		return true;
+	});
+}
 
-	for (unsigned n = 0; n < gridList.size(); ++n)
+void gridFindDroidsByPlayer(GridList &results, int32_t x, int32_t y, uint32_t radius, int player)
+{
+	gridFindFiltered(results, x - radius, y - radius, x + radius, y + radius, [&](BASE_OBJECT *obj)
 	{
-		gridList[n] = (BASE_OBJECT *)gridPointTree->lastQueryResults[n];
-	}
+		return obj->type == OBJ_DROID && obj->player == player && isInRadius(obj->pos.x - x, obj->pos.y - y, radius);
+	});
+}
 
-	return gridList;
+void gridFindUnseen(GridList &results, int32_t x, int32_t y, uint32_t radius, int player)
+{
+	gridFindFiltered(results, x - radius, y - radius, x + radius, y + radius, [&](BASE_OBJECT *obj)
+	{
+		return obj->seenThisTick[player] < UINT8_MAX && isInRadius(obj->pos.x - x, obj->pos.y - y, radius);
+	});
 }
 
-struct ConditionTrue
+void gridCellRange(int32_t x, int32_t y, int32_t x2, int32_t y2, int &cx1, int &cy1, int &cx2, int &cy2)
 {
-	bool test(BASE_OBJECT *) const
+	if (gridCells.empty())
 	{
-		return true;
+		cx1 = cy1 = 0;
+		cx2 = cy2 = -1;
+		return;
 	}
-};
 
-GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius)
+	cx1 = gridCellCoord(x, gridWidth);
+	cx2 = gridCellCoord(x2, gridWidth);
+	cy1 = gridCellCoord(y, gridHeight);
+	cy2 = gridCellCoord(y2, gridHeight);
+}
+
+int gridCellCount()
 {
-	return gridStartIterateFiltered(x, y, radius, nullptr, ConditionTrue());
+	return gridCells.size();
 }
 
-GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t y2)
+int gridCellIndex(int cx, int cy)
 {
-	return gridStartIterateFilteredArea(x, y, x2, y2, ConditionTrue());
+	return cx + cy * gridWidth;
 }
 
-struct ConditionDroidsByPlayer
+std::vector<GridEntry> const &gridCellEntries(int cell)
 {
-	ConditionDroidsByPlayer(int32_t player_) : player(player_) {}
-	bool test(BASE_OBJECT *obj) const
-	{
-		return obj->type == OBJ_DROID && obj->player == player;
-	}
-	int player;
-};
+	return gridCells[cell].entries;
+}
 
-GridList const &gridStartIterateDroidsByPlayer(int32_t x, int32_t y, uint32_t radius, int player)
+GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius)
 {
-	return gridStartIterateFiltered(x, y, radius, &gridFiltersDroidsByPlayer[player], ConditionDroidsByPlayer(player));
+	gridFindObjects(gridSharedList, x, y, radius);
+	return gridSharedList;
 }
 
-struct ConditionUnseen
+GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t y2)
 {
-	ConditionUnseen(int32_t player_) : player(player_) {}
-	bool test(BASE_OBJECT *obj) const
-	{
-		return obj->seenThisTick[player] < UINT8_MAX;
-	}
-	int player;
-};
+	gridFindObjectsArea(gridSharedList, x, y, x2, y2);
+	return gridSharedList;
+}
 
-GridList const &gridStartIterateUnseen(int32_t x, int32_t y, uint32_t radius, int player)
+GridList const &gridStartIterateDroidsByPlayer(int32_t x, int32_t y, uint32_t radius, int player)
 {
-	return gridStartIterateFiltered(x, y, radius, &gridFiltersUnseen[player], ConditionUnseen(player));
+	gridFindDroidsByPlayer(gridSharedList, x, y, radius, player);
+	return gridSharedList;
 }
 
-BASE_OBJECT **gridIterateDup()
+GridList const &gridStartIterateUnseen(int32_t x, int32_t y, uint32_t radius, int player)
 {
-	size_t bytes = gridPointTree->lastQueryResults.size() * sizeof(void *);
-	BASE_OBJECT **ret = (BASE_OBJECT **)malloc(bytes);
-	memcpy(ret, &gridPointTree->lastQueryResults[0], bytes);
-	return ret;
+	gridFindUnseen(gridSharedList, x, y, radius, player);
+	return gridSharedList;
 }
@@ -27,20 +27,48 @@
 typedef std::vector<BASE_OBJECT *> GridList;
 typedef GridList::const_iterator GridIterator;
 
+/// An object in the grid, at the position it had when the grid was last reset.
+struct GridEntry
+{
+	BASE_OBJECT *psObj;
+	int32_t x, y;
+	uint32_t stamp;    ///< Value of gridStamp when the object was last found in the object lists.
+	uint32_t listPos;  ///< Position in the object lists, to order objects in exactly the same place.
+	uint64_t morton;   ///< Interleaved bits of x and y, which the entries of each cell are sorted by.
+};
+
 // initialise the grid system
 bool gridInitialise();
 
 // shutdown the grid system
 void gridShutDown();
 
-// Reset the grid system. Called once per update.
+// Update the grid system with the current positions of all objects. Called once per update.
 // Resets seenThisTick[] to false.
 void gridReset();
 
+// The gridFind functions replace the contents of results with the objects found, and may be called from several threads
+// at once, each with its own results, as long as the grid isn't reset at the same time.
+
 /// Find all objects within radius.
-GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius);
+void gridFindObjects(GridList &results, int32_t x, int32_t y, uint32_t radius);
+
+/// Find all objects within the rectangle from (x, y) to (x2, y2).
+void gridFindObjectsArea(GridList &results, int32_t x, int32_t y, int32_t x2, int32_t y2);
+
+/// Find all objects within radius where object->type == OBJ_DROID && object->player == player.
+void gridFindDroidsByPlayer(GridList &results, int32_t x, int32_t y, uint32_t radius, int player);
+
+// Used for visibility.
+/// Find all objects within radius where object->seenThisTick[player] != 255.
+void gridFindUnseen(GridList &results, int32_t x, int32_t y, uint32_t radius, int player);
+
+// The gridStartIterate functions return a list shared by all of them, so are not thread safe.
 
 /// Find all objects within radius.
+GridList const &gridStartIterate(int32_t x, int32_t y, uint32_t radius);
+
+/// Find all objects within the rectangle from (x, y) to (x2, y2).
 GridList const &gridStartIterateArea(int32_t x, int32_t y, uint32_t x2, uint32_t y2);
 
 /// Find all objects within radius where object->type == OBJ_DROID && object->player == player.
@@ -50,4 +78,50 @@ GridList const &gridStartIterateDroidsByPlayer(int32_t x, int32_t y, uint32_t ra
 /// Find all objects within radius where object->seenThisTick[player] != 255.
 GridList const &gridStartIterateUnseen(int32_t x, int32_t y, uint32_t radius, int player);
 
+// For callers which keep their own data per cell, such as the projectile collision checks.
+/// Finds the cells which the gridFind functions look in for the rectangle from (x, y) to (x2, y2). The range is empty if there is no grid.
+void gridCellRange(int32_t x, int32_t y, int32_t x2, int32_t y2, int &cx1, int &cy1, int &cx2, int &cy2);
+/// Number of cells, which is only changed by gridReset() when loading a different sized map.
+int gridCellCount();
+/// Index of the cell at (cx, cy), as returned by gridCellRange, from 0 to gridCellCount() - 1.
+int gridCellIndex(int cx, int cy);
+/// The objects in the cell, in the order the gridFind functions return them, until the next gridReset().
+std::vector<GridEntry> const &gridCellEntries(int cell);
+
+/// Calls fn(cx, cy) for the cells in the block of size by size cells at (x, y) which are also in the range from (cx1, cy1) to (cx2, cy2), in Morton order.
+template <typename Fn>
+void gridForEachCellInBlock(int cx1, int cy1, int cx2, int cy2, int x, int y, int size, Fn const &fn)
+{
+	if (x > cx2 || y > cy2 || x + size <= cx1 || y + size <= cy1)
+	{
+		return;
+	}
+
+	if (size == 1)
+	{
+		fn(x, y);
+		return;
+	}
+
+	// The x bit is above the y bit in the Morton number, as in the entries of each cell.
+	const int half = size / 2;
+	gridForEachCellInBlock(cx1, cy1, cx2, cy2, x, y, half, fn);
+	gridForEachCellInBlock(cx1, cy1, cx2, cy2, x, y + half, half, fn);
+	gridForEachCellInBlock(cx1, cy1, cx2, cy2, x + half, y, half, fn);
+	gridForEachCellInBlock(cx1, cy1, cx2, cy2, x + half, y + half, half, fn);
+}
+
+/// Calls fn(cx, cy) for each cell in the range from gridCellRange, in the order the gridFind functions look in them. Cells are
+/// aligned squares of a power of 2 in size, so going through them in Morton order finds objects in Morton order of their positions.
+template <typename Fn>
+void gridForEachCell(int cx1, int cy1, int cx2, int cy2, Fn const &fn)
+{
+	int size = 1;
+	while (size <= cx2 || size <= cy2)
+	{
+		size *= 2;
+	}
+	gridForEachCellInBlock(cx1, cy1, cx2, cy2, 0, 0, size, fn);
+}
+
 #endif // __INCLUDED_SRC_MAPGRID_H__
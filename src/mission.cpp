@@ -70,8 +70,10 @@
 #include "data.h"
 #include "multiplay.h"
 #include "loop.h"
+#include "benchmark.h"
 #include "visibility.h"
 #include "mapgrid.h"
+#include "astar.h"
 #include "selection.h"
 #include "scores.h"
 #include "keymap.h"
@@ -256,6 +258,7 @@ void initMission()
 	mission.ETA = -1;
 	mission.startTime = 0;
 	mission.psGateways.clear(); // just in case
+	mission.fireWheel = FIRE_WHEEL();
 	mission.mapHeight = 0;
 	mission.mapWidth = 0;
 
@@ -269,6 +272,11 @@ void initMission()
 		i = nullptr;
 	}
 
+	for (auto &i : mission.psVisionMap)
+	{
+		i = nullptr;
+	}
+
 	//init all the landing zones
 	for (auto &inc : sLandingZone)
 	{
@@ -360,7 +368,16 @@ bool missionShutDown()
 			mission.psAuxMap[i] = nullptr;
 		}
 
+		for (int i = 0; i < ARRAY_SIZE(mission.psVisionMap); ++i)
+		{
+			free(psVisionMap[i]);
+			psVisionMap[i] = mission.psVisionMap[i];
+			mission.psVisionMap[i] = nullptr;
+		}
+
 		std::swap(mission.psGateways, gwGetGateways());
+		std::swap(mission.fireWheel, mapGetFireWheel());
+		fpathResetBlockingMaps();  // The cached path-finding maps were for the other map.
 	}
 
 	// sorry if this breaks something - but it looks like it's what should happen - John
@@ -763,11 +780,18 @@ static void saveMissionData()
 		mission.psAuxMap[i] = psAuxMap[i];
 	}
 
+	for (int i = 0; i < ARRAY_SIZE(mission.psVisionMap); ++i)
+	{
+		mission.psVisionMap[i] = psVisionMap[i];
+	}
+
 	mission.scrollMinX = scrollMinX;
 	mission.scrollMinY = scrollMinY;
 	mission.scrollMaxX = scrollMaxX;
 	mission.scrollMaxY = scrollMaxY;
 	std::swap(mission.psGateways, gwGetGateways());
+	std::swap(mission.fireWheel, mapGetFireWheel());
+	fpathResetBlockingMaps();  // The cached path-finding maps were for the other map.
 	// save the selectedPlayer's LZ
 	mission.homeLZ_X = getLandingX(selectedPlayer);
 	mission.homeLZ_Y = getLandingY(selectedPlayer);
@@ -931,11 +955,19 @@ void restoreMissionData()
 		mission.psAuxMap[i] = nullptr;
 	}
 
+	for (int i = 0; i < ARRAY_SIZE(mission.psVisionMap); ++i)
+	{
+		psVisionMap[i] = mission.psVisionMap[i];
+		mission.psVisionMap[i] = nullptr;
+	}
+
 	scrollMinX = mission.scrollMinX;
 	scrollMinY = mission.scrollMinY;
 	scrollMaxX = mission.scrollMaxX;
 	scrollMaxY = mission.scrollMaxY;
 	std::swap(mission.psGateways, gwGetGateways());
+	std::swap(mission.fireWheel, mapGetFireWheel());
+	fpathResetBlockingMaps();  // The cached path-finding maps were for the other map.
 	//and clear the mission pointers
 	mission.psMapTiles	= nullptr;
 	mission.mapWidth	= 0;
@@ -945,6 +977,7 @@ void restoreMissionData()
 	mission.scrollMaxX	= 0;
 	mission.scrollMaxY	= 0;
 	mission.psGateways.clear();
+	mission.fireWheel = FIRE_WHEEL();
 
 	//reset the current structure lists
 	setCurrentStructQuantity(false);
@@ -1452,8 +1485,15 @@ void swapMissionPointers()
 		std::swap(psAuxMap[i],   mission.psAuxMap[i]);
 	}
 
+	for (int i = 0; i < ARRAY_SIZE(mission.psVisionMap); ++i)
+	{
+		std::swap(psVisionMap[i], mission.psVisionMap[i]);
+	}
+
 	//swap gateway zones
 	std::swap(mission.psGateways, gwGetGateways());
+	std::swap(mission.fireWheel, mapGetFireWheel());
+	fpathResetBlockingMaps();  // The cached path-finding maps were for the other map.
 	std::swap(scrollMinX, mission.scrollMinX);
 	std::swap(scrollMinY, mission.scrollMinY);
 	std::swap(scrollMaxX, mission.scrollMaxX);
@@ -1622,6 +1662,8 @@ void resetLimboMission()
 Only interested in Transporters at present*/
 void missionDroidUpdate(DROID *psDroid)
 {
+	BenchmarkPhase phase(BENCH_DROIDS);
+
 	ASSERT_OR_RETURN(, psDroid != nullptr, "Invalid unit pointer");
 
 	/*This is required for Transporters that are moved offWorld so the
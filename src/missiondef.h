@@ -58,7 +58,9 @@ struct MISSION
 	int32_t                         mapHeight;                      //the original mapHeight
 	uint8_t                        *psBlockMap[AUX_MAX];
 	uint8_t                        *psAuxMap[MAX_PLAYERS + AUX_MAX];
+	uint8_t                        *psVisionMap[VISMAP_MAX * MAX_PLAYERS];
 	GATEWAY_LIST                    psGateways;                     //the gateway list
+	FIRE_WHEEL                      fireWheel;                      //the burning tiles of the original map
 	int32_t                         scrollMinX;                     //scroll coords for original map
 	int32_t                         scrollMinY;
 	int32_t                         scrollMaxX;
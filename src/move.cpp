@@ -297,7 +297,7 @@ static void moveShuffleDroid(DROID *psDroid, Vector2i s)
 
 	// find any droids that could block the shuffle
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, SHUFFLE_DIST);
+	gridFindObjects(gridList, psDroid->pos.x, psDroid->pos.y, SHUFFLE_DIST);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -629,7 +629,7 @@ static void moveCheckSquished(DROID *psDroid, int32_t emx, int32_t emy)
 	const int32_t   my = gameTimeAdjustedAverage(emy, EXTRA_PRECISION);
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
+	gridFindObjects(gridList, psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -1091,7 +1091,7 @@ static void moveCalcDroidSlide(DROID *psDroid, int *pmx, int *pmy)
 	droidR = moveObjRadius((BASE_OBJECT *)psDroid);
 	BASE_OBJECT *psObst = nullptr;
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
+	gridFindObjects(gridList, psDroid->pos.x, psDroid->pos.y, OBJ_MAXRADIUS);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -1214,7 +1214,7 @@ static Vector2i moveGetObstacleVector(DROID *psDroid, Vector2i dest)
 
 	// scan the neighbours for obstacles
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, AVOID_DIST);
+	gridFindObjects(gridList, psDroid->pos.x, psDroid->pos.y, AVOID_DIST);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -2073,7 +2073,7 @@ static void checkLocalFeatures(DROID *psDroid)
 	// scan the neighbours
 #define DROIDDIST ((TILE_UNITS*5)/2)
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psDroid->pos.x, psDroid->pos.y, DROIDDIST);
+	gridFindObjects(gridList, psDroid->pos.x, psDroid->pos.y, DROIDDIST);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -46,6 +46,7 @@
 
 #include "lib/gamelib/gtime.h"
 #include "lib/netplay/netplay.h"
+#include "lib/netplay/netreplay.h"
 #include "lib/script/script.h"
 #include "lib/widget/editbox.h"
 #include "lib/widget/button.h"
@@ -233,8 +234,6 @@ static	void	disableMultiButs();
 static	void	processMultiopWidgets(UDWORD);
 static	void	SendFireUp();
 
-static	void	decideWRF();
-
 static void		closeColourChooser();
 static void		closeTeamChooser();
 static void		closePositionChooser();
@@ -458,7 +457,8 @@ void loadMultiScripts()
 		}
 
 		// The i == selectedPlayer hack is to enable autogames
-		if (bMultiPlayer && game.type == SKIRMISH && (!NetPlay.players[i].allocated || i == selectedPlayer)
+		// Replays already have everything the AIs did, the same as for clients which aren't responsible for the AIs
+		if (bMultiPlayer && game.type == SKIRMISH && !NETisReplay() && (!NetPlay.players[i].allocated || i == selectedPlayer)
 		        && (NetPlay.players[i].ai >= 0 || hostlaunch == 2) && myResponsibility(i))
 		{
 			if (PHYSFS_exists(ininame.toUtf8().c_str())) // challenge file may override AI
@@ -466,23 +466,22 @@ void loadMultiScripts()
 				WzConfig ini(ininame, WzConfig::ReadOnly);
 				ini.beginGroup("player_" + WzString::number(i));
 
-				if (ini.contains("ai"))
-				{
-					WzString val = ini.value("ai").toWzString();
-					ini.endGroup();
+				WzString val = ini.value("ai", "").toWzString();
+				ini.endGroup();
 
-					if (val.compare("null") == 0)
-					{
-						continue; // no AI
-					}
+				if (val.compare("null") == 0)
+				{
+					continue; // no AI
+				}
 
+				// wzscript AIs were matched to their aidata entry by setupChallengeAIs, so are loaded below.
+				if (!val.isEmpty() && !val.endsWith(".slo") && !val.endsWith(".vlo"))
+				{
 					loadPlayerScript(val, i, NetPlay.players[i].difficulty);
 
 					debug(LOG_WZ, "AI %s loaded for player %u", val.toUtf8().c_str(), i);
 					continue;
 				}
-
-				ini.endGroup();
 			}
 
 			if (aidata[NetPlay.players[i].ai].slo[0] != '\0')
@@ -502,7 +501,7 @@ void loadMultiScripts()
 	}
 
 	// Load scavengers
-	if (game.scavengers && myResponsibility(scavengerPlayer()))
+	if (game.scavengers && !NETisReplay() && myResponsibility(scavengerPlayer()))
 	{
 		debug(LOG_SAVE, "Loading scavenger AI for player %d", scavengerPlayer());
 		loadPlayerScript("multiplay/script/scavfact.js", scavengerPlayer(), DIFFICULTY_EASY);
@@ -842,7 +841,7 @@ void readAIs()
 }
 
 //sets sWRFILE form game.map
-static void decideWRF()
+void decideWRF()
 {
 	// try and load it from the maps directory first,
 	sstrcpy(aLevelName, MultiCustomMapsPath);
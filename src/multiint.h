@@ -94,6 +94,7 @@ public:
 void readAIs();	///< step 1, load AI definition files
 void setupChallengeAIs();	///< dirty hack to allow correct display of names from challenges
 void loadMultiScripts();	///< step 2, load the actual AI scripts
+void decideWRF();	///< Sets aLevelName for game.map
 const char *getAIName(int player);	///< only run this -after- readAIs() is called
 const std::vector<WzString> getAINames();
 int matchAIbyName(const char *name);	///< only run this -after- readAIs() is called
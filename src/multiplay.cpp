@@ -317,6 +317,13 @@ bool multiPlayerLoop()
 // to get droids ...
 DROID *IdToDroid(UDWORD id, UDWORD player)
 {
+	BASE_OBJECT *psObj;
+
+	if ((player == ANYPLAYER || player < MAX_PLAYERS) && objIdIndexLookup(id, OBJLIST_DROIDS, player == ANYPLAYER ? -1 : player, false, &psObj))
+	{
+		return castDroid(psObj);
+	}
+
 	if (player == ANYPLAYER)
 	{
 		for (int i = 0; i < MAX_PLAYERS; i++)
@@ -347,6 +354,13 @@ DROID *IdToDroid(UDWORD id, UDWORD player)
 // find off-world droids
 DROID *IdToMissionDroid(UDWORD id, UDWORD player)
 {
+	BASE_OBJECT *psObj;
+
+	if ((player == ANYPLAYER || player < MAX_PLAYERS) && objIdIndexLookup(id, OBJLIST_MISSION_DROIDS, player == ANYPLAYER ? -1 : player, false, &psObj))
+	{
+		return castDroid(psObj);
+	}
+
 	if (player == ANYPLAYER)
 	{
 		for (int i = 0; i < MAX_PLAYERS; i++)
@@ -378,6 +392,13 @@ DROID *IdToMissionDroid(UDWORD id, UDWORD player)
 // find a structure
 STRUCTURE *IdToStruct(UDWORD id, UDWORD player)
 {
+	BASE_OBJECT *psObj;
+
+	if ((player == ANYPLAYER || player < MAX_PLAYERS) && objIdIndexLookup(id, OBJLIST_STRUCTURES | OBJLIST_MISSION_STRUCTURES, player == ANYPLAYER ? -1 : player, false, &psObj))
+	{
+		return castStructure(psObj);
+	}
+
 	int beginPlayer = 0, endPlayer = MAX_PLAYERS;
 
 	if (player != ANYPLAYER)
@@ -411,6 +432,13 @@ FEATURE *IdToFeature(UDWORD id, UDWORD player)
 {
 	(void)player;	// unused, all features go into player 0
 
+	BASE_OBJECT *psObj;
+
+	if (objIdIndexLookup(id, OBJLIST_FEATURES, -1, false, &psObj))
+	{
+		return castFeature(psObj);
+	}
+
 	for (FEATURE *d = apsFeatureLists[0]; d; d = d->psNext)
 	{
 		if (d->id == id)
@@ -0,0 +1,246 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/*
+ * multireplay.cpp
+ *
+ * The game settings stored in a replay, and starting a game from them.
+ * The messages themselves are recorded and played back in lib/netplay/netreplay.cpp.
+ */
+#include "lib/framework/frame.h"
+#include "lib/framework/rational.h"
+#include "lib/framework/wzapp.h"
+#include "lib/gamelib/gtime.h"
+#include "lib/netplay/netplay.h"
+#include "lib/netplay/netreplay.h"
+
+#include "ai.h"
+#include "benchmark.h"
+#include "data.h"
+#include "main.h"
+#include "modding.h"
+#include "multiint.h"
+#include "multiplay.h"
+#include "multireplay.h"
+#include "random.h"
+#include "warzoneconfig.h"
+
+#define REPLAY_FAST_FORWARD_MOD 1000    ///< Game time modifier when fast-forwarding, high enough to tick on every loop.
+#define REPLAY_FAST_RENDER_INTERVAL 250 ///< When fast-forwarding, only render a frame this often (in ms), to keep the window responsive.
+
+static uint32_t replayStartTicks = 0;   ///< Real time the replay level was loaded, for reporting the playback speed.
+static uint32_t replayLastRender = 0;
+static bool replayFinished = false;
+
+/// The settings chosen in the lobby, which the game depends on. Encodes or decodes, depending on the direction set by NETbeginEncodeMessage or NETbeginDecodeMessage.
+static void replaySettings(uint32_t &seed)
+{
+	unsigned i, j;
+
+	NETuint32_t(&seed);
+	NETuint32_t(&selectedPlayer);
+
+	NETuint8_t(&game.type);
+	NETstring(game.map, 128);
+	NETbin(game.hash.bytes, game.hash.Bytes);
+	uint32_t modHashesSize = game.modHashes.size();
+	NETuint32_t(&modHashesSize);
+	ASSERT_OR_RETURN(, modHashesSize < 1000000, "Way too many mods %u", modHashesSize);
+	game.modHashes.resize(modHashesSize);
+
+	for (auto &hash : game.modHashes)
+	{
+		NETbin(hash.bytes, hash.Bytes);
+	}
+
+	NETuint8_t(&game.maxPlayers);
+	NETstring(game.name, 128);
+	NETuint32_t(&game.power);
+	NETuint8_t(&game.base);
+	NETuint8_t(&game.alliance);
+	NETbool(&game.scavengers);
+	NETbool(&game.isMapMod);
+	NETuint32_t(&game.techLevel);
+
+	for (i = 0; i < MAX_PLAYERS; i++)
+	{
+		NETuint8_t(&game.skDiff[i]);
+	}
+
+	for (i = 0; i < MAX_PLAYERS; i++)
+	{
+		for (j = 0; j < MAX_PLAYERS; j++)
+		{
+			NETuint8_t(&alliances[i][j]);
+		}
+	}
+
+	for (i = 0; i < MAX_PLAYERS; i++)
+	{
+		NETbool(&NetPlay.players[i].allocated);
+		NETstring(NetPlay.players[i].name, sizeof(NetPlay.players[i].name));
+		NETint32_t(&NetPlay.players[i].colour);
+		NETint32_t(&NetPlay.players[i].position);
+		NETint32_t(&NetPlay.players[i].team);
+		NETint8_t(&NetPlay.players[i].ai);
+		NETint8_t(&NetPlay.players[i].difficulty);
+	}
+
+	uint32_t numStructureLimits = ingame.numStructureLimits;
+	NETuint32_t(&numStructureLimits);
+	ASSERT_OR_RETURN(, numStructureLimits < 100000, "Way too many structure limits %u", numStructureLimits);
+	if (NETgetPacketDir() == PACKET_DECODE)
+	{
+		free(ingame.pStructureLimits);
+		ingame.pStructureLimits = numStructureLimits ? (MULTISTRUCTLIMITS *)malloc(numStructureLimits * sizeof(MULTISTRUCTLIMITS)) : nullptr;
+		ingame.numStructureLimits = numStructureLimits;
+	}
+
+	for (i = 0; i < ingame.numStructureLimits; i++)
+	{
+		NETuint32_t(&ingame.pStructureLimits[i].id);
+		NETuint32_t(&ingame.pStructureLimits[i].limit);
+	}
+
+	NETuint8_t(&ingame.flags);
+}
+
+void replayStartRecording()
+{
+	if (!bMultiPlayer || game.type != SKIRMISH || NETisReplay() || benchmark_enabled() || !war_GetRecordReplays())
+	{
+		return;
+	}
+
+	game.modHashes = getModHashList();
+
+	NetMessage settings;
+	uint32_t seed = gameGetSeed();
+	NETbeginEncodeMessage(0);
+	replaySettings(seed);
+	NETendEncodeMessage(&settings);
+
+	// The map name goes in the file name, so keep out anything that would make it a path.
+	char name[sizeof(game.map)];
+	sstrcpy(name, game.map);
+	for (char *c = name; *c != '\0'; ++c)
+	{
+		if (*c == '/' || *c == '\\' || *c == ':')
+		{
+			*c = '_';
+		}
+	}
+
+	NETreplaySaveStart(name, settings);
+}
+
+bool replayStartPlayback(const char *filename)
+{
+	NetMessage settings;
+	if (!NETreplayLoadStart(filename, settings))
+	{
+		return false;
+	}
+
+	// Set up as for a skirmish game without comms, then take the players from the replay.
+	NetPlay.bComms = false;
+	NEThostGame(_("Replay"), "", SKIRMISH, 0, 0, 0, MAX_PLAYERS);
+
+	uint32_t seed = 0;
+	NETbeginDecodeMessage(&settings);
+	replaySettings(seed);
+	if (!NETend() || selectedPlayer >= MAX_PLAYERS)
+	{
+		debug(LOG_ERROR, "Replay %s has invalid settings", filename);
+		selectedPlayer = 0;
+		NETreplayLoadStop();
+		return false;
+	}
+	realSelectedPlayer = selectedPlayer;
+
+	if (game.modHashes != getModHashList())
+	{
+		debug(LOG_WARNING, "Replay %s was recorded with different mods loaded, expect it to desync", filename);
+	}
+
+	gameSRand(seed);  // Same seed as the recorded game.
+
+	for (unsigned i = 0; i < MAX_PLAYERS; i++)
+	{
+		ingame.JoiningInProgress[i] = false;  // Everyone was there when the game was recorded.
+	}
+	ingame.localOptionsReceived = true;
+	ingame.TimeEveryoneIsInGame = 0;
+	resetDataHash();
+	decideWRF();
+
+	bMultiPlayer = true;
+	bMultiMessages = true;
+	replayFinished = false;
+	debug(LOG_INFO, "Playing back replay %s of %s, as player %u", filename, game.map, selectedPlayer);
+	return true;
+}
+
+void replayGameLoaded()
+{
+	if (!NETisReplay())
+	{
+		return;
+	}
+
+	replayStartTicks = wzGetTicks();
+	replayLastRender = 0;
+	if (replay_fastforward())
+	{
+		gameTimeSetMod(Rational(REPLAY_FAST_FORWARD_MOD));
+	}
+}
+
+void replayStop()
+{
+	NETreplaySaveStop();
+	if (NETreplayLoadStop() && replay_fastforward())
+	{
+		gameTimeResetMod();
+	}
+}
+
+bool replaySkipRender()
+{
+	if (!NETisReplay() || !replay_fastforward() || replayFinished)
+	{
+		return false;
+	}
+
+	uint32_t now = wzGetTicks();
+	if (NETreplayLoadIsDone() && !checkPlayerGameTime(NET_ALL_PLAYERS))
+	{
+		// Waiting for messages which will never come, so back to normal speed.
+		replayFinished = true;
+		gameTimeResetMod();
+		debug(LOG_INFO, "Replay finished, %u ms of game time in %u ms", gameTime, now - replayStartTicks);
+		return false;
+	}
+
+	if (now - replayLastRender < REPLAY_FAST_RENDER_INTERVAL)
+	{
+		return true;
+	}
+	replayLastRender = now;
+	return false;
+}
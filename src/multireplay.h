@@ -0,0 +1,40 @@
+/*
+	This file is part of Warzone 2100.
+	Copyright (C) 2017  Warzone 2100 Project
+
+	Warzone 2100 is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+
+	Warzone 2100 is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Warzone 2100; if not, write to the Free Software
+	Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+/*
+ * multireplay.h
+ *
+ * Starting and stopping replays of skirmish and multiplayer games.
+ */
+
+#ifndef __INCLUDED_SRC_MULTIREPLAY_H__
+#define __INCLUDED_SRC_MULTIREPLAY_H__
+
+/// Starts recording the game about to be loaded, if enabled. Call before loading the level.
+void replayStartRecording();
+/// Loads the settings of a replay and gets everything ready for STARTGAME, as if the host had just started the game.
+bool replayStartPlayback(const char *filename);
+/// Call once the level of a replay being played back is loaded.
+void replayGameLoaded();
+/// Stops recording or playing back.
+void replayStop();
+
+/// Returns true if the renderer should skip this frame, which it does most of the time when fast-forwarding a replay.
+bool replaySkipRender() asm ("replaySkipRender");
+
+#endif // __INCLUDED_SRC_MULTIREPLAY_H__
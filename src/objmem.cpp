@@ -24,6 +24,7 @@
  *
  */
 #include <string.h>
+#include <unordered_map>
 
 #include "lib/framework/frame.h"
 #include "objects.h"
@@ -259,6 +260,203 @@ uint32_t generateSynchronisedObjectId()
 	return ret;
 }
 
+/***************************************************************************************
+ *
+ * Index from object id to object, for getBaseObjFromId(), IdToDroid() and friends.
+ *
+ * Covers the same lists getBaseObjFromId() searches, in the same order, including droids carried by transporters.
+ * Kept up to date by addObjectToList(), removeObjectFromList() and destroyObject(). The list heads are remembered,
+ * so that lists moved around directly (such as by the mission code) are noticed, and the index rebuilt.
+ */
+
+#define OBJ_INDEX_LISTS 7       ///< Number of OBJLIST_* bits
+
+struct OBJECT_ID_ENTRY
+{
+	BASE_OBJECT *psObj;
+	uint8_t list;           ///< Index of the OBJLIST_* bit of the list psObj is in, or its transporter is in
+	uint8_t player;         ///< Which of the lists
+	bool cargo;             ///< In the group of a transporter, instead of in the list itself
+	bool ambiguous;         ///< Another object has the same id, so search the lists
+};
+
+static std::unordered_map<uint32_t, OBJECT_ID_ENTRY> objIdIndex;
+static BASE_OBJECT *objIdIndexHeads[OBJ_INDEX_LISTS][MAX_PLAYERS];  ///< The list heads the index was last updated for
+static bool objIdIndexValid = false;
+
+/// The current head of the given list, as searched by getBaseObjFromId().
+static BASE_OBJECT *objIdIndexHead(int list, int player)
+{
+	switch (list)
+	{
+		case 0: return apsDroidLists[player];
+		case 1: return apsStructLists[player];
+		case 2: return player == 0 ? apsFeatureLists[0] : nullptr;
+		case 3: return mission.apsDroidLists[player];
+		case 4: return mission.apsStructLists[player];
+		case 5: return player == 0 ? mission.apsFeatureLists[0] : nullptr;
+		case 6: return player == 0 ? apsLimboDroids[0] : nullptr;
+		default: return nullptr;
+	}
+}
+
+/// Which of the indexed lists objList[player] is, or -1 if none.
+static int objIdIndexList(void const *objList, int player)
+{
+	for (int list = 0; list < OBJ_INDEX_LISTS; ++list)
+	{
+		void const *lists[OBJ_INDEX_LISTS] = {apsDroidLists, apsStructLists, apsFeatureLists, mission.apsDroidLists, mission.apsStructLists, mission.apsFeatureLists, apsLimboDroids};
+
+		if (objList == lists[list])
+		{
+			bool onlyPlayerZero = list == 2 || list == 5 || list == 6;
+			return !onlyPlayerZero || player == 0 ? list : -1;
+		}
+	}
+
+	return -1;
+}
+
+static void objIdIndexInsert(BASE_OBJECT *psObj, int list, int player, bool cargo)
+{
+	OBJECT_ID_ENTRY entry = {psObj, uint8_t(list), uint8_t(player), cargo, false};
+	auto it = objIdIndex.insert(std::make_pair(psObj->id, entry));
+
+	if (!it.second && it.first->second.psObj != psObj)
+	{
+		it.first->second.ambiguous = true;  // Keep the first one found, as getBaseObjFromId() does.
+	}
+}
+
+static void objIdIndexRebuild()
+{
+	objIdIndex.clear();
+
+	for (int list = 0; list < OBJ_INDEX_LISTS; ++list)
+	{
+		for (int player = 0; player < MAX_PLAYERS; ++player)
+		{
+			objIdIndexHeads[list][player] = objIdIndexHead(list, player);
+
+			for (BASE_OBJECT *psObj = objIdIndexHeads[list][player]; psObj != nullptr; psObj = psObj->psNext)
+			{
+				objIdIndexInsert(psObj, list, player, false);
+
+				if (psObj->type == OBJ_DROID && isTransporter((DROID *)psObj) && ((DROID *)psObj)->psGroup != nullptr)
+				{
+					for (DROID *psTrans = ((DROID *)psObj)->psGroup->psList; psTrans != nullptr; psTrans = psTrans->psGrpNext)
+					{
+						objIdIndexInsert(psTrans, list, player, true);
+					}
+				}
+			}
+		}
+	}
+
+	objIdIndexValid = true;
+}
+
+void objIdIndexInvalidate()
+{
+	objIdIndexValid = false;
+}
+
+/// Call before changing objList[player], with the head it had before the change.
+static bool objIdIndexChanging(int list, int player, BASE_OBJECT *psOldHead, BASE_OBJECT *psObj)
+{
+	if (!objIdIndexValid || list < 0)
+	{
+		return false;
+	}
+
+	if (objIdIndexHeads[list][player] != psOldHead || (psObj->type == OBJ_DROID && isTransporter((DROID *)psObj)))
+	{
+		objIdIndexValid = false;  // List changed behind our back, or carrying cargo which would move with it.
+		return false;
+	}
+
+	return true;
+}
+
+/// Call after adding psObj to objList[player].
+static void objIdIndexAdded(void const *objList, int player, BASE_OBJECT *psOldHead, BASE_OBJECT *psObj)
+{
+	const int list = objIdIndexList(objList, player);
+
+	if (objIdIndexChanging(list, player, psOldHead, psObj))
+	{
+		objIdIndexHeads[list][player] = objIdIndexHead(list, player);
+
+		if (objIdIndex.count(psObj->id) != 0)
+		{
+			objIdIndexValid = false;  // Which one getBaseObjFromId() finds first depends on where they are.
+			return;
+		}
+
+		objIdIndexInsert(psObj, list, player, false);
+	}
+}
+
+/// Call after removing psObj from objList[player].
+static void objIdIndexRemoved(void const *objList, int player, BASE_OBJECT *psOldHead, BASE_OBJECT *psObj)
+{
+	const int list = objIdIndexList(objList, player);
+
+	if (objIdIndexChanging(list, player, psOldHead, psObj))
+	{
+		objIdIndexHeads[list][player] = objIdIndexHead(list, player);
+		auto it = objIdIndex.find(psObj->id);
+
+		if (it == objIdIndex.end() || it->second.psObj != psObj || it->second.ambiguous || it->second.cargo)
+		{
+			objIdIndexValid = false;
+			return;
+		}
+
+		objIdIndex.erase(it);
+	}
+}
+
+bool objIdIndexLookup(uint32_t id, unsigned lists, int player, bool cargo, BASE_OBJECT **ppsObj)
+{
+	bool valid = objIdIndexValid;
+
+	for (int list = 0; list < OBJ_INDEX_LISTS && valid; ++list)
+	{
+		for (int i = 0; i < MAX_PLAYERS && valid; ++i)
+		{
+			valid = objIdIndexHeads[list][i] == objIdIndexHead(list, i);
+		}
+	}
+
+	if (!valid)
+	{
+		objIdIndexRebuild();
+	}
+
+	*ppsObj = nullptr;
+	auto it = objIdIndex.find(id);
+
+	if (it == objIdIndex.end())
+	{
+		return true;
+	}
+
+	OBJECT_ID_ENTRY const &entry = it->second;
+
+	if (entry.ambiguous)
+	{
+		return false;
+	}
+
+	if ((lists & (1 << entry.list)) != 0 && (player < 0 || entry.player == player) && (cargo || !entry.cargo))
+	{
+		*ppsObj = entry.psObj;
+	}
+
+	return true;
+}
+
 /* Add the object to its list
  * \param list is a pointer to the object list
  */
@@ -268,8 +466,10 @@ static inline void addObjectToList(OBJECT *list[], OBJECT *object, int player)
 	ASSERT_OR_RETURN(, object != nullptr, "Invalid pointer");
 
 	// Prepend the object to the top of the list
+	BASE_OBJECT *psOldHead = list[player];
 	object->psNext = list[player];
 	list[player] = object;
+	objIdIndexAdded(list, player, psOldHead, object);
 }
 
 /* Add the object to its list
@@ -296,10 +496,13 @@ static inline void destroyObject(OBJECT *list[], OBJECT *object)
 	ASSERT_OR_RETURN(, object != nullptr, "Invalid pointer");
 	ASSERT(gameTime - deltaGameTime <= gameTime || gameTime == 2, "Expected %u <= %u, bad time", gameTime - deltaGameTime, gameTime);
 
+	BASE_OBJECT *psOldHead = list[object->player];
+
 	// If the message to remove is the first one in the list then mark the next one as the first
 	if (list[object->player] == object)
 	{
 		list[object->player] = list[object->player]->psNext;
+		objIdIndexRemoved(list, object->player, psOldHead, object);
 		object->psNext = psDestroyedObj;
 		psDestroyedObj = (BASE_OBJECT *)object;
 		object->died = gameTime;
@@ -322,6 +525,7 @@ static inline void destroyObject(OBJECT *list[], OBJECT *object)
 		// Modify the "next" pointer of the previous item to
 		// point to the "next" item of the item to delete.
 		psPrev->psNext = psCurr->psNext;
+		objIdIndexRemoved(list, object->player, psOldHead, object);
 
 		// Prepend the object to the destruction list
 		object->psNext = psDestroyedObj;
@@ -344,10 +548,13 @@ static inline void removeObjectFromList(OBJECT *list[], OBJECT *object, int play
 {
 	ASSERT_OR_RETURN(, object != nullptr, "Invalid pointer");
 
+	BASE_OBJECT *psOldHead = list[player];
+
 	// If the message to remove is the first one in the list then mark the next one as the first
 	if (list[player] == object)
 	{
 		list[player] = list[player]->psNext;
+		objIdIndexRemoved(list, player, psOldHead, object);
 		return;
 	}
 
@@ -364,6 +571,7 @@ static inline void removeObjectFromList(OBJECT *list[], OBJECT *object, int play
 	// Modify the "next" pointer of the previous item to
 	// point to the "next" item of the item to delete.
 	psPrev->psNext = psCurr->psNext;
+	objIdIndexRemoved(list, player, psOldHead, object);
 }
 
 /* Remove an object from the relevant function list. An object can only be in one function list at a time!
@@ -808,6 +1016,16 @@ BASE_OBJECT *getBaseObjFromData(unsigned id, unsigned player, OBJECT_TYPE type)
 	BASE_OBJECT		*psObj;
 	DROID			*psTrans;
 
+	const unsigned lists = type == OBJ_DROID ? OBJLIST_DROIDS | OBJLIST_MISSION_DROIDS | OBJLIST_LIMBO_DROIDS :
+	                       type == OBJ_STRUCTURE ? OBJLIST_STRUCTURES | OBJLIST_MISSION_STRUCTURES :
+	                       type == OBJ_FEATURE ? OBJLIST_FEATURES | OBJLIST_MISSION_FEATURES : 0;
+
+	if (player < MAX_PLAYERS && objIdIndexLookup(id, lists, type == OBJ_FEATURE ? -1 : player, true, &psObj))
+	{
+		ASSERT(psObj != nullptr, "failed to find id %d for player %d", id, player);
+		return psObj;
+	}
+
 	for (int i = 0; i < 3; ++i)
 	{
 		psObj = nullptr;
@@ -900,6 +1118,12 @@ BASE_OBJECT *getBaseObjFromId(UDWORD id)
 	BASE_OBJECT		*psObj;
 	DROID			*psTrans;
 
+	if (objIdIndexLookup(id, OBJLIST_ALL, -1, true, &psObj))
+	{
+		ASSERT(psObj != nullptr, "getBaseObjFromId() failed for id %d", id);
+		return psObj;
+	}
+
 	for (i = 0; i < 7; ++i)
 	{
 		for (player = 0; player < MAX_PLAYERS; ++player)
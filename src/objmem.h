@@ -103,6 +103,23 @@ void removeFlagPosition(FLAG_POSITION *psDel);
 void freeAllFlagPositions();
 void freeAllAssemblyPoints();
 
+/* The object lists covered by objIdIndexLookup(), in the order getBaseObjFromId() searches them */
+#define OBJLIST_DROIDS                  0x01
+#define OBJLIST_STRUCTURES              0x02
+#define OBJLIST_FEATURES                0x04    ///< Only apsFeatureLists[0]
+#define OBJLIST_MISSION_DROIDS          0x08
+#define OBJLIST_MISSION_STRUCTURES      0x10
+#define OBJLIST_MISSION_FEATURES        0x20    ///< Only mission.apsFeatureLists[0]
+#define OBJLIST_LIMBO_DROIDS            0x40    ///< Only apsLimboDroids[0]
+#define OBJLIST_ALL                     0x7f
+
+/// Finds the object with the given id, if it is in one of the given lists (OBJLIST_* bits), for the given player, or any
+/// player if negative. With cargo, droids carried by transporters in those lists count too. Sets *ppsObj to the object
+/// or nullptr, and returns true, unless several objects have that id, in which case the caller has to search the lists.
+bool objIdIndexLookup(uint32_t id, unsigned lists, int player, bool cargo, BASE_OBJECT **ppsObj);
+/// Makes objIdIndexLookup() rebuild its index. Needed when transporters are loaded or unloaded.
+void objIdIndexInvalidate();
+
 // Find a base object from it's id
 BASE_OBJECT *getBaseObjFromData(unsigned id, unsigned player, OBJECT_TYPE type);
 BASE_OBJECT *getBaseObjFromId(UDWORD id);
@@ -0,0 +1,90 @@
+open Interface
+
+(* Functions called every tick, resolved once at startup instead of on every call *)
+let getMaxPlayers = funer "getMaxPlayers" (void @-> returning int)
+let droidUpdate = funer "droidUpdate" (ptr void @-> returning void)
+let syncDebugDroid = funer "syncDebugDroid" (ptr void @-> char @-> returning void)
+let missionDroidUpdate = funer "missionDroidUpdate" (ptr void @-> returning void)
+let structureUpdate = funer "structureUpdate" (ptr void @-> bool @-> returning void)
+let updateCurrentPower = funer "updateCurrentPower" (ptr void @-> int @-> int @-> returning void)
+let setSatUplinkExists = funer "setSatUplinkExists" (bool @-> int @-> returning void)
+let setLasSatExists = funer "setLasSatExists" (bool @-> int @-> returning void)
+let setNumDroids = funer "setNumDroids" (int @-> int @-> returning void)
+let setNumMissionDroids = funer "setNumMissionDroids" (int @-> int @-> returning void)
+let setNumConstructorDroids = funer "setNumConstructorDroids" (int @-> int @-> returning void)
+let setNumCommandDroids = funer "setNumCommandDroids" (int @-> int @-> returning void)
+let recvMessage = funer "recvMessage" vv
+let gameTimeUpdate = funer "gameTimeUpdate" (bool @-> returning void)
+let renderLoop = funer "renderLoop" (void @-> returning int)
+let netflush = funer "NETflush" vv
+let gameStatePreUpdate = funer "gameStatePreUpdate" vv
+let gameStatePostUpdate = funer "gameStatePostUpdate" vv
+let realTimeUpdate = funer "realTimeUpdate" vv
+let countFps = funer "countFps" vv
+let replaySkipRender = funer "replaySkipRender" vb
+let benchmarkEnabled = funer "benchmark_enabled" vb
+let benchmarkDone = funer "benchmarkDone" vb
+
+(* Mirrors OBJECT_SNAPSHOT in src/loop.h *)
+type snapshot
+let snapshot : snapshot structure typ = structure "OBJECT_SNAPSHOT"
+let s_pointer = field snapshot "pointer" (ptr void)
+let s_id = field snapshot "id" int32_t
+let s_objType = field snapshot "objType" int32_t
+let s_typ = field snapshot "type" int32_t
+let s_status = field snapshot "status" int32_t
+let s_player = field snapshot "player" int32_t
+let s_list = field snapshot "list" int32_t
+let s_carrier = field snapshot "carrier" int32_t
+let s_flags = field snapshot "flags" int32_t
+let () = seal snapshot
+let () = (* A field added on one side only would make every record after the first unreadable *)
+  let size = funer "getObjectSnapshotSize" (void @-> returning int) () in
+  if size <> sizeof snapshot
+  then failwith (Printf.sprintf "OBJECT_SNAPSHOT is %d bytes in C but %d in bindings.ml" size (sizeof snapshot))
+
+let obj_droid = 0
+let obj_structure = 1
+let flag_lassat = 0x01
+
+type obj = {
+  pointer : unit Ctypes_static.ptr;
+  id : int;
+  objType : int;
+  typ : int;
+  status : int;
+  player : int;
+  list : int;
+  carrier : int;
+  flags : int;
+}
+
+let getObjectSnapshot = funer "getObjectSnapshot" (ptr snapshot @-> int @-> returning int)
+
+(* Reused between calls, grown when there are more objects than fit *)
+let buffer = ref (CArray.make snapshot 1024)
+
+(* All droids and structures, in the order described at getObjectSnapshot, with one call into C *)
+let objects () : obj array =
+  let fill () = getObjectSnapshot (CArray.start !buffer) (CArray.length !buffer) in
+  let count = fill () in
+  let count =
+    if count > CArray.length !buffer
+    then begin
+      buffer := CArray.make snapshot (2 * count);
+      fill ()
+    end
+    else count
+  in
+  let get field record = getf record field |> Int32.to_int in
+  Array.init count (fun i ->
+      let record = CArray.get !buffer i in
+      {pointer = getf record s_pointer;
+       id = get s_id record;
+       objType = get s_objType record;
+       typ = get s_typ record;
+       status = get s_status record;
+       player = get s_player record;
+       list = get s_list record;
+       carrier = get s_carrier record;
+       flags = get s_flags record})
@@ -56,7 +56,11 @@ let init () =
       push display.dm_w display.dm_h hertz i
     ) displayList;
   (*List.map (fun i -> Sdl.get_current_display_mode i >>= id) displays*)
-  let flags = Sdl.Window.(opengl + shown) in
+  let flags = (* Benchmarks never render, so there is nothing to show *)
+    if funer "benchmark_enabled" vb ()
+    then Sdl.Window.(opengl + hidden)
+    else Sdl.Window.(opengl + shown)
+  in
   let flags =
     if funer "getFullscreen" (void @-> returning bool) ()
     then Sdl.Window.(flags + fullscreen)
@@ -33,11 +33,9 @@ type status =
   | BP_Planned
   | BP_Planned_Ally
 
-type t = {id : int; typ : typ; pointer : (unit Ctypes_static.ptr); status : status}
+type t = {id : int; typ : typ; pointer : (unit Ctypes_static.ptr); status : status; lasSat : bool}
 
-let getStatus t =
-  let state = funer "getBuildingStatus" (ptr void @-> returning int) t in
-  match state with
+let getStatus = function
   | 0 -> BeingBuilt
   | 1 -> Built
   | 2 -> BP_Valid
@@ -46,9 +44,7 @@ let getStatus t =
   | 5 -> BP_Planned_Ally
   | _ -> raise Not_found
 
-let rec getType t =
-  let f = funer "getBuildingType" (ptr void @-> returning int) in
-  match f t with
+let getType = function
   | 0 -> HQ
   | 1 -> Factory
   | 2 -> FactoryModule
@@ -73,23 +69,22 @@ let rec getType t =
   | 21 -> SatUplink
   | 22 -> Gate
   | _ -> raise Not_found
-and getBuilding t =
-  let id = funer "getBuildingId" (ptr void @-> returning int) t in
-  let typ = getType t in
-  let status = getStatus t in
-  {id; typ; pointer = t; status}
 
-let getList id list =
-  let getList = funer "getBuildingList" (int @-> int @-> returning (ptr_opt void)) in
-  let rec f l =
-    match getList id l with
-    | Some x -> getBuilding x :: f 0
-    | None -> []
-  in
-  f list
+let getBuilding {Bindings.id; typ; pointer; status; flags; _} =
+  {id; typ = getType typ; pointer; status = getStatus status; lasSat = flags land Bindings.flag_lassat <> 0}
+
+let getSnapshotList (objects : Bindings.obj array) id list =
+  let buildings = ref [] in
+  Array.iter (fun (o : Bindings.obj) ->
+      if o.Bindings.objType = Bindings.obj_structure && o.Bindings.list = list && o.Bindings.player = id
+      then buildings := getBuilding o :: !buildings) objects;
+  List.rev !buildings
+
+let getList id list = getSnapshotList (Bindings.objects ()) id list
 
 let _privateGetList () =
-  let get list id = getList id list in
+  let objects = Bindings.objects () in
+  let get list id = getSnapshotList objects id list in
   let buildings = Player.map (fun id -> (1,id),get 1 id) :: Player.map (fun id -> (2,id),get 2 id) :: [] in
   buildings
 |> List.flatten
@@ -114,4 +109,4 @@ let iter f = apply (List.iter f)
 let fold f acc = apply (List.fold_left f acc)
 
 let update {pointer; _} is_mission =
-  funer "structureUpdate" (ptr void @-> bool @-> returning void) pointer is_mission
+  Bindings.structureUpdate pointer is_mission
@@ -35,45 +35,54 @@ let map_list_types : list_type -> int = function
 type entry = (list_type * int) * t list
 
 
-let rec get_group t =
-  match funer "getDroidGroup" (ptr void @-> returning (ptr_opt void)) t with
-  | Some x -> get_droid x :: get_group (from_voidp void null)
-  | None -> []
-and get_type t =
-  let f = funer "getDroidType" (ptr void @-> returning int) in
-  match f t with
+let get_type cargo = function
   | 0 -> Weapon
   | 1 -> Sensor
   | 2 -> ECM
   | 3 -> Construct
   | 4 -> Person
   | 5 -> Cyborg
-  | 6 -> Transporter (get_group t)
+  | 6 -> Transporter cargo
   | 7 -> Command
   | 8 -> Repair
   | 9 -> Default
   | 10 -> CyborgConstruct
   | 11 -> CyborgRepair
   | 12 -> CyborgSuper
-  | 13 -> Supertransporter (get_group t)
+  | 13 -> Supertransporter cargo
   | 14 -> Any
   | _ -> raise Not_found
-and get_droid t =
-  let id = funer "getDroidId" (ptr void @-> returning int) t in
-  let typ = get_type t in
-  {id; typ; pointer = t}
-
-let get_list lists id =
-  let get_list = funer "getDroidList" (int @-> int @-> returning (ptr_opt void)) in
-  let rec f l =
-    match get_list id l with
-    | Some x -> get_droid x :: f 0
-    | None -> []
+
+(* The droid at index i of a snapshot, with its cargo if it is a transporter.
+   The cargo records directly follow their transporter. *)
+let get_droid (objects : Bindings.obj array) i =
+  let rec get_cargo j =
+    if j < Array.length objects && objects.(j).Bindings.carrier = i
+    then let {Bindings.id; typ; pointer; _} = objects.(j) in
+      {id; typ = get_type [] typ; pointer} :: get_cargo (j + 1)
+    else []
+  in
+  let {Bindings.id; typ; pointer; _} = objects.(i) in
+  let cargo = match typ with
+    | 6 | 13 -> get_cargo (i + 1)
+    | _ -> []
+  in
+  {id; typ = get_type cargo typ; pointer}
+
+let get_snapshot_list (objects : Bindings.obj array) lists id =
+  let f l =
+    let droids = ref [] in
+    Array.iteri (fun i {Bindings.objType; list; player; carrier; _} ->
+        if objType = Bindings.obj_droid && list = l && player = id && carrier = -1
+        then droids := get_droid objects i :: !droids) objects;
+    List.rev !droids
   in
   List.map map_list_types lists
   |> List.map f
   |> List.flatten
 
+let get_list lists id = get_snapshot_list (Bindings.objects ()) lists id
+
 let get_assoc () : entry list =
   let worker (acc : t list) (droid : t) =
     let next_entry = match droid with
@@ -82,9 +91,10 @@ let get_assoc () : entry list =
     in
     next_entry @ acc
   in
-  Player.map (fun id -> (Main,id), get_list [Main] id)
-  @ Player.map (fun id -> (Mission,id), get_list [Mission] id)
-  @ Player.map (fun id -> (Limbo,id), get_list [Limbo] id)
+  let objects = Bindings.objects () in
+  Player.map (fun id -> (Main,id), get_snapshot_list objects [Main] id)
+  @ Player.map (fun id -> (Mission,id), get_snapshot_list objects [Mission] id)
+  @ Player.map (fun id -> (Limbo,id), get_snapshot_list objects [Limbo] id)
   |> List.map (fun (key,droids) -> key,List.fold_left worker [] droids)
 
 let apply_assoc (f : entry list -> 'a) =
@@ -106,8 +116,8 @@ let iter f = apply (List.iter f)
 let fold f acc = apply (List.fold_left f acc)
 
 let update {pointer; _} =
-  funer "syncDebugDroid" (ptr void @-> char @-> returning void) pointer '<';
-  funer "droidUpdate" (ptr void @-> returning void) pointer
+  Bindings.syncDebugDroid pointer '<';
+  Bindings.droidUpdate pointer
 
 let update_mission {pointer; _} =
-  funer "missionDroidUpdate" (ptr void @-> returning void) pointer
+  Bindings.missionDroidUpdate pointer
@@ -1,12 +1,12 @@
 open Interface
 
 let updateCounts () =
-  let setSatUplink i b = funer "setSatUplinkExists" (bool @-> int @-> returning void) b i in
-  let setLasSat i b = funer "setLasSatExists" (bool @-> int @-> returning void) b i in
-  let setNumDroids = funer "setNumDroids" (int @-> int @-> returning void) in
-  let setNumMissionDroids = funer "setNumMissionDroids" (int @-> int @-> returning void) in
-  let setNumConstructor = funer "setNumConstructorDroids" (int @-> int @-> returning void) in
-  let setNumCommand = funer "setNumCommandDroids" (int @-> int @-> returning void) in
+  let setSatUplink i b = Bindings.setSatUplinkExists b i in
+  let setLasSat i b = Bindings.setLasSatExists b i in
+  let setNumDroids = Bindings.setNumDroids in
+  let setNumMissionDroids = Bindings.setNumMissionDroids in
+  let setNumConstructor = Bindings.setNumConstructorDroids in
+  let setNumCommand = Bindings.setNumCommandDroids in
 
   let count pattern droids =
     (* Check whether the passed object matches at least one element of the pattern list*)
@@ -38,7 +38,7 @@ let updateCounts () =
     List.exists isUplink buildings
   in
   let lasSatExists buildings = (* No check for build-progress because only one lasSat can exist at a time *)
-    let isLasSat ({pointer; _} : Building.t) = funer "isLasSat" (ptr void @-> returning bool) pointer in
+    let isLasSat ({lasSat; _} : Building.t) = lasSat in
     List.exists isLasSat buildings
   in
 
@@ -49,13 +49,11 @@ let updateCounts () =
 
 (* Renderbudget represents the balance between gamelogic and rendering. Every gameworldupdate reduces the budget until empty and every render increases it.*)
 let gameLoop (lastFlush) : int * int =
-  let recvMessage = funer "recvMessage" vv in
-  let gameTimeUpdate = funer "gameTimeUpdate" (bool @-> returning void) in
-  let renderLoop = funer "renderLoop" (void @-> returning int) in
-  let netflush = funer "NETflush" vv in
-  let getDeltaGameTime = funer "getDeltaGameTime" (void @-> returning int) in
-  let setDeltaGameTime = funer "setDeltaGameTime" (int @-> returning void) in
-  let gameStatePreUpdate = funer "gameStatePreUpdate" vv in
+  let recvMessage = Bindings.recvMessage in
+  let gameTimeUpdate = Bindings.gameTimeUpdate in
+  let renderLoop = Bindings.renderLoop in
+  let netflush = Bindings.netflush in
+  let gameStatePreUpdate = Bindings.gameStatePreUpdate in
   let gameStateUpdate () =
     Droid.iter_assoc (function
         | ((Main,_),droids) -> List.iter (fun droid -> Droid.update droid) droids
@@ -66,10 +64,10 @@ let gameLoop (lastFlush) : int * int =
     Building.iterAssoc (function
         | ((l,_),buildings) -> List.iter (fun building -> Building.update building (l = 2)) buildings);
   in
-  let gameStatePostUpdate = funer "gameStatePostUpdate" vv in
+  let gameStatePostUpdate = Bindings.gameStatePostUpdate in
 
   let updatePower id = (*FIXME this does check all buildings, also those offworld :-: Why? It only uses list 1 *)
-    let updateCurrentPower = funer "updateCurrentPower" (ptr void @-> int @-> int @-> returning void) in
+    let updateCurrentPower = Bindings.updateCurrentPower in
     let buildings = Building.getList id 1 in
     List.iter (fun ({typ; status; pointer; _} : Building.t) -> match typ,status with
         | Generator,Built -> updateCurrentPower pointer id 1
@@ -97,6 +95,10 @@ let gameLoop (lastFlush) : int * int =
     end
     else lastFlush
   in
-  let renderReturn = renderLoop () in
+  let renderReturn = (* Fast-forwarded replays only render now and then, benchmarks never *)
+    if Bindings.benchmarkEnabled () || Bindings.replaySkipRender ()
+    then 1 (* Running *)
+    else renderLoop ()
+  in
   (renderReturn,newLastFlush)
 
@@ -73,6 +73,10 @@ let handleMenuChanges game_state = (* Check if the player starts or loads a game
 
 let handleGameChanges game_state =
   let (state,last_flush) = Game.gameLoop game_state in
+  if Bindings.benchmarkDone () then begin (* All ticks are run and the timings printed *)
+    stopGameLoop ();
+    raise Exit
+  end;
   let new_mode = match state |> get_state with
   | Running | Viewing -> Game
   | Quitting ->
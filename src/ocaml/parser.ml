@@ -11,6 +11,10 @@ let specList =
     let dbgflush = funer "debugFlushStderr" vv in
     let fs () = (funer "setFullscreen" (bool @-> returning void)) true in
     let autogame = funer "autogame" vv in
+    let replay = funer "setReplay" sv in
+    let replayfast = funer "setReplayFast" sv in
+    let skirmish = funer "setSkirmish" sv in
+    let benchmark = funer "setBenchmark" (int @-> returning void) in
 
   [
     ("-configdir", String cd, "Set configuration directory");
@@ -33,8 +37,11 @@ let specList =
     ("-join", Unit todo, "Connect directly to IP/hostname");
     ("-host", Unit todo, "Go directly to host screen");
     ("-autogame", Unit autogame, "Run games automatically for testing");
+    ("-replay", String replay, "Play back a recorded game, such as replay/<file>.wzrp");
+    ("-replayfast", String replayfast, "Play back a recorded game as fast as possible, rendering only occasionally");
+    ("-benchmark", Int benchmark, "Run the given number of ticks of the -skirmish or -replay game without rendering, print the time taken and quit (still needs a GL context, e.g. Mesa under Xvfb)");
     ("-saveandquit", Unit todo, "Immediately save game and quit");
-    ("-skirmish", Unit todo, "Start skirmish game with given settings file");
+    ("-skirmish", String skirmish, "Start skirmish game with given settings file, such as highground.json from tests/");
   ]
 
 let parse () = Arg.parse specList (fun _ -> Printf.fprintf stderr "Invalid argument") "Warzone2100:\nArguments"
@@ -2,7 +2,7 @@ open Interface
 
 type t = {id : int}
 
-let amount () = funer "getMaxPlayers" (void @-> returning int) ()
+let amount () = Bindings.getMaxPlayers ()
 
 let apply f =
   List.init (amount ()) (fun id -> id)
@@ -10,6 +10,6 @@ let units_per_update = units_per_second / ticks_per_second
 let current_time () = Tsdl.Sdl.get_ticks () |> Int32.to_int
 
 let update () =
-  funer "realTimeUpdate" vv ();
-  funer "countFps" vv ();
+  Bindings.realTimeUpdate ();
+  Bindings.countFps ();
   ()
@@ -29,6 +29,7 @@
 #include "lib/framework/trig.h"
 #include "lib/framework/fixedpoint.h"
 #include "lib/framework/math_ext.h"
+#include "lib/framework/slabpool.h"
 #include "lib/gamelib/gtime.h"
 #include "lib/sound/audio_id.h"
 #include "lib/sound/audio.h"
@@ -82,9 +83,12 @@ struct INTERVAL
 // used to create a specific ID for projectile objects to facilitate tracking them.
 static const UDWORD ProjectileTrackerID =	0xdead0000;
 
-/* The list of projectiles in play */
+/* The list of projectiles in play, oldest first */
 static std::vector<PROJECTILE *> psProjectileList;
 
+/* Storage for the projectiles in psProjectileList */
+static SlabPool<PROJECTILE> projectilePool;
+
 /* The next projectile to give out in the proj_First / proj_Next methods */
 static ProjectileIterator psProjectileNext;
 
@@ -117,6 +121,29 @@ static void proj_checkPeriodicalDamage(PROJECTILE *psProj);
 
 static int32_t objectDamage(BASE_OBJECT *psObj, unsigned damage, WEAPON_CLASS weaponClass, WEAPON_SUBCLASS weaponSubClass, unsigned impactTime, bool isDamagePerSecond, int minDamage);
 
+/// Where an object in the grid is during proj_UpdateAll(), to quickly rule out projectiles hitting it.
+/// Objects don't move while projectiles are updated, so this is only worked out once per update.
+struct ProjectileTarget
+{
+	BASE_OBJECT *psObj;
+	Vector2i     gridPos;  ///< Position when the grid was reset, which is what gridFindObjects() looks at.
+	Vector2i     pos;
+	Vector2i     prevPos;
+	int32_t      extent;   ///< Larger of the half width and half breadth of the object's shape.
+};
+
+/// The possible targets in one cell of the object grid.
+struct ProjectileTargetCell
+{
+	unsigned     update = 0;  ///< Value of targetUpdate when the targets were filled in.
+	std::vector<ProjectileTarget> targets;  ///< In grid order, so that the closest hit is chosen the same way as before.
+	Vector2i     min, max;    ///< Bounds of the targets' shapes, over the whole update.
+	int32_t      maxMotion;   ///< Largest |dx| + |dy| of a target during the update.
+};
+
+static std::vector<ProjectileTargetCell> targetCells;
+static unsigned targetUpdate = 0;
+
 
 static inline void setProjectileDestination(PROJECTILE *psProj, BASE_OBJECT *psObj)
 {
@@ -214,6 +241,10 @@ proj_InitSystem()
 void
 proj_FreeAllProjectiles()
 {
+	for (PROJECTILE *psProj : psProjectileList)
+	{
+		delete psProj;
+	}
 	psProjectileList.clear();
 	psProjectileNext = psProjectileList.end();
 }
@@ -224,12 +255,32 @@ bool
 proj_Shutdown()
 {
 	proj_FreeAllProjectiles();
+	projectilePool.release();
 
 	return true;
 }
 
 /***************************************************************************/
 
+void *PROJECTILE::operator new(size_t size)
+{
+	ASSERT(size == sizeof(PROJECTILE), "Wrong size %u for a projectile", (unsigned)size);
+	return projectilePool.allocate();
+}
+
+void PROJECTILE::operator delete(void *p)
+{
+	projectilePool.deallocate(p);
+}
+
+PROJECTILE::~PROJECTILE()
+{
+	// The storage is soon reused by another projectile, which mustn't get this one's sounds.
+	audio_RemoveObj(this);
+}
+
+/***************************************************************************/
+
 // Reset the first/next methods, and give out the first projectile in the list.
 PROJECTILE *
 proj_GetFirst()
@@ -697,6 +748,63 @@ static int32_t collisionXYZ(Vector3i v1, Vector3i v2, ObjectShape shape, int32_t
 	return -1;
 }
 
+/// Returns the objects in the grid cell which projectiles could hit, filled in on first use in each update.
+static ProjectileTargetCell const &projGetTargetCell(int cellIndex)
+{
+	if (targetCells.size() != (size_t)gridCellCount())
+	{
+		targetCells.clear();  // New map.
+		targetCells.resize(gridCellCount());
+	}
+
+	ProjectileTargetCell &cell = targetCells[cellIndex];
+	if (cell.update == targetUpdate)
+	{
+		return cell;
+	}
+
+	cell.update = targetUpdate;
+	cell.targets.clear();
+	cell.min = Vector2i(INT32_MAX, INT32_MAX);
+	cell.max = Vector2i(INT32_MIN, INT32_MIN);
+	cell.maxMotion = 0;
+
+	for (GridEntry const &entry : gridCellEntries(cellIndex))
+	{
+		BASE_OBJECT *psObj = entry.psObj;
+
+		// Dead objects stay dead, and oil resources, artifacts and other pickups can't be damaged, so leave them out now.
+		if (psObj->died || (psObj->type == OBJ_FEATURE && !((FEATURE *)psObj)->psStats->damageable))
+		{
+			continue;
+		}
+
+		ProjectileTarget target;
+		target.psObj = psObj;
+		target.gridPos = Vector2i(entry.x, entry.y);
+		target.pos = psObj->pos.xy;
+		target.prevPos = isDroid(psObj) ? castDroid(psObj)->prevSpacetime.pos.xy : psObj->pos.xy;
+		ObjectShape shape = establishTargetShape(psObj);
+		target.extent = std::max(shape.size.x, shape.size.y);
+		cell.targets.push_back(target);
+
+		cell.min.x = std::min(cell.min.x, std::min(target.pos.x, target.prevPos.x) - target.extent);
+		cell.min.y = std::min(cell.min.y, std::min(target.pos.y, target.prevPos.y) - target.extent);
+		cell.max.x = std::max(cell.max.x, std::max(target.pos.x, target.prevPos.x) + target.extent);
+		cell.max.y = std::max(cell.max.y, std::max(target.pos.y, target.prevPos.y) + target.extent);
+		cell.maxMotion = std::max(cell.maxMotion, abs(target.pos.x - target.prevPos.x) + abs(target.pos.y - target.prevPos.y));
+	}
+
+	return cell;
+}
+
+/// Returns how far outside an object's shape, in x or y, collisionXYZ() may still report a hit, when the
+/// object and projectile move by a total of motion (|dx| + |dy|) relative to each other. It rounds times to 1/1024.
+static inline int32_t projCollisionSlack(int32_t motion)
+{
+	return motion / 512 + 2;
+}
+
 static void proj_InFlightFunc(PROJECTILE *psProj)
 {
 	/* we want a delay between Las-Sats firing and actually hitting in multiPlayer
@@ -833,63 +941,97 @@ static void proj_InFlightFunc(PROJECTILE *psProj)
 
 	closestCollisionSpacetime.time = 0xFFFFFFFF;
 
-	/* Check nearby objects for possible collisions */
-	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psProj->pos.x, psProj->pos.y, PROJ_NEIGHBOUR_RANGE);
-
-	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
-	{
-		BASE_OBJECT *psTempObj = *gi;
-		CHECK_OBJECT(psTempObj);
-
-		if (std::find(psProj->psDamaged.begin(), psProj->psDamaged.end(), psTempObj) != psProj->psDamaged.end())
+	/* Check nearby objects for possible collisions. This finds the same objects as
+	 * gridFindObjects(psProj->pos, PROJ_NEIGHBOUR_RANGE) in the same order, but skips
+	 * any cells and objects too far from the projectile's path this tick to be hit. */
+	const Vector2i projPrevPos = psProj->prevSpacetime.pos.xy;
+	const Vector2i projPos = psProj->pos.xy;
+	const int32_t projMotion = abs(projPos.x - projPrevPos.x) + abs(projPos.y - projPrevPos.y);
+	const Vector2i projMin(std::min(projPos.x, projPrevPos.x), std::min(projPos.y, projPrevPos.y));
+	const Vector2i projMax(std::max(projPos.x, projPrevPos.x), std::max(projPos.y, projPrevPos.y));
+	const Vector2i rangeMin = projPos - Vector2i(PROJ_NEIGHBOUR_RANGE, PROJ_NEIGHBOUR_RANGE);
+	const Vector2i rangeMax = projPos + Vector2i(PROJ_NEIGHBOUR_RANGE, PROJ_NEIGHBOUR_RANGE);
+	int cx1, cy1, cx2, cy2;
+	gridCellRange(rangeMin.x, rangeMin.y, rangeMax.x, rangeMax.y, cx1, cy1, cx2, cy2);
+
+	gridForEachCell(cx1, cy1, cx2, cy2, [&](int cx, int cy)
+	{
+		ProjectileTargetCell const &cell = projGetTargetCell(gridCellIndex(cx, cy));
+		const int32_t cellSlack = projCollisionSlack(projMotion + cell.maxMotion);
+
+		if (projMax.x + cellSlack < cell.min.x || projMin.x - cellSlack > cell.max.x ||
+		    projMax.y + cellSlack < cell.min.y || projMin.y - cellSlack > cell.max.y)
 		{
-			// Dont damage one target twice
-			continue;
+			return;  // Nothing in this cell is near the path (always true if the cell is empty).
 		}
-		else if (psTempObj->died)
-		{
-			// Do not damage dead objects further
-			continue;
-		}
-		else if (psTempObj->type == OBJ_FEATURE && !((FEATURE *)psTempObj)->psStats->damageable)
-		{
-			// Ignore oil resources, artifacts and other pickups
-			continue;
-		}
-		else if (aiCheckAlliances(psTempObj->player, psProj->player) && psTempObj != psProj->psDest)
-		{
-			// No friendly fire unless intentional
-			continue;
-		}
-		else if (!(psStats->surfaceToAir & SHOOT_ON_GROUND) &&
-		         (psTempObj->type == OBJ_STRUCTURE ||
-		          psTempObj->type == OBJ_FEATURE ||
-		          (psTempObj->type == OBJ_DROID && !isFlying((DROID *)psTempObj))
-		         ))
+
+		for (ProjectileTarget const &target : cell.targets)
 		{
-			// AA weapons should not hit buildings and non-vtol droids
-			continue;
-		}
+			// Same conditions as gridFindObjects().
+			const Vector2i fromCentre = target.pos - projPos;
+			if (target.gridPos.x < rangeMin.x || target.gridPos.x > rangeMax.x || target.gridPos.y < rangeMin.y || target.gridPos.y > rangeMax.y
+			    || (uint32_t)(fromCentre.x * fromCentre.x + fromCentre.y * fromCentre.y) > (uint32_t)(PROJ_NEIGHBOUR_RANGE * PROJ_NEIGHBOUR_RANGE))
+			{
+				continue;
+			}
 
-		Vector3i psTempObjPrevPos = isDroid(psTempObj) ? castDroid(psTempObj)->prevSpacetime.pos : psTempObj->pos;
+			// Rule out objects which the path relative to the object can't reach, before looking at the object itself.
+			const Vector2i relPrev = projPrevPos - target.prevPos;
+			const Vector2i rel = projPos - target.pos;
+			const int32_t reach = target.extent + projCollisionSlack(abs(rel.x - relPrev.x) + abs(rel.y - relPrev.y));
+			if (std::max(rel.x, relPrev.x) < -reach || std::min(rel.x, relPrev.x) > reach ||
+			    std::max(rel.y, relPrev.y) < -reach || std::min(rel.y, relPrev.y) > reach)
+			{
+				continue;
+			}
 
-		const Vector3i diff = psProj->pos - psTempObj->pos;
-		const Vector3i prevDiff = psProj->prevSpacetime.pos - psTempObjPrevPos;
-		const unsigned int targetHeight = establishTargetHeight(psTempObj);
-		const ObjectShape targetShape = establishTargetShape(psTempObj);
-		const int32_t collision = collisionXYZ(prevDiff, diff, targetShape, targetHeight);
-		const uint32_t collisionTime = psProj->prevSpacetime.time + (psProj->time - psProj->prevSpacetime.time) * collision / 1024;
+			BASE_OBJECT *psTempObj = target.psObj;
+			CHECK_OBJECT(psTempObj);
 
-		if (collision >= 0 && collisionTime < closestCollisionSpacetime.time)
-		{
-			// We hit!
-			closestCollisionSpacetime = interpolateObjectSpacetime(psProj, collisionTime);
-			closestCollisionObject = psTempObj;
+			if (std::find(psProj->psDamaged.begin(), psProj->psDamaged.end(), psTempObj) != psProj->psDamaged.end())
+			{
+				// Dont damage one target twice
+				continue;
+			}
+			else if (psTempObj->died)
+			{
+				// Do not damage dead objects further
+				continue;
+			}
+			else if (aiCheckAlliances(psTempObj->player, psProj->player) && psTempObj != psProj->psDest)
+			{
+				// No friendly fire unless intentional
+				continue;
+			}
+			else if (!(psStats->surfaceToAir & SHOOT_ON_GROUND) &&
+			         (psTempObj->type == OBJ_STRUCTURE ||
+			          psTempObj->type == OBJ_FEATURE ||
+			          (psTempObj->type == OBJ_DROID && !isFlying((DROID *)psTempObj))
+			         ))
+			{
+				// AA weapons should not hit buildings and non-vtol droids
+				continue;
+			}
+
+			Vector3i psTempObjPrevPos = isDroid(psTempObj) ? castDroid(psTempObj)->prevSpacetime.pos : psTempObj->pos;
+
+			const Vector3i diff = psProj->pos - psTempObj->pos;
+			const Vector3i prevDiff = psProj->prevSpacetime.pos - psTempObjPrevPos;
+			const unsigned int targetHeight = establishTargetHeight(psTempObj);
+			const ObjectShape targetShape = establishTargetShape(psTempObj);
+			const int32_t collision = collisionXYZ(prevDiff, diff, targetShape, targetHeight);
+			const uint32_t collisionTime = psProj->prevSpacetime.time + (psProj->time - psProj->prevSpacetime.time) * collision / 1024;
+
+			if (collision >= 0 && collisionTime < closestCollisionSpacetime.time)
+			{
+				// We hit!
+				closestCollisionSpacetime = interpolateObjectSpacetime(psProj, collisionTime);
+				closestCollisionObject = psTempObj;
 
-			// Keep testing for more collisions, in case there was a closer target.
+				// Keep testing for more collisions, in case there was a closer target.
+			}
 		}
-	}
+	});
 
 	unsigned terrainIntersectTime = map_LineIntersect(psProj->prevSpacetime.pos, psProj->pos, psProj->time - psProj->prevSpacetime.time);
 
@@ -1208,7 +1350,7 @@ static void proj_ImpactFunc(PROJECTILE *psObj)
 		psObj->born = gameTime;
 
 		static GridList gridList;  // static to avoid allocations.
-		gridList = gridStartIterate(psObj->pos.x, psObj->pos.y, psStats->upgrade[psObj->player].radius);
+		gridFindObjects(gridList, psObj->pos.x, psObj->pos.y, psStats->upgrade[psObj->player].radius);
 
 		for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 		{
@@ -1395,10 +1537,15 @@ void PROJECTILE::update()
 // iterate through all projectiles and update their status
 void proj_UpdateAll()
 {
-	std::vector<PROJECTILE *> psProjectileListOld = psProjectileList;
+	++targetUpdate;  // Objects have moved since the last update.
 
-	// Update all projectiles. Penetrating projectiles may add to psProjectileList.
-	std::for_each(psProjectileListOld.begin(), psProjectileListOld.end(), std::mem_fun(&PROJECTILE::update));
+	// Update all projectiles. Penetrating projectiles may add to psProjectileList, so index it
+	// rather than iterating, and leave the new ones (at the end) until the next tick.
+	size_t numOld = psProjectileList.size();
+	for (size_t i = 0; i < numOld; ++i)
+	{
+		psProjectileList[i]->update();
+	}
 
 	// Remove and free dead projectiles.
 	psProjectileList.erase(std::remove_if(psProjectileList.begin(), psProjectileList.end(), std::mem_fun(&PROJECTILE::deleteIfDead)), psProjectileList.end());
@@ -1416,7 +1563,7 @@ static void proj_checkPeriodicalDamage(PROJECTILE *psProj)
 	WEAPON_STATS *psStats = psProj->psWStats;
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(psProj->pos.x, psProj->pos.y, psStats->upgrade[psProj->player].periodicalDamageRadius);
+	gridFindObjects(gridList, psProj->pos.x, psProj->pos.y, psStats->upgrade[psProj->player].periodicalDamageRadius);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -41,6 +41,11 @@ enum PROJ_STATE
 struct PROJECTILE : public SIMPLE_OBJECT
 {
 	PROJECTILE(uint32_t id, unsigned player) : SIMPLE_OBJECT(OBJ_PROJECTILE, id, player) {}
+	~PROJECTILE();
+
+	/// Projectiles come from a pool in projectile.cpp, since many are created and destroyed every tick.
+	static void    *operator new(size_t size);
+	static void     operator delete(void *p);
 
 	void            update();
 	bool            deleteIfDead()
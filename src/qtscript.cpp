@@ -73,6 +73,7 @@
 #include "lib/framework/file.h"
 #include "lib/gamelib/gtime.h"
 #include "lib/netplay/netplay.h"
+#include "lib/script/script.h"
 #include "multiplay.h"
 #include "levels.h"
 #include "map.h"
@@ -82,7 +83,11 @@
 #include "mission.h"
 #include "modding.h"
 #include "version.h"
+#include "warzoneconfig.h"
 
+#include <algorithm>
+#include <climits>
+#include <map>
 #include <set>
 #include <utility>
 
@@ -100,7 +105,7 @@ extern bool doUpdateModels; // ugh-ly hack; fix with signal when moc-ing this fi
 
 enum timerType
 {
-	TIMER_REPEAT, TIMER_ONESHOT_READY, TIMER_ONESHOT_DONE
+	TIMER_REPEAT, TIMER_ONESHOT_READY, TIMER_ONESHOT_DONE  ///< TIMER_ONESHOT_DONE is only found in old savegames.
 };
 
 struct timerNode
@@ -115,23 +120,36 @@ struct timerNode
 	int player;
 	int calls;
 	timerType type;
-	timerNode() : engine(nullptr), baseobjtype(OBJ_NUM_TYPES) {}
+	unsigned seq;         ///< Order the timer was set in, to break ties between timers due at the same time.
+	bool removed;         ///< Set on a timer which is being run by updateScripts() when it is removed, so that it isn't set again.
+	timerNode() : engine(nullptr), baseobjtype(OBJ_NUM_TYPES), seq(0), removed(false) {}
 	timerNode(QScriptEngine *caller, QString val, int plr, int frame)
-		: function(std::move(val)), engine(caller), baseobj(-1), baseobjtype(OBJ_NUM_TYPES), frameTime(frame + gameTime), ms(frame), player(plr), calls(0), type(TIMER_REPEAT) {}
+		: function(std::move(val)), engine(caller), baseobj(-1), baseobjtype(OBJ_NUM_TYPES), frameTime(frame + gameTime), ms(frame), player(plr), calls(0), type(TIMER_REPEAT), seq(0), removed(false) {}
 	bool operator== (const timerNode &t)
 	{
 		return function == t.function && player == t.player;
 	}
-	// implement operator less TODO
+	/// For the heap of timers, true if t is due first.
+	bool operator< (const timerNode &t) const
+	{
+		return frameTime != t.frameTime ? frameTime > t.frameTime : seq > t.seq;
+	}
 };
 
 #define MAX_US 20000
 #define HALF_MAX_US 10000
 
-/// List of timer events for scripts. Before running them, we sort the list then run as many as we have time for.
-/// In this way, we implement load balancing of events and keep frame rates tidy for users. Since scripts run on the
-/// host, we do not need to worry about each peer simulating the world differently.
-static QList<timerNode> timers;
+/// Timer events for scripts, as a heap with the timer which is due first (oldest first if several) on top, so that
+/// each update only looks at the timers which are due. Timers of AI scripts can be spread over several updates, see
+/// war_SetScriptTimerBudget(). Only the client responsible for an AI runs its script, so that can't desynchronise.
+static std::vector<timerNode> timers;
+static unsigned timerSeq = 0;
+/// The timers which were due, while updateScripts() is running them. Removing one of these still lets it run this
+/// time, like a timer that has already been taken off the heap.
+static std::vector<timerNode> dueTimers;
+
+/// Scripts loaded with loadGlobalScript(), which run on all clients, so their timers are never put off.
+static std::set<QScriptEngine *> globalScripts;
 
 /// Scripting engine (what others call the scripting context, but QtScript's nomenclature is different).
 static QList<QScriptEngine *> scripts;
@@ -162,7 +180,8 @@ typedef struct monitor_bin
 	int overMaxTimeCalls;
 	int overHalfMaxTimeCalls;
 	uint64_t time;
-	monitor_bin() : worst(0),  worstGameTime(0), calls(0), overMaxTimeCalls(0), overHalfMaxTimeCalls(0), time(0) {}
+	uint64_t objects;  ///< Game objects, templates and research items converted for the script during the calls.
+	monitor_bin() : worst(0),  worstGameTime(0), calls(0), overMaxTimeCalls(0), overHalfMaxTimeCalls(0), time(0), objects(0) {}
 } MONITOR_BIN;
 typedef QHash<QString, MONITOR_BIN> MONITOR;
 static QHash<QScriptEngine *, MONITOR *> monitors;
@@ -212,9 +231,11 @@ static QScriptValue callFunction(QScriptEngine *engine, const QString &function,
 	}
 
 	QElapsedTimer timer;
+	uint64_t objects = convertedObjectCount();
 	timer.start();
 	QScriptValue result = value.call(QScriptValue(), args);
 	int ticks = timer.nsecsElapsed() / 1000;
+	objects = convertedObjectCount() - objects;
 	MONITOR *monitor = monitors.value(engine); // pick right one for this engine
 	MONITOR_BIN m;
 
@@ -242,6 +263,7 @@ static QScriptValue callFunction(QScriptEngine *engine, const QString &function,
 	}
 
 	m.time += ticks;
+	m.objects += objects;
 	monitor->insert(function, m);
 
 	if (engine->hasUncaughtException())
@@ -263,6 +285,45 @@ static QScriptValue callFunction(QScriptEngine *engine, const QString &function,
 	return result;
 }
 
+/// Adds a new timer, or puts a timer back after running it.
+static void addTimer(timerNode &node, bool isNew = true)
+{
+	if (isNew)
+	{
+		node.seq = timerSeq++;
+	}
+
+	timers.push_back(node);
+	std::push_heap(timers.begin(), timers.end());
+}
+
+/// Removes the timers for which condition(timer) is true. Returns the number removed.
+template <typename Condition>
+static int removeTimers(Condition const &condition)
+{
+	int removed = 0;
+
+	for (auto &node : dueTimers)
+	{
+		if (!node.removed && condition(node))
+		{
+			node.removed = true;
+			++removed;
+		}
+	}
+
+	auto end = std::remove_if(timers.begin(), timers.end(), condition);
+
+	if (end != timers.end())
+	{
+		removed += timers.end() - end;
+		timers.erase(end, timers.end());
+		std::make_heap(timers.begin(), timers.end());
+	}
+
+	return removed;
+}
+
 //-- ## setTimer(function, milliseconds[, object])
 //--
 //-- Set a function to run repeated at some given time interval. The function to run
@@ -308,7 +369,7 @@ static QScriptValue js_setTimer(QScriptContext *context, QScriptEngine *engine)
 	}
 
 	node.type = TIMER_REPEAT;
-	timers.push_back(node);
+	addTimer(node);
 	return QScriptValue();
 }
 
@@ -322,20 +383,27 @@ static QScriptValue js_removeTimer(QScriptContext *context, QScriptEngine *engin
 	SCRIPT_ASSERT(context, context->argument(0).isString(), "Timer functions must be quoted");
 	QString function = context->argument(0).toString();
 	int player = engine->globalObject().property("me").toInt32();
-	int i, size = timers.size();
 
-	for (i = 0; i < size; ++i)
-	{
-		timerNode node = timers.at(i);
+	// Remove the oldest matching timer.
+	unsigned oldest = UINT_MAX;
 
-		if (node.function == function && node.player == player)
+	for (auto const *list : {&dueTimers, &timers})
+	{
+		for (auto const &node : *list)
 		{
-			timers.removeAt(i);
-			break;
+			if (!node.removed && node.function == function && node.player == player)
+			{
+				oldest = std::min(oldest, node.seq);
+			}
 		}
 	}
 
-	if (i == size)
+	int removed = removeTimers([&](timerNode const &node)
+	{
+		return node.seq == oldest;
+	});
+
+	if (removed == 0)
 	{
 		// Friendly warning
 		QString warnName = function.left(15) + "...";
@@ -391,7 +459,7 @@ static QScriptValue js_queue(QScriptContext *context, QScriptEngine *engine)
 	}
 
 	node.type = TIMER_ONESHOT_READY;
-	timers.push_back(node);
+	addTimer(node);
 	return QScriptValue();
 }
 
@@ -418,19 +486,10 @@ static QScriptValue js_profile(QScriptContext *context, QScriptEngine *engine)
 void scriptRemoveObject(BASE_OBJECT *psObj)
 {
 	// Weed out timers with dead objects
-	for (int i = 0; i < timers.count();)
+	removeTimers([&](timerNode const &node)
 	{
-		const timerNode node = timers.at(i);
-
-		if (node.baseobj == psObj->id)
-		{
-			timers.removeAt(i);
-		}
-		else
-		{
-			i++;
-		}
-	}
+		return node.baseobj == (int)psObj->id;
+	});
 
 	groupRemoveObject(psObj);
 }
@@ -527,6 +586,68 @@ bool prepareScripts(bool loadGame)
 	return true;
 }
 
+/// Writes the time taken by each script function and legacy script event this game to logs/scriptprofile.json.
+static void saveProfile()
+{
+	nlohmann::json profile = nlohmann::json::object();
+	nlohmann::json engines = nlohmann::json::array();
+
+	for (auto *engine : scripts)
+	{
+		MONITOR *monitor = monitors.value(engine);
+		nlohmann::json functions = nlohmann::json::object();
+
+		for (MONITOR::const_iterator iter = monitor->constBegin(); iter != monitor->constEnd(); ++iter)
+		{
+			const MONITOR_BIN &m = iter.value();
+			functions[iter.key().toUtf8().constData()] = {
+				{"calls", m.calls},
+				{"time", m.time},
+				{"worst", m.worst},
+				{"worstGameTime", m.worstGameTime},
+				{"overLimit", m.overMaxTimeCalls},
+				{"overHalfLimit", m.overHalfMaxTimeCalls},
+				{"objects", m.objects}
+			};
+		}
+
+		if (!functions.empty())
+		{
+			engines.push_back({
+				{"script", engine->globalObject().property("scriptName").toString().toUtf8().constData()},
+				{"player", engine->globalObject().property("me").toInt32()},
+				{"functions", functions}
+			});
+		}
+	}
+
+	nlohmann::json legacy = nlohmann::json::array();
+
+	for (const INTERP_PROFILE &p : interpGetProfile())
+	{
+		legacy.push_back({
+			{"script", p.script},
+			{"name", p.name},
+			{"event", p.event},
+			{"calls", p.calls},
+			{"time", p.time},
+			{"worst", p.worst},
+			{"instructions", p.instructions}
+		});
+	}
+
+	if (engines.empty() && legacy.empty())
+	{
+		return;
+	}
+
+	profile["gameTime"] = gameTime;
+	profile["scripts"] = engines;
+	profile["legacy"] = legacy;
+	std::string text = profile.dump(4);
+	saveFile("logs/scriptprofile.json", text.c_str(), text.size());
+}
+
 bool initScripts()
 {
 	return true;
@@ -540,22 +661,24 @@ bool shutdownScripts()
 	models.clear();
 	triggerModel = nullptr;
 
+	saveProfile();
+
 	for (auto *engine : scripts)
 	{
 		MONITOR *monitor = monitors.value(engine);
 		QString scriptName = engine->globalObject().property("scriptName").toString();
 		int me = engine->globalObject().property("me").toInt32();
 		dumpScriptLog(scriptName, me, "=== PERFORMANCE DATA ===\n");
-		dumpScriptLog(scriptName, me, "    calls | avg (usec) | worst (usec) | worst call at | >=limit | >=limit/2 | function\n");
+		dumpScriptLog(scriptName, me, "    calls | avg (usec) | worst (usec) | worst call at | >=limit | >=limit/2 |  objects | function\n");
 
 		for (MONITOR::const_iterator iter = monitor->constBegin(); iter != monitor->constEnd(); ++iter)
 		{
 			const QString& function = iter.key();
 			MONITOR_BIN m = iter.value();
-			QString info = QString("%1 | %2 | %3 | %4 | %5 | %6 | %7\n")
+			QString info = QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8\n")
 			               .arg(m.calls, 9).arg(m.time / m.calls, 10).arg(m.worst, 12)
 			               .arg(m.worstGameTime, 13).arg(m.overMaxTimeCalls, 7)
-			               .arg(m.overHalfMaxTimeCalls, 9).arg(function);
+			               .arg(m.overHalfMaxTimeCalls, 9).arg(m.objects, 8).arg(function);
 			dumpScriptLog(scriptName, me, info);
 		}
 
@@ -565,8 +688,11 @@ bool shutdownScripts()
 	}
 
 	timers.clear();
+	dueTimers.clear();
+	globalScripts.clear();
 	internalNamespace.clear();
 	monitors.clear();
+	interpResetProfile();
 
 	while (!scripts.isEmpty())
 	{
@@ -597,58 +723,61 @@ bool updateScripts()
 		engine->globalObject().setProperty("gameTime", gameTime, QScriptValue::ReadOnly | QScriptValue::Undeletable);
 	}
 
-	// Weed out dead timers
-	for (int i = 0; i < timers.count();)
+	// Take the timers which are due off the heap, since running them may set or remove timers.
+	ASSERT(dueTimers.empty(), "updateScripts called recursively");
+	while (!timers.empty() && timers.front().frameTime <= gameTime)
 	{
-		const timerNode node = timers.at(i);
-
-		if (node.type == TIMER_ONESHOT_DONE)
-		{
-			timers.removeAt(i);
-		}
-		else
-		{
-			i++;
-		}
+		std::pop_heap(timers.begin(), timers.end());
+		dueTimers.push_back(std::move(timers.back()));
+		timers.pop_back();
 	}
 
-	// Check for timers, and run them if applicable.
-	// TODO - load balancing
-	QList<timerNode> runlist; // make a new list here, since we might trample all over the timer list during execution
-	QList<timerNode>::iterator iter;
+	// Run them, in the order they were due. If an AI's timers take longer than its budget, put the rest of
+	// them off until the next update, when they will be the first due.
+	const int budget = war_GetScriptTimerBudget();
+	std::map<QScriptEngine *, qint64> timeUsed;
 
-	for (iter = timers.begin(); iter != timers.end(); iter++)
+	for (size_t i = 0; i < dueTimers.size(); ++i)
 	{
-		if (iter->frameTime <= gameTime)
-		{
-			iter->frameTime = iter->ms + gameTime;	// update for next invokation
+		timerNode &node = dueTimers[i];
+		qint64 &used = timeUsed[node.engine];
 
-			if (iter->type == TIMER_ONESHOT_READY)
+		if (budget > 0 && used >= budget && node.type == TIMER_REPEAT && !globalScripts.count(node.engine))
+		{
+			if (!node.removed)
 			{
-				iter->type = TIMER_ONESHOT_DONE; // unless there is none
+				addTimer(node, false);
 			}
+			continue;
+		}
 
-			iter->calls++;
-			runlist.append(*iter);
+		if (node.type == TIMER_REPEAT && !node.removed)
+		{
+			timerNode next = node;
+			next.frameTime = node.ms + gameTime;	// update for next invokation
+			next.calls++;
+			addTimer(next, false);
 		}
-	}
 
-	for (iter = runlist.begin(); iter != runlist.end(); iter++)
-	{
 		QScriptValueList args;
 
-		if (iter->baseobj > 0)
+		if (node.baseobj > 0)
 		{
-			args += convMax(IdToObject(iter->baseobjtype, iter->baseobj, iter->player), iter->engine);
+			args += convMax(IdToObject(node.baseobjtype, node.baseobj, node.player), node.engine);
 		}
-		else if (!iter->stringarg.isEmpty())
+		else if (!node.stringarg.isEmpty())
 		{
-			args += iter->stringarg;
+			args += node.stringarg;
 		}
 
-		callFunction(iter->engine, iter->function, args, true);
+		QElapsedTimer timer;
+		timer.start();
+		callFunction(node.engine, node.function, args, true);
+		used += timer.nsecsElapsed() / 1000;
 	}
 
+	dueTimers.clear();
+
 	if (globalDialog && doUpdateModels)
 	{
 		updateGlobalModels();
@@ -790,7 +919,14 @@ QScriptEngine *loadPlayerScript(const WzString& path, int player, int difficulty
 
 bool loadGlobalScript(WzString path)
 {
-	return loadPlayerScript(std::move(path), selectedPlayer, 0);
+	QScriptEngine *engine = loadPlayerScript(std::move(path), selectedPlayer, 0);
+
+	if (engine)
+	{
+		globalScripts.insert(engine);
+	}
+
+	return engine != nullptr;
 }
 
 bool saveScriptStates(const char *filename)
@@ -824,9 +960,15 @@ bool saveScriptStates(const char *filename)
 		ini.endGroup();
 	}
 
-	for (int i = 0; i < timers.size(); ++i)
+	std::vector<timerNode> sortedTimers = timers;
+	std::sort(sortedTimers.begin(), sortedTimers.end(), [](timerNode const &a, timerNode const &b)
 	{
-		timerNode node = timers.at(i);
+		return b < a;  // Due first, first.
+	});
+
+	for (size_t i = 0; i < sortedTimers.size(); ++i)
+	{
+		timerNode const &node = sortedTimers[i];
 		ini.beginGroup("triggers_" + WzString::number(i));
 		// we have to save 'scriptName' and 'me' explicitly
 		ini.setValue("me", node.player);
@@ -890,7 +1032,11 @@ bool loadScriptStates(const char *filename)
 			node.function = ini.value("function").toString();
 			node.baseobj = ini.value("baseobj", -1).toInt();
 			node.type = (timerType)ini.value("type", TIMER_REPEAT).toInt();
-			timers.push_back(node);
+
+			if (node.type != TIMER_ONESHOT_DONE)
+			{
+				addTimer(node);
+			}
 		}
 		else if (engine && list[i].startsWith("globals_"))
 		{
@@ -1027,6 +1173,62 @@ static void updateGlobalModels()
 	}
 }
 
+/// A number in a model cell, so that the column sorts by value.
+static QStandardItem *numberItem(qulonglong value)
+{
+	QStandardItem *item = new QStandardItem;
+	item->setData(value, Qt::DisplayRole);
+	return item;
+}
+
+void fillProfileModel(QStandardItemModel &model)
+{
+	model.setRowCount(0);
+	model.setColumnCount(8);
+	model.setHeaderData(0, Qt::Horizontal, QString("Script"));
+	model.setHeaderData(1, Qt::Horizontal, QString("Function"));
+	model.setHeaderData(2, Qt::Horizontal, QString("Calls"));
+	model.setHeaderData(3, Qt::Horizontal, QString("Total (ms)"));
+	model.setHeaderData(4, Qt::Horizontal, QString("Average (us)"));
+	model.setHeaderData(5, Qt::Horizontal, QString("Worst (us)"));
+	model.setHeaderData(6, Qt::Horizontal, QString("Objects"));
+	model.setHeaderData(7, Qt::Horizontal, QString("Instructions"));
+
+	for (auto *engine : scripts)
+	{
+		MONITOR *monitor = monitors.value(engine);
+		QString scriptName = engine->globalObject().property("scriptName").toString();
+		int me = engine->globalObject().property("me").toInt32();
+
+		for (MONITOR::const_iterator iter = monitor->constBegin(); iter != monitor->constEnd(); ++iter)
+		{
+			const MONITOR_BIN &m = iter.value();
+			int row = model.rowCount();
+			model.setItem(row, 0, new QStandardItem(scriptName + ":" + QString::number(me)));
+			model.setItem(row, 1, new QStandardItem(iter.key()));
+			model.setItem(row, 2, numberItem(m.calls));
+			model.setItem(row, 3, numberItem(m.time / 1000));
+			model.setItem(row, 4, numberItem(m.time / std::max(m.calls, 1)));
+			model.setItem(row, 5, numberItem(m.worst));
+			model.setItem(row, 6, numberItem(m.objects));
+			model.setItem(row, 7, new QStandardItem("-"));
+		}
+	}
+
+	for (const INTERP_PROFILE &p : interpGetProfile())
+	{
+		int row = model.rowCount();
+		model.setItem(row, 0, new QStandardItem(QString::fromUtf8(p.script.c_str())));
+		model.setItem(row, 1, new QStandardItem(QString::fromUtf8(p.name.c_str())));
+		model.setItem(row, 2, numberItem(p.calls));
+		model.setItem(row, 3, numberItem(p.time / 1000));
+		model.setItem(row, 4, numberItem(p.time / std::max(p.calls, 1u)));
+		model.setItem(row, 5, numberItem(p.worst));
+		model.setItem(row, 6, new QStandardItem("-"));
+		model.setItem(row, 7, numberItem(p.instructions));
+	}
+}
+
 bool jsEvaluate(QScriptEngine *engine, const QString &text)
 {
 	QScriptSyntaxCheckResult syntax = QScriptEngine::checkSyntax(text);
@@ -1651,6 +1853,7 @@ bool triggerEventPickup(FEATURE *psFeat, DROID *psDroid)
 bool triggerEventSeen(BASE_OBJECT *psViewer, BASE_OBJECT *psSeen)
 {
 	ASSERT(scriptsReady, "Scripts not initialized yet");
+	bool called = false;
 
 	for (int i = 0; i < scripts.size() && psSeen && psViewer; ++i)
 	{
@@ -1663,6 +1866,7 @@ bool triggerEventSeen(BASE_OBJECT *psViewer, BASE_OBJECT *psSeen)
 			args += convMax(psViewer, engine);
 			args += convMax(psSeen, engine);
 			callFunction(engine, "eventObjectSeen", args);
+			called = true;
 		}
 
 		if (callbacks.second)
@@ -1671,10 +1875,11 @@ bool triggerEventSeen(BASE_OBJECT *psViewer, BASE_OBJECT *psSeen)
 			args += convMax(psViewer, engine);
 			args += QScriptValue(callbacks.second); // group id
 			callFunction(engine, "eventGroupSeen", args);
+			called = true;
 		}
 	}
 
-	return true;
+	return called;
 }
 
 //__ ## eventObjectTransfer(object, from)
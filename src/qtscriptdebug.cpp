@@ -32,6 +32,7 @@
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtWidgets/QDialog>
+#include <QtWidgets/QHeaderView>
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QTreeView>
 #include <QtWidgets/QTabWidget>
@@ -393,6 +394,17 @@ ScriptDebugger::ScriptDebugger(const MODELMAP &models, QStandardItemModel *trigg
 	triggerView.setSelectionBehavior(QAbstractItemView::SelectRows);
 	tab.addTab(&triggerView, "Triggers");
 
+	// Add profile
+	profileView.setModel(&profileModel);
+	profileView.setSelectionMode(QAbstractItemView::NoSelection);
+	profileView.setSelectionBehavior(QAbstractItemView::SelectRows);
+	profileView.setSortingEnabled(true);
+	fillProfileModel(profileModel);
+	profileView.sortByColumn(3, Qt::DescendingOrder);
+	profileView.resizeColumnToContents(0);
+	profileView.resizeColumnToContents(1);
+	tab.addTab(&profileView, "Profile");
+
 	// Add messages
 	QTabWidget *messTab = new QTabWidget(this);
 	messageView.setModel(&messageModel);
@@ -472,6 +484,9 @@ void ScriptDebugger::update()
 	{
 		fillPlayerModel(playerModel[i], i);
 	}
+
+	fillProfileModel(profileModel);
+	profileView.sortByColumn(profileView.header()->sortIndicatorSection(), profileView.header()->sortIndicatorOrder());
 }
 
 void ScriptDebugger::runClicked(QObject *obj)
@@ -61,12 +61,14 @@ private:
 	QStandardItemModel viewdataModel;
 	QStandardItemModel mainModel;
 	QStandardItemModel playerModel[MAX_PLAYERS];
+	QStandardItemModel profileModel;
 	QTreeView selectedView;
 	QTreeView labelView;
 	QTreeView triggerView;
 	QTreeView messageView;
 	QTreeView viewdataView;
 	QTreeView mainView;
+	QTreeView profileView;
 	QComboBox aiScriptComboBox;
 	QComboBox aiPlayerComboBox;
 	MODELMAP modelMap;
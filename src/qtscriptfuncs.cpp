@@ -37,6 +37,7 @@
 #include <QtGui/QStandardItemModel>
 
 #include "action.h"
+#include "benchmark.h"
 #include "combat.h"
 #include "console.h"
 #include "design.h"
@@ -127,6 +128,7 @@ struct LABEL
 typedef QMap<QString, LABEL> LABELMAP;
 static LABELMAP labels;
 static QStandardItemModel *labelModel = nullptr;
+static uint64_t convertedObjects = 0;  ///< Number of objects made by the conv functions, for the profile.
 
 #define SCRIPT_ASSERT_PLAYER(_context, _player) \
 	SCRIPT_ASSERT(_context, _player >= 0 && _player < MAX_PLAYERS, "Invalid player index %d", _player);
@@ -137,6 +139,11 @@ static QStandardItemModel *labelModel = nullptr;
 #define QStringToWzString(_qstring) \
 	WzString::fromUtf8(_qstring.toUtf8().constData())
 
+static inline bool wantField(SCRIPT_FIELDS fields, SCRIPT_FIELD field)
+{
+	return (fields & FIELD_BIT(field)) != 0;
+}
+
 // ----------------------------------------------------------------------------------------
 // Utility functions -- not called directly from scripts
 
@@ -545,6 +552,7 @@ static bool groupAddObject(BASE_OBJECT *psObj, int groupId, QScriptEngine *engin
 QScriptValue convResearch(RESEARCH *psResearch, QScriptEngine *engine, int player)
 {
 	QScriptValue value = engine->newObject();
+	convertedObjects++;
 	value.setProperty("power", (int)psResearch->researchPower);
 	value.setProperty("points", (int)psResearch->researchPoints);
 	bool started = false;
@@ -589,87 +597,140 @@ QScriptValue convResearch(RESEARCH *psResearch, QScriptEngine *engine, int playe
 //;; * ```range``` Maximum range of its weapons. (3.2+ only)
 //;; * ```hasIndirect``` One or more of the structure's weapons are indirect. (3.2+ only)
 //;;
-QScriptValue convStructure(STRUCTURE *psStruct, QScriptEngine *engine)
+QScriptValue convStructure(STRUCTURE *psStruct, QScriptEngine *engine, SCRIPT_FIELDS fields)
 {
 	bool aa = false;
 	bool ga = false;
 	bool indirect = false;
 	int range = -1;
 
-	for (int i = 0; i < psStruct->numWeaps; i++)
+	if (fields & (FIELD_BIT(FIELD_CAN_HIT_AIR) | FIELD_BIT(FIELD_CAN_HIT_GROUND) | FIELD_BIT(FIELD_HAS_INDIRECT) | FIELD_BIT(FIELD_RANGE)))
 	{
-		if (psStruct->asWeaps[i].nStat)
+		for (int i = 0; i < psStruct->numWeaps; i++)
 		{
-			WEAPON_STATS *psWeap = &asWeaponStats[psStruct->asWeaps[i].nStat];
-			aa = aa || psWeap->surfaceToAir & SHOOT_IN_AIR;
-			ga = ga || psWeap->surfaceToAir & SHOOT_ON_GROUND;
-			indirect = indirect || psWeap->movementModel == MM_INDIRECT || psWeap->movementModel == MM_HOMINGINDIRECT;
-			range = MAX((int)psWeap->upgrade[psStruct->player].maxRange, range);
+			if (psStruct->asWeaps[i].nStat)
+			{
+				WEAPON_STATS *psWeap = &asWeaponStats[psStruct->asWeaps[i].nStat];
+				aa = aa || psWeap->surfaceToAir & SHOOT_IN_AIR;
+				ga = ga || psWeap->surfaceToAir & SHOOT_ON_GROUND;
+				indirect = indirect || psWeap->movementModel == MM_INDIRECT || psWeap->movementModel == MM_HOMINGINDIRECT;
+				range = MAX((int)psWeap->upgrade[psStruct->player].maxRange, range);
+			}
 		}
 	}
 
-	QScriptValue value = convObj(psStruct, engine);
-	value.setProperty("isCB", structCBSensor(psStruct), QScriptValue::ReadOnly);
-	value.setProperty("isSensor", structStandardSensor(psStruct), QScriptValue::ReadOnly);
-	value.setProperty("canHitAir", aa, QScriptValue::ReadOnly);
-	value.setProperty("canHitGround", ga, QScriptValue::ReadOnly);
-	value.setProperty("hasIndirect", indirect, QScriptValue::ReadOnly);
-	value.setProperty("isRadarDetector", objRadarDetector(psStruct), QScriptValue::ReadOnly);
-	value.setProperty("range", range, QScriptValue::ReadOnly);
-	value.setProperty("status", (int)psStruct->status, QScriptValue::ReadOnly);
-	value.setProperty("health", 100 * psStruct->health / MAX(1, structureBody(psStruct)), QScriptValue::ReadOnly);
-	value.setProperty("cost", psStruct->pStructureType->powerToBuild, QScriptValue::ReadOnly);
+	QScriptValue value = convObj(psStruct, engine, fields);
 
-	switch (psStruct->pStructureType->type) // don't bleed our source insanities into the scripting world
+	if (wantField(fields, FIELD_IS_CB))
 	{
-		case REF_WALL:
-		case REF_WALLCORNER:
-		case REF_GATE:
-			value.setProperty("stattype", (int)REF_WALL, QScriptValue::ReadOnly);
-			break;
+		value.setProperty("isCB", structCBSensor(psStruct), QScriptValue::ReadOnly);
+	}
 
-		case REF_GENERIC:
-		case REF_DEFENSE:
-			if (isLasSat(psStruct->pStructureType))
-			{
-				value.setProperty("stattype", (int)FAKE_REF_LASSAT, QScriptValue::ReadOnly);
-				break;
-			}
+	if (wantField(fields, FIELD_IS_SENSOR))
+	{
+		value.setProperty("isSensor", structStandardSensor(psStruct), QScriptValue::ReadOnly);
+	}
 
-			value.setProperty("stattype", (int)REF_DEFENSE, QScriptValue::ReadOnly);
-			break;
+	if (wantField(fields, FIELD_CAN_HIT_AIR))
+	{
+		value.setProperty("canHitAir", aa, QScriptValue::ReadOnly);
+	}
 
-		default:
-			value.setProperty("stattype", (int)psStruct->pStructureType->type, QScriptValue::ReadOnly);
-			break;
+	if (wantField(fields, FIELD_CAN_HIT_GROUND))
+	{
+		value.setProperty("canHitGround", ga, QScriptValue::ReadOnly);
 	}
 
-	if (psStruct->pStructureType->type == REF_FACTORY || psStruct->pStructureType->type == REF_CYBORG_FACTORY
-	        || psStruct->pStructureType->type == REF_VTOL_FACTORY
-	        || psStruct->pStructureType->type == REF_RESEARCH
-	        || psStruct->pStructureType->type == REF_POWER_GEN)
+	if (wantField(fields, FIELD_HAS_INDIRECT))
 	{
-		value.setProperty("modules", psStruct->capacity, QScriptValue::ReadOnly);
+		value.setProperty("hasIndirect", indirect, QScriptValue::ReadOnly);
 	}
-	else
+
+	if (wantField(fields, FIELD_IS_RADAR_DETECTOR))
+	{
+		value.setProperty("isRadarDetector", objRadarDetector(psStruct), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_RANGE))
+	{
+		value.setProperty("range", range, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_STATUS))
 	{
-		value.setProperty("modules", QScriptValue::NullValue);
+		value.setProperty("status", (int)psStruct->status, QScriptValue::ReadOnly);
 	}
 
-	QScriptValue weaponlist = engine->newArray(psStruct->numWeaps);
+	if (wantField(fields, FIELD_HEALTH))
+	{
+		value.setProperty("health", 100 * psStruct->health / MAX(1, structureBody(psStruct)), QScriptValue::ReadOnly);
+	}
 
-	for (int j = 0; j < psStruct->numWeaps; j++)
+	if (wantField(fields, FIELD_COST))
 	{
-		QScriptValue weapon = engine->newObject();
-		const WEAPON_STATS *psStats = asWeaponStats + psStruct->asWeaps[j].nStat;
-		weapon.setProperty("fullname", WzStringToQScriptValue(engine, psStats->name), QScriptValue::ReadOnly);
-		weapon.setProperty("name", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly); // will be changed to contain full name
-		weapon.setProperty("id", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly);
-		weapon.setProperty("lastFired", psStruct->asWeaps[j].lastFired, QScriptValue::ReadOnly);
-		weaponlist.setProperty(j, weapon, QScriptValue::ReadOnly);
+		value.setProperty("cost", psStruct->pStructureType->powerToBuild, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_STATTYPE))
+	{
+		switch (psStruct->pStructureType->type) // don't bleed our source insanities into the scripting world
+		{
+			case REF_WALL:
+			case REF_WALLCORNER:
+			case REF_GATE:
+				value.setProperty("stattype", (int)REF_WALL, QScriptValue::ReadOnly);
+				break;
+
+			case REF_GENERIC:
+			case REF_DEFENSE:
+				if (isLasSat(psStruct->pStructureType))
+				{
+					value.setProperty("stattype", (int)FAKE_REF_LASSAT, QScriptValue::ReadOnly);
+					break;
+				}
+
+				value.setProperty("stattype", (int)REF_DEFENSE, QScriptValue::ReadOnly);
+				break;
+
+			default:
+				value.setProperty("stattype", (int)psStruct->pStructureType->type, QScriptValue::ReadOnly);
+				break;
+		}
+	}
+
+	if (wantField(fields, FIELD_MODULES))
+	{
+		if (psStruct->pStructureType->type == REF_FACTORY || psStruct->pStructureType->type == REF_CYBORG_FACTORY
+		        || psStruct->pStructureType->type == REF_VTOL_FACTORY
+		        || psStruct->pStructureType->type == REF_RESEARCH
+		        || psStruct->pStructureType->type == REF_POWER_GEN)
+		{
+			value.setProperty("modules", psStruct->capacity, QScriptValue::ReadOnly);
+		}
+		else
+		{
+			value.setProperty("modules", QScriptValue::NullValue);
+		}
+	}
+
+	if (wantField(fields, FIELD_WEAPONS))
+	{
+		QScriptValue weaponlist = engine->newArray(psStruct->numWeaps);
+
+		for (int j = 0; j < psStruct->numWeaps; j++)
+		{
+			QScriptValue weapon = engine->newObject();
+			const WEAPON_STATS *psStats = asWeaponStats + psStruct->asWeaps[j].nStat;
+			weapon.setProperty("fullname", WzStringToQScriptValue(engine, psStats->name), QScriptValue::ReadOnly);
+			weapon.setProperty("name", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly); // will be changed to contain full name
+			weapon.setProperty("id", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly);
+			weapon.setProperty("lastFired", psStruct->asWeaps[j].lastFired, QScriptValue::ReadOnly);
+			weaponlist.setProperty(j, weapon, QScriptValue::ReadOnly);
+		}
+
+		value.setProperty("weapons", weaponlist, QScriptValue::ReadOnly);
 	}
 
-	value.setProperty("weapons", weaponlist, QScriptValue::ReadOnly);
 	return value;
 }
 
@@ -681,13 +742,26 @@ QScriptValue convStructure(STRUCTURE *psStruct, QScriptEngine *engine)
 //;; * ```stattype``` The type of feature. Defined types are ```OIL_RESOURCE```, ```OIL_DRUM``` and ```ARTIFACT```.
 //;; * ```damageable``` Can this feature be damaged?
 //;;
-QScriptValue convFeature(FEATURE *psFeature, QScriptEngine *engine)
+QScriptValue convFeature(FEATURE *psFeature, QScriptEngine *engine, SCRIPT_FIELDS fields)
 {
-	QScriptValue value = convObj(psFeature, engine);
+	QScriptValue value = convObj(psFeature, engine, fields);
 	const FEATURE_STATS *psStats = psFeature->psStats;
-	value.setProperty("health", 100 * psStats->health / MAX(1, psFeature->health), QScriptValue::ReadOnly);
-	value.setProperty("damageable", psStats->damageable, QScriptValue::ReadOnly);
-	value.setProperty("stattype", psStats->subType, QScriptValue::ReadOnly);
+
+	if (wantField(fields, FIELD_HEALTH))
+	{
+		value.setProperty("health", 100 * psStats->health / MAX(1, psFeature->health), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_DAMAGEABLE))
+	{
+		value.setProperty("damageable", psStats->damageable, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_STATTYPE))
+	{
+		value.setProperty("stattype", psStats->subType, QScriptValue::ReadOnly);
+	}
+
 	return value;
 }
 
@@ -754,7 +828,7 @@ QScriptValue convFeature(FEATURE *psFeature, QScriptEngine *engine)
 //;; * ```cargoCount``` Defined for transporters only: Number of individual \emph{items} in the cargo hold. (3.2+ only)
 //;; * ```cargoSize``` The amount of cargo space the droid will take inside a transport. (3.2+ only)
 //;;
-QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine)
+QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine, SCRIPT_FIELDS fields)
 {
 	bool aa = false;
 	bool ga = false;
@@ -762,34 +836,55 @@ QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine)
 	int range = -1;
 	const BODY_STATS *psBodyStats = &asBodyStats[psDroid->asBits[COMP_BODY]];
 
-	for (int i = 0; i < psDroid->numWeaps; i++)
+	if (fields & (FIELD_BIT(FIELD_CAN_HIT_AIR) | FIELD_BIT(FIELD_CAN_HIT_GROUND) | FIELD_BIT(FIELD_HAS_INDIRECT) | FIELD_BIT(FIELD_RANGE)))
 	{
-		if (psDroid->asWeaps[i].nStat)
+		for (int i = 0; i < psDroid->numWeaps; i++)
 		{
-			WEAPON_STATS *psWeap = &asWeaponStats[psDroid->asWeaps[i].nStat];
-			aa = aa || psWeap->surfaceToAir & SHOOT_IN_AIR;
-			ga = ga || psWeap->surfaceToAir & SHOOT_ON_GROUND;
-			indirect = indirect || psWeap->movementModel == MM_INDIRECT || psWeap->movementModel == MM_HOMINGINDIRECT;
-			range = MAX((int)psWeap->upgrade[psDroid->player].maxRange, range);
+			if (psDroid->asWeaps[i].nStat)
+			{
+				WEAPON_STATS *psWeap = &asWeaponStats[psDroid->asWeaps[i].nStat];
+				aa = aa || psWeap->surfaceToAir & SHOOT_IN_AIR;
+				ga = ga || psWeap->surfaceToAir & SHOOT_ON_GROUND;
+				indirect = indirect || psWeap->movementModel == MM_INDIRECT || psWeap->movementModel == MM_HOMINGINDIRECT;
+				range = MAX((int)psWeap->upgrade[psDroid->player].maxRange, range);
+			}
 		}
 	}
 
 	DROID_TYPE type = psDroid->droidType;
-	QScriptValue value = convObj(psDroid, engine);
-	value.setProperty("action", (int)psDroid->action, QScriptValue::ReadOnly);
+	QScriptValue value = convObj(psDroid, engine, fields);
 
-	if (range >= 0)
+	if (wantField(fields, FIELD_ACTION))
 	{
-		value.setProperty("range", range, QScriptValue::ReadOnly);
+		value.setProperty("action", (int)psDroid->action, QScriptValue::ReadOnly);
 	}
-	else
+
+	if (wantField(fields, FIELD_RANGE))
+	{
+		if (range >= 0)
+		{
+			value.setProperty("range", range, QScriptValue::ReadOnly);
+		}
+		else
+		{
+			value.setProperty("range", QScriptValue::NullValue);
+		}
+	}
+
+	if (wantField(fields, FIELD_ORDER))
+	{
+		value.setProperty("order", (int)psDroid->order.type, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_COST))
 	{
-		value.setProperty("range", QScriptValue::NullValue);
+		value.setProperty("cost", calcDroidPower(psDroid), QScriptValue::ReadOnly);
 	}
 
-	value.setProperty("order", (int)psDroid->order.type, QScriptValue::ReadOnly);
-	value.setProperty("cost", calcDroidPower(psDroid), QScriptValue::ReadOnly);
-	value.setProperty("hasIndirect", indirect, QScriptValue::ReadOnly);
+	if (wantField(fields, FIELD_HAS_INDIRECT))
+	{
+		value.setProperty("hasIndirect", indirect, QScriptValue::ReadOnly);
+	}
 
 	switch (psDroid->droidType) // hide some engine craziness
 	{
@@ -813,44 +908,114 @@ QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine)
 			break;
 	}
 
-	value.setProperty("bodySize", psBodyStats->size, QScriptValue::ReadOnly);
+	if (wantField(fields, FIELD_BODY_SIZE))
+	{
+		value.setProperty("bodySize", psBodyStats->size, QScriptValue::ReadOnly);
+	}
 
 	if (isTransporter(psDroid))
 	{
-		value.setProperty("cargoCapacity", TRANSPORTER_CAPACITY, QScriptValue::ReadOnly);
-		value.setProperty("cargoLeft", calcRemainingCapacity(psDroid), QScriptValue::ReadOnly);
-		value.setProperty("cargoCount", psDroid->psGroup != nullptr ? psDroid->psGroup->getNumMembers() : 0, QScriptValue::ReadOnly);
-	}
-
-	value.setProperty("isRadarDetector", objRadarDetector(psDroid), QScriptValue::ReadOnly);
-	value.setProperty("isCB", cbSensorDroid(psDroid), QScriptValue::ReadOnly);
-	value.setProperty("isSensor", standardSensorDroid(psDroid), QScriptValue::ReadOnly);
-	value.setProperty("canHitAir", aa, QScriptValue::ReadOnly);
-	value.setProperty("canHitGround", ga, QScriptValue::ReadOnly);
-	value.setProperty("isVTOL", isVtolDroid(psDroid), QScriptValue::ReadOnly);
-	value.setProperty("droidType", (int)type, QScriptValue::ReadOnly);
-	value.setProperty("experience", (double)psDroid->experience / 65536.0, QScriptValue::ReadOnly);
-	value.setProperty("health", 100.0 / (double)psDroid->maxHealth * (double)psDroid->health, QScriptValue::ReadOnly);
-	value.setProperty("body", WzStringToQScriptValue(engine, asBodyStats[psDroid->asBits[COMP_BODY]].id), QScriptValue::ReadOnly);
-	value.setProperty("propulsion", WzStringToQScriptValue(engine, asPropulsionStats[psDroid->asBits[COMP_PROPULSION]].id), QScriptValue::ReadOnly);
-	value.setProperty("armed", 0.0, QScriptValue::ReadOnly); // deprecated!
-	QScriptValue weaponlist = engine->newArray(psDroid->numWeaps);
-
-	for (int j = 0; j < psDroid->numWeaps; j++)
-	{
-		int armed = droidReloadBar(psDroid, &psDroid->asWeaps[j], j);
-		QScriptValue weapon = engine->newObject();
-		const WEAPON_STATS *psStats = asWeaponStats + psDroid->asWeaps[j].nStat;
-		weapon.setProperty("fullname", WzStringToQScriptValue(engine, psStats->name), QScriptValue::ReadOnly);
-		weapon.setProperty("id", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly); // will be changed to full name
-		weapon.setProperty("name", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly);
-		weapon.setProperty("lastFired", psDroid->asWeaps[j].lastFired, QScriptValue::ReadOnly);
-		weapon.setProperty("armed", armed, QScriptValue::ReadOnly);
-		weaponlist.setProperty(j, weapon, QScriptValue::ReadOnly);
-	}
-
-	value.setProperty("weapons", weaponlist, QScriptValue::ReadOnly);
-	value.setProperty("cargoSize", transporterSpaceRequired(psDroid), QScriptValue::ReadOnly);
+		if (wantField(fields, FIELD_CARGO_CAPACITY))
+		{
+			value.setProperty("cargoCapacity", TRANSPORTER_CAPACITY, QScriptValue::ReadOnly);
+		}
+
+		if (wantField(fields, FIELD_CARGO_LEFT))
+		{
+			value.setProperty("cargoLeft", calcRemainingCapacity(psDroid), QScriptValue::ReadOnly);
+		}
+
+		if (wantField(fields, FIELD_CARGO_COUNT))
+		{
+			value.setProperty("cargoCount", psDroid->psGroup != nullptr ? psDroid->psGroup->getNumMembers() : 0, QScriptValue::ReadOnly);
+		}
+	}
+
+	if (wantField(fields, FIELD_IS_RADAR_DETECTOR))
+	{
+		value.setProperty("isRadarDetector", objRadarDetector(psDroid), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_IS_CB))
+	{
+		value.setProperty("isCB", cbSensorDroid(psDroid), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_IS_SENSOR))
+	{
+		value.setProperty("isSensor", standardSensorDroid(psDroid), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_CAN_HIT_AIR))
+	{
+		value.setProperty("canHitAir", aa, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_CAN_HIT_GROUND))
+	{
+		value.setProperty("canHitGround", ga, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_IS_VTOL))
+	{
+		value.setProperty("isVTOL", isVtolDroid(psDroid), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_DROID_TYPE))
+	{
+		value.setProperty("droidType", (int)type, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_EXPERIENCE))
+	{
+		value.setProperty("experience", (double)psDroid->experience / 65536.0, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_HEALTH))
+	{
+		value.setProperty("health", 100.0 / (double)psDroid->maxHealth * (double)psDroid->health, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_BODY))
+	{
+		value.setProperty("body", WzStringToQScriptValue(engine, asBodyStats[psDroid->asBits[COMP_BODY]].id), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_PROPULSION))
+	{
+		value.setProperty("propulsion", WzStringToQScriptValue(engine, asPropulsionStats[psDroid->asBits[COMP_PROPULSION]].id), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_ARMED))
+	{
+		value.setProperty("armed", 0.0, QScriptValue::ReadOnly); // deprecated!
+	}
+
+	if (wantField(fields, FIELD_WEAPONS))
+	{
+		QScriptValue weaponlist = engine->newArray(psDroid->numWeaps);
+
+		for (int j = 0; j < psDroid->numWeaps; j++)
+		{
+			int armed = droidReloadBar(psDroid, &psDroid->asWeaps[j], j);
+			QScriptValue weapon = engine->newObject();
+			const WEAPON_STATS *psStats = asWeaponStats + psDroid->asWeaps[j].nStat;
+			weapon.setProperty("fullname", WzStringToQScriptValue(engine, psStats->name), QScriptValue::ReadOnly);
+			weapon.setProperty("id", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly); // will be changed to full name
+			weapon.setProperty("name", WzStringToQScriptValue(engine, psStats->id), QScriptValue::ReadOnly);
+			weapon.setProperty("lastFired", psDroid->asWeaps[j].lastFired, QScriptValue::ReadOnly);
+			weapon.setProperty("armed", armed, QScriptValue::ReadOnly);
+			weaponlist.setProperty(j, weapon, QScriptValue::ReadOnly);
+		}
+
+		value.setProperty("weapons", weaponlist, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_CARGO_SIZE))
+	{
+		value.setProperty("cargoSize", transporterSpaceRequired(psDroid), QScriptValue::ReadOnly);
+	}
+
 	return value;
 }
 
@@ -874,31 +1039,80 @@ QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine)
 //;; * ```thermal``` Amount of thermal protection that protect against heat based weapons.
 //;; * ```born``` The game time at which this object was produced or came into the world. (3.2+ only)
 //;;
-QScriptValue convObj(BASE_OBJECT *psObj, QScriptEngine *engine)
+QScriptValue convObj(BASE_OBJECT *psObj, QScriptEngine *engine, SCRIPT_FIELDS fields)
 {
 	QScriptValue value = engine->newObject();
 	ASSERT_OR_RETURN(value, psObj, "No object for conversion");
-	value.setProperty("id", psObj->id, QScriptValue::ReadOnly);
-	value.setProperty("x", map_coord(psObj->pos.x), QScriptValue::ReadOnly);
-	value.setProperty("y", map_coord(psObj->pos.y), QScriptValue::ReadOnly);
-	value.setProperty("z", map_coord(psObj->pos.z), QScriptValue::ReadOnly);
-	value.setProperty("player", psObj->player, QScriptValue::ReadOnly);
-	value.setProperty("armour", objArmour(psObj, WC_KINETIC), QScriptValue::ReadOnly);
-	value.setProperty("thermal", objArmour(psObj, WC_HEAT), QScriptValue::ReadOnly);
-	value.setProperty("type", psObj->type, QScriptValue::ReadOnly);
-	value.setProperty("selected", psObj->selected, QScriptValue::ReadOnly);
-	value.setProperty("name", objInfo(psObj), QScriptValue::ReadOnly);
-	value.setProperty("born", psObj->born, QScriptValue::ReadOnly);
-	GROUPMAP *psMap = groups.value(engine);
+	convertedObjects++;
 
-	if (psMap->contains(psObj))
+	if (wantField(fields, FIELD_ID))
 	{
-		int group = psMap->value(psObj);
-		value.setProperty("group", group, QScriptValue::ReadOnly);
+		value.setProperty("id", psObj->id, QScriptValue::ReadOnly);
 	}
-	else
+
+	if (wantField(fields, FIELD_X))
+	{
+		value.setProperty("x", map_coord(psObj->pos.x), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_Y))
+	{
+		value.setProperty("y", map_coord(psObj->pos.y), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_Z))
+	{
+		value.setProperty("z", map_coord(psObj->pos.z), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_PLAYER))
 	{
-		value.setProperty("group", QScriptValue::NullValue);
+		value.setProperty("player", psObj->player, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_ARMOUR))
+	{
+		value.setProperty("armour", objArmour(psObj, WC_KINETIC), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_THERMAL))
+	{
+		value.setProperty("thermal", objArmour(psObj, WC_HEAT), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_TYPE))
+	{
+		value.setProperty("type", psObj->type, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_SELECTED))
+	{
+		value.setProperty("selected", psObj->selected, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_NAME))
+	{
+		value.setProperty("name", objInfo(psObj), QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_BORN))
+	{
+		value.setProperty("born", psObj->born, QScriptValue::ReadOnly);
+	}
+
+	if (wantField(fields, FIELD_GROUP))
+	{
+		GROUPMAP *psMap = groups.value(engine);
+
+		if (psMap->contains(psObj))
+		{
+			int group = psMap->value(psObj);
+			value.setProperty("group", group, QScriptValue::ReadOnly);
+		}
+		else
+		{
+			value.setProperty("group", QScriptValue::NullValue);
+		}
 	}
 
 	return value;
@@ -924,6 +1138,7 @@ QScriptValue convTemplate(DROID_TEMPLATE *psTempl, QScriptEngine *engine)
 {
 	QScriptValue value = engine->newObject();
 	ASSERT_OR_RETURN(value, psTempl, "No object for conversion");
+	convertedObjects++;
 	value.setProperty("fullname", WzStringToQScriptValue(engine, psTempl->name), QScriptValue::ReadOnly);
 	value.setProperty("name", WzStringToQScriptValue(engine, psTempl->id), QScriptValue::ReadOnly);
 	value.setProperty("id", WzStringToQScriptValue(engine, psTempl->id), QScriptValue::ReadOnly);
@@ -949,7 +1164,7 @@ QScriptValue convTemplate(DROID_TEMPLATE *psTempl, QScriptEngine *engine)
 	return value;
 }
 
-QScriptValue convMax(BASE_OBJECT *psObj, QScriptEngine *engine)
+QScriptValue convMax(BASE_OBJECT *psObj, QScriptEngine *engine, SCRIPT_FIELDS fields)
 {
 	if (!psObj)
 	{
@@ -959,20 +1174,76 @@ QScriptValue convMax(BASE_OBJECT *psObj, QScriptEngine *engine)
 	switch (psObj->type)
 	{
 		case OBJ_DROID:
-			return convDroid((DROID *)psObj, engine);
+			return convDroid((DROID *)psObj, engine, fields);
 
 		case OBJ_STRUCTURE:
-			return convStructure((STRUCTURE *)psObj, engine);
+			return convStructure((STRUCTURE *)psObj, engine, fields);
 
 		case OBJ_FEATURE:
-			return convFeature((FEATURE *)psObj, engine);
+			return convFeature((FEATURE *)psObj, engine, fields);
 
 		default:
 			ASSERT(false, "No such supported object type");
-			return convObj(psObj, engine);
+			return convObj(psObj, engine, fields);
 	}
 }
 
+/// Names of the object properties, indexed by SCRIPT_FIELD.
+static const char *const fieldNames[] =
+{
+	"id", "x", "y", "z", "player", "armour", "thermal", "type", "selected", "name", "born", "group", "health",
+	"isCB", "isSensor", "canHitAir", "canHitGround", "hasIndirect", "isRadarDetector", "range", "cost", "stattype", "weapons",
+	"status", "modules", "damageable", "action", "order", "bodySize", "cargoCapacity", "cargoLeft", "cargoCount",
+	"isVTOL", "droidType", "experience", "body", "propulsion", "armed", "cargoSize"
+};
+
+/// For the enum functions that take a list of the properties wanted as their last argument. Returns the number of
+/// arguments before that list, and the properties named in it, or all of them if there is no list. The id, type
+/// and player are always included, so that the objects can still be passed to other functions. On an unknown
+/// name, returns -1 and sets unknown to it.
+static int fieldsArgument(QScriptContext *context, SCRIPT_FIELDS &fields, QString &unknown)
+{
+	STATIC_ASSERT(ARRAY_SIZE(fieldNames) == FIELD_COUNT);
+
+	int argc = context->argumentCount();
+	fields = FIELDS_ALL;
+
+	if (argc == 0 || !context->argument(argc - 1).isArray())
+	{
+		return argc;
+	}
+
+	QScriptValue list = context->argument(argc - 1);
+	int length = list.property("length").toInt32();
+	fields = FIELD_BIT(FIELD_ID) | FIELD_BIT(FIELD_TYPE) | FIELD_BIT(FIELD_PLAYER);
+
+	for (int i = 0; i < length; i++)
+	{
+		QString name = list.property(i).toString();
+		int field = 0;
+
+		while (field < FIELD_COUNT && name != fieldNames[field])
+		{
+			field++;
+		}
+
+		if (field == FIELD_COUNT)
+		{
+			unknown = name;
+			return -1;
+		}
+
+		fields |= FIELD_BIT(field);
+	}
+
+	return argc - 1;
+}
+
+uint64_t convertedObjectCount()
+{
+	return convertedObjects;
+}
+
 BASE_OBJECT *IdToObject(OBJECT_TYPE type, int id, int player)
 {
 	switch (type)
@@ -2247,24 +2518,30 @@ static QScriptValue js_buildDroid(QScriptContext *context, QScriptEngine *engine
 	return QScriptValue(psTemplate != nullptr);
 }
 
-//-- ## enumStruct([player[, structure type[, looking player]]])
+//-- ## enumStruct([player[, structure type[, looking player]]][, properties])
 //--
 //-- Returns an array of structure objects. If no parameters given, it will
 //-- return all of the structures for the current player. The second parameter
 //-- can be either a string with the name of the structure type as defined in
 //-- "structures.json", or a stattype as defined in ```Structure```. The
 //-- third parameter can be used to filter by visibility, the default is not
-//-- to filter.
+//-- to filter. The last parameter can be an array of the names of the properties
+//-- you need, eg ```["x", "y", "status"]```, in which case the structure objects only
+//-- have those, plus ```id```, ```type``` and ```player```. This is much faster
+//-- than getting all of them. (3.3+ only)
 //--
 static QScriptValue js_enumStruct(QScriptContext *context, QScriptEngine *engine)
 {
-	QList<STRUCTURE *> matches;
 	int player = -1, looking = -1;
 	WzString statsName;
 	QScriptValue val;
 	STRUCTURE_TYPE type = NUM_DIFF_BUILDINGS;
+	SCRIPT_FIELDS fields;
+	QString unknown;
+	int argc = fieldsArgument(context, fields, unknown);
+	SCRIPT_ASSERT(context, argc >= 0, "No such object property: %s", unknown.toUtf8().constData());
 
-	switch (context->argumentCount())
+	switch (argc)
 	{
 		default:
 		case 3:
@@ -2293,6 +2570,9 @@ static QScriptValue js_enumStruct(QScriptContext *context, QScriptEngine *engine
 	SCRIPT_ASSERT_PLAYER(context, player);
 	SCRIPT_ASSERT(context, looking < MAX_PLAYERS && looking >= -1, "Looking player index out of range: %d", looking);
 
+	QScriptValue result = engine->newArray();
+	int count = 0;
+
 	for (STRUCTURE *psStruct = apsStructLists[player]; psStruct; psStruct = psStruct->psNext)
 	{
 		if ((looking == -1 || psStruct->visible[looking])
@@ -2300,39 +2580,34 @@ static QScriptValue js_enumStruct(QScriptContext *context, QScriptEngine *engine
 		        && (type == NUM_DIFF_BUILDINGS || type == psStruct->pStructureType->type)
 		        && (statsName.isEmpty() || statsName.compare(psStruct->pStructureType->id) == 0))
 		{
-			matches.push_back(psStruct);
+			result.setProperty(count++, convStructure(psStruct, engine, fields));
 		}
 	}
 
-	QScriptValue result = engine->newArray(matches.size());
-
-	for (int i = 0; i < matches.size(); i++)
-	{
-		STRUCTURE *psStruct = matches.at(i);
-		result.setProperty(i, convStructure(psStruct, engine));
-	}
-
 	return result;
 }
 
-//-- ## enumStructOffWorld([player[, structure type[, looking player]]])
+//-- ## enumStructOffWorld([player[, structure type[, looking player]]][, properties])
 //--
 //-- Returns an array of structure objects in your base when on an off-world mission, NULL otherwise.
 //-- If no parameters given, it will return all of the structures for the current player.
 //-- The second parameter can be either a string with the name of the structure type as defined
 //-- in "structures.json", or a stattype as defined in ```Structure```.
 //-- The third parameter can be used to filter by visibility, the default is not
-//-- to filter.
+//-- to filter. The last parameter can be an array of the properties wanted, as for enumStruct. (3.3+ only)
 //--
 static QScriptValue js_enumStructOffWorld(QScriptContext *context, QScriptEngine *engine)
 {
-	QList<STRUCTURE *> matches;
 	int player = -1, looking = -1;
 	WzString statsName;
 	QScriptValue val;
 	STRUCTURE_TYPE type = NUM_DIFF_BUILDINGS;
+	SCRIPT_FIELDS fields;
+	QString unknown;
+	int argc = fieldsArgument(context, fields, unknown);
+	SCRIPT_ASSERT(context, argc >= 0, "No such object property: %s", unknown.toUtf8().constData());
 
-	switch (context->argumentCount())
+	switch (argc)
 	{
 		default:
 		case 3:
@@ -2361,6 +2636,9 @@ static QScriptValue js_enumStructOffWorld(QScriptContext *context, QScriptEngine
 	SCRIPT_ASSERT(context, player < MAX_PLAYERS && player >= 0, "Target player index out of range: %d", player);
 	SCRIPT_ASSERT(context, looking < MAX_PLAYERS && looking >= -1, "Looking player index out of range: %d", looking);
 
+	QScriptValue result = engine->newArray();
+	int count = 0;
+
 	for (STRUCTURE *psStruct = mission.apsStructLists[player]; psStruct; psStruct = psStruct->psNext)
 	{
 		if ((looking == -1 || psStruct->visible[looking])
@@ -2368,58 +2646,49 @@ static QScriptValue js_enumStructOffWorld(QScriptContext *context, QScriptEngine
 		        && (type == NUM_DIFF_BUILDINGS || type == psStruct->pStructureType->type)
 		        && (statsName.isEmpty() || statsName.compare(psStruct->pStructureType->id) == 0))
 		{
-			matches.push_back(psStruct);
+			result.setProperty(count++, convStructure(psStruct, engine, fields));
 		}
 	}
 
-	QScriptValue result = engine->newArray(matches.size());
-
-	for (int i = 0; i < matches.size(); i++)
-	{
-		STRUCTURE *psStruct = matches.at(i);
-		result.setProperty(i, convStructure(psStruct, engine));
-	}
-
 	return result;
 }
 
-//-- ## enumFeature(player[, name])
+//-- ## enumFeature(player[, name][, properties])
 //--
 //-- Returns an array of all features seen by player of given name, as defined in "features.json".
 //-- If player is ```ALL_PLAYERS```, it will return all features irrespective of visibility to any player. If
-//-- name is empty, it will return any feature.
+//-- name is empty, it will return any feature. The last parameter can be an array of the properties
+//-- wanted, as for enumStruct. (3.3+ only)
 //--
 static QScriptValue js_enumFeature(QScriptContext *context, QScriptEngine *engine)
 {
-	QList<FEATURE *> matches;
 	int looking = context->argument(0).toInt32();
 	WzString statsName;
+	SCRIPT_FIELDS fields;
+	QString unknown;
+	int argc = fieldsArgument(context, fields, unknown);
+	SCRIPT_ASSERT(context, argc >= 0, "No such object property: %s", unknown.toUtf8().constData());
 
-	if (context->argumentCount() > 1)
+	if (argc > 1)
 	{
 		statsName = WzString::fromUtf8(context->argument(1).toString().toUtf8().constData());
 	}
 
 	SCRIPT_ASSERT(context, looking < MAX_PLAYERS && looking >= -1, "Looking player index out of range: %d", looking);
 
+	QScriptValue result = engine->newArray();
+	int count = 0;
+
 	for (FEATURE *psFeat = apsFeatureLists[0]; psFeat; psFeat = psFeat->psNext)
 	{
 		if ((looking == -1 || psFeat->visible[looking])
 		        && !psFeat->died
 		        && (statsName.isEmpty() || statsName.compare(psFeat->psStats->id) == 0))
 		{
-			matches.push_back(psFeat);
+			result.setProperty(count++, convFeature(psFeat, engine, fields));
 		}
 	}
 
-	QScriptValue result = engine->newArray(matches.size());
-
-	for (int i = 0; i < matches.size(); i++)
-	{
-		FEATURE *psFeat = matches.at(i);
-		result.setProperty(i, convFeature(psFeat, engine));
-	}
-
 	return result;
 }
 
@@ -2449,21 +2718,25 @@ static QScriptValue js_enumCargo(QScriptContext *context, QScriptEngine *engine)
 	return result;
 }
 
-//-- ## enumDroid([player[, droid type[, looking player]]])
+//-- ## enumDroid([player[, droid type[, looking player]]][, properties])
 //--
 //-- Returns an array of droid objects. If no parameters given, it will
 //-- return all of the droids for the current player. The second, optional parameter
 //-- is the name of the droid type. The third parameter can be used to filter by
-//-- visibility - the default is not to filter.
+//-- visibility - the default is not to filter. The last parameter can be an array
+//-- of the properties wanted, as for enumStruct. (3.3+ only)
 //--
 static QScriptValue js_enumDroid(QScriptContext *context, QScriptEngine *engine)
 {
-	QList<DROID *> matches;
 	int player = -1, looking = -1;
 	DROID_TYPE droidType = DROID_ANY;
 	DROID_TYPE droidType2;
+	SCRIPT_FIELDS fields;
+	QString unknown;
+	int argc = fieldsArgument(context, fields, unknown);
+	SCRIPT_ASSERT(context, argc >= 0, "No such object property: %s", unknown.toUtf8().constData());
 
-	switch (context->argumentCount())
+	switch (argc)
 	{
 		default:
 		case 3:
@@ -2506,24 +2779,19 @@ static QScriptValue js_enumDroid(QScriptContext *context, QScriptEngine *engine)
 	SCRIPT_ASSERT_PLAYER(context, player);
 	SCRIPT_ASSERT(context, looking < MAX_PLAYERS && looking >= -1, "Looking player index out of range: %d", looking);
 
+	QScriptValue result = engine->newArray();
+	int count = 0;
+
 	for (DROID *psDroid = apsDroidLists[player]; psDroid; psDroid = psDroid->psNext)
 	{
 		if ((looking == -1 || psDroid->visible[looking])
 		        && !psDroid->died
 		        && (droidType == DROID_ANY || droidType == psDroid->droidType || droidType2 == psDroid->droidType))
 		{
-			matches.push_back(psDroid);
+			result.setProperty(count++, convDroid(psDroid, engine, fields));
 		}
 	}
 
-	QScriptValue result = engine->newArray(matches.size());
-
-	for (int i = 0; i < matches.size(); i++)
-	{
-		DROID *psDroid = matches.at(i);
-		result.setProperty(i, convDroid(psDroid, engine));
-	}
-
 	return result;
 }
 
@@ -3415,6 +3683,7 @@ static QScriptValue js_gameOverMessage(QScriptContext *context, QScriptEngine *e
 
 	if (autogame_enabled())
 	{
+		benchmarkFinish();  // The game ended before all the ticks were run.
 		debug(LOG_WARNING, "Autogame completed successfully!");
 		exit(0);
 	}
@@ -4394,13 +4663,14 @@ static QScriptValue js_loadLevel(QScriptContext *context, QScriptEngine *)
 	return QScriptValue();
 }
 
-//-- ## enumRange(x, y, range[, filter[, seen]])
+//-- ## enumRange(x, y, range[, filter[, seen]][, properties])
 //--
 //-- Returns an array of game objects seen within range of given position that passes the optional filter
 //-- which can be one of a player index, ALL_PLAYERS, ALLIES or ENEMIES. By default, filter is
 //-- ALL_PLAYERS. Finally an optional parameter can specify whether only visible objects should be
 //-- returned; by default only visible objects are returned. Calling this function is much faster than
 //-- iterating over all game objects using other enum functions. (3.2+ only)
+//-- The last parameter can be an array of the properties wanted, as for enumStruct. (3.3+ only)
 //--
 static QScriptValue js_enumRange(QScriptContext *context, QScriptEngine *engine)
 {
@@ -4410,20 +4680,25 @@ static QScriptValue js_enumRange(QScriptContext *context, QScriptEngine *engine)
 	int range = world_coord(context->argument(2).toInt32());
 	int filter = ALL_PLAYERS;
 	bool seen = true;
+	SCRIPT_FIELDS fields;
+	QString unknown;
+	int argc = fieldsArgument(context, fields, unknown);
+	SCRIPT_ASSERT(context, argc >= 0, "No such object property: %s", unknown.toUtf8().constData());
 
-	if (context->argumentCount() > 3)
+	if (argc > 3)
 	{
 		filter = context->argument(3).toInt32();
 	}
 
-	if (context->argumentCount() > 4)
+	if (argc > 4)
 	{
 		seen = context->argument(4).toBool();
 	}
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(x, y, range);
-	QList<BASE_OBJECT *> list;
+	gridFindObjects(gridList, x, y, range);
+	QScriptValue value = engine->newArray();
+	int count = 0;
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -4435,18 +4710,11 @@ static QScriptValue js_enumRange(QScriptContext *context, QScriptEngine *engine)
 			        || (filter == ALLIES && psObj->type != OBJ_FEATURE && aiCheckAlliances(psObj->player, player))
 			        || (filter == ENEMIES && psObj->type != OBJ_FEATURE && !aiCheckAlliances(psObj->player, player)))
 			{
-				list.append(psObj);
+				value.setProperty(count++, convMax(psObj, engine, fields), QScriptValue::ReadOnly);
 			}
 		}
 	}
 
-	QScriptValue value = engine->newArray(list.size());
-
-	for (int i = 0; i < list.size(); i++)
-	{
-		value.setProperty(i, convMax(list[i], engine), QScriptValue::ReadOnly);
-	}
-
 	return value;
 }
 
@@ -4498,7 +4766,7 @@ static QScriptValue js_enumArea(QScriptContext *context, QScriptEngine *engine)
 	}
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterateArea(x1, y1, x2, y2);
+	gridFindObjectsArea(gridList, x1, y1, x2, y2);
 	QList<BASE_OBJECT *> list;
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
@@ -38,6 +38,55 @@ enum SCRIPT_TYPE
 	SCRIPT_COUNT
 };
 
+/// Properties of the objects made by convObj and the functions built on it, so that scripts can ask for only some of them.
+enum SCRIPT_FIELD
+{
+	FIELD_ID,
+	FIELD_X,
+	FIELD_Y,
+	FIELD_Z,
+	FIELD_PLAYER,
+	FIELD_ARMOUR,
+	FIELD_THERMAL,
+	FIELD_TYPE,
+	FIELD_SELECTED,
+	FIELD_NAME,
+	FIELD_BORN,
+	FIELD_GROUP,
+	FIELD_HEALTH,
+	FIELD_IS_CB,
+	FIELD_IS_SENSOR,
+	FIELD_CAN_HIT_AIR,
+	FIELD_CAN_HIT_GROUND,
+	FIELD_HAS_INDIRECT,
+	FIELD_IS_RADAR_DETECTOR,
+	FIELD_RANGE,
+	FIELD_COST,
+	FIELD_STATTYPE,
+	FIELD_WEAPONS,
+	FIELD_STATUS,
+	FIELD_MODULES,
+	FIELD_DAMAGEABLE,
+	FIELD_ACTION,
+	FIELD_ORDER,
+	FIELD_BODY_SIZE,
+	FIELD_CARGO_CAPACITY,
+	FIELD_CARGO_LEFT,
+	FIELD_CARGO_COUNT,
+	FIELD_IS_VTOL,
+	FIELD_DROID_TYPE,
+	FIELD_EXPERIENCE,
+	FIELD_BODY,
+	FIELD_PROPULSION,
+	FIELD_ARMED,
+	FIELD_CARGO_SIZE,
+	FIELD_COUNT
+};
+
+typedef uint64_t SCRIPT_FIELDS;  ///< Set of SCRIPT_FIELD, one bit each.
+#define FIELD_BIT(_field) ((SCRIPT_FIELDS)1 << (_field))
+#define FIELDS_ALL (~(SCRIPT_FIELDS)0)
+
 #include <QtScript/QScriptEngine>
 
 // ----------------------------------------------
@@ -60,13 +109,15 @@ bool areaLabelCheck(DROID *psDroid);
 QScriptValue mapJsonToQScriptValue(QScriptEngine *engine, const nlohmann::json &instance, QScriptValue::PropertyFlags flags);
 
 // Utility conversion functions
-QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine);
-QScriptValue convStructure(STRUCTURE *psStruct, QScriptEngine *engine);
-QScriptValue convObj(BASE_OBJECT *psObj, QScriptEngine *engine);
-QScriptValue convFeature(FEATURE *psFeature, QScriptEngine *engine);
-QScriptValue convMax(BASE_OBJECT *psObj, QScriptEngine *engine);
+QScriptValue convDroid(DROID *psDroid, QScriptEngine *engine, SCRIPT_FIELDS fields = FIELDS_ALL);
+QScriptValue convStructure(STRUCTURE *psStruct, QScriptEngine *engine, SCRIPT_FIELDS fields = FIELDS_ALL);
+QScriptValue convObj(BASE_OBJECT *psObj, QScriptEngine *engine, SCRIPT_FIELDS fields = FIELDS_ALL);
+QScriptValue convFeature(FEATURE *psFeature, QScriptEngine *engine, SCRIPT_FIELDS fields = FIELDS_ALL);
+QScriptValue convMax(BASE_OBJECT *psObj, QScriptEngine *engine, SCRIPT_FIELDS fields = FIELDS_ALL);
 QScriptValue convTemplate(DROID_TEMPLATE *psTemplate, QScriptEngine *engine);
 QScriptValue convResearch(RESEARCH *psResearch, QScriptEngine *engine, int player);
+/// Number of droid, structure, feature, template and research objects made for scripts so far
+uint64_t convertedObjectCount();
 BASE_OBJECT *IdToObject(OBJECT_TYPE type, int id, int player);
 
 /// Dump script-relevant log info to separate file
@@ -77,6 +128,8 @@ QScriptValue js_enumSelected(QScriptContext *, QScriptEngine *engine);
 
 /// Create model for labels for js debug dialog
 QStandardItemModel *createLabelModel();
+/// Fill model with the time taken by each script function and legacy script event, for js debug dialog
+void fillProfileModel(QStandardItemModel &model);
 
 /// Mark and show label
 void showLabel(const QString &key, bool clear_old = true, bool jump_to = true);
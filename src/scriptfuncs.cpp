@@ -4148,7 +4148,7 @@ bool scrStructureBuiltInRange()
 	psTarget = &asStructureStats[index];
 
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterate(x, y, range);
+	gridFindObjects(gridList, x, y, range);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -60,6 +60,7 @@
 #include "group.h"
 #include "transporter.h"
 #include "fpath.h"
+#include "astar.h"
 #include "mission.h"
 #include "levels.h"
 #include "console.h"
@@ -78,6 +79,7 @@
 #include "lib/netplay/netplay.h"
 #include "multigifts.h"
 #include "loop.h"
+#include "benchmark.h"
 #include "template.h"
 #include "scores.h"
 #include "gateway.h"
@@ -165,6 +167,8 @@ static void auxStructureNonblocking(STRUCTURE *psStructure)
 			auxClearAll(b.map.x + i, b.map.y + j, AUXBITS_BLOCKING | AUXBITS_OUR_BUILDING | AUXBITS_NONPASSABLE);
 		}
 	}
+
+	fpathMarkBlockingChanged(b);
 }
 
 static void auxStructureBlocking(STRUCTURE *psStructure)
@@ -179,6 +183,8 @@ static void auxStructureBlocking(STRUCTURE *psStructure)
 			auxSetAll(b.map.x + i, b.map.y + j, AUXBITS_BLOCKING | AUXBITS_NONPASSABLE);
 		}
 	}
+
+	fpathMarkBlockingChanged(b);
 }
 
 static void auxStructureOpenGate(STRUCTURE *psStructure)
@@ -192,6 +198,8 @@ static void auxStructureOpenGate(STRUCTURE *psStructure)
 			auxClearAll(b.map.x + i, b.map.y + j, AUXBITS_BLOCKING);
 		}
 	}
+
+	fpathMarkBlockingChanged(b);
 }
 
 static void auxStructureClosedGate(STRUCTURE *psStructure)
@@ -206,6 +214,8 @@ static void auxStructureClosedGate(STRUCTURE *psStructure)
 			auxSetAll(b.map.x + i, b.map.y + j, AUXBITS_BLOCKING);
 		}
 	}
+
+	fpathMarkBlockingChanged(b);
 }
 
 bool IsStatExpansionModule(const STRUCTURE_STATS *psStats)
@@ -1463,6 +1473,8 @@ STRUCTURE *buildStructureDir(STRUCTURE_STATS *pStructureType, UDWORD x, UDWORD y
 			}
 		}
 
+		fpathMarkBlockingChanged(StructureBounds(map, size));
+
 		switch (pStructureType->type)
 		{
 			case REF_REARM_PAD:
@@ -3713,6 +3725,7 @@ int gateCurrentOpenHeight(const STRUCTURE *psStructure, uint32_t time, int minim
 /* The main update routine for all Structures */
 void structureUpdate(STRUCTURE *psBuilding, bool mission)
 {
+	BenchmarkPhase phase(BENCH_STRUCTURES);
 	UDWORD widthScatter, breadthScatter;
 	UDWORD emissionInterval, iPointsToAdd, iPointsRequired;
 	Vector3i dv;
@@ -3733,7 +3746,7 @@ void structureUpdate(STRUCTURE *psBuilding, bool mission)
 			bool		found = false;
 
 			static GridList gridList;  // static to avoid allocations.
-			gridList = gridStartIterate(psBuilding->pos.x, psBuilding->pos.y, TILE_UNITS);
+			gridFindObjects(gridList, psBuilding->pos.x, psBuilding->pos.y, TILE_UNITS);
 
 			for (GridIterator gi = gridList.begin(); !found && gi != gridList.end(); ++gi)
 			{
@@ -4598,6 +4611,8 @@ static void removeStructFromMap(STRUCTURE *psStruct)
 			auxClearBlocking(b.map.x + i, b.map.y + j, AIR_BLOCKED);
 		}
 	}
+
+	fpathMarkBlockingChanged(b);
 }
 
 // remove a structure from a game without any visible effects
@@ -24,6 +24,7 @@
  */
 #include "lib/framework/frame.h"
 #include "lib/framework/fixedpoint.h"
+#include "lib/framework/wzapp.h"
 
 #include "lib/gamelib/gtime.h"
 #include "lib/sound/audio.h"
@@ -81,8 +82,37 @@ static std::vector<SPOTTER *> apsInvisibleViewers;
 
 #define MIN_VIS_HEIGHT 80
 
+/// Maximum number of threads used for finding what the viewers can see, including the main thread.
+#define VIS_MAX_THREADS 8
+/// With fewer viewers than this, waking up the helper threads isn't worth it.
+#define VIS_MIN_PARALLEL_VIEWERS 64
+
+/// An object which a viewer might see, and how well, as found by visFindCandidates().
+struct VisCandidate
+{
+	BASE_OBJECT *psObj;
+	int val;
+};
+
+/// Helper thread for the data-parallel part of processVisibility().
+struct VISWORKER
+{
+	unsigned index;
+	WZ_THREAD *thread;
+	WZ_SEMAPHORE *startSemaphore;
+	GridList gridList;
+};
+
+static VISWORKER visWorkers[VIS_MAX_THREADS];         // visWorkers[0] is the main thread.
+static unsigned visNumThreads = 0;
+static WZ_SEMAPHORE *visDoneSemaphore = nullptr;
+static bool visQuit = false;
+static std::vector<BASE_OBJECT *> visViewers;           // Viewers, in the order they are processed.
+static std::vector<std::vector<VisCandidate>> visCandidates;  // visCandidates[i] is everything visViewers[i] might see.
+
 // forward declarations
 static void setSeenBy(BASE_OBJECT *psObj, unsigned viewer, int val);
+static int visThreadFunc(void *data);
 
 // initialise the visibility stuff
 bool visInitialise()
@@ -90,9 +120,59 @@ bool visInitialise()
 	visLevelInc = 1;
 	visLevelDec = 0;
 
+	if (visNumThreads == 0)
+	{
+		visQuit = false;
+		visNumThreads = clip(wzGetCPUCount(), 1, VIS_MAX_THREADS);
+		visDoneSemaphore = wzSemaphoreCreate(0);
+
+		for (unsigned i = 0; i < visNumThreads; ++i)
+		{
+			VISWORKER &worker = visWorkers[i];
+			worker.index = i;
+
+			if (i != 0)
+			{
+				worker.startSemaphore = wzSemaphoreCreate(0);
+				worker.thread = wzThreadCreate(visThreadFunc, &worker);
+				wzThreadStart(worker.thread);
+			}
+		}
+	}
+
 	return true;
 }
 
+// shut down the visibility stuff
+void visShutdown()
+{
+	if (visNumThreads != 0)
+	{
+		visQuit = true;
+
+		for (unsigned i = 1; i < visNumThreads; ++i)
+		{
+			wzSemaphorePost(visWorkers[i].startSemaphore);  // Wake up thread.
+		}
+
+		for (unsigned i = 1; i < visNumThreads; ++i)
+		{
+			VISWORKER &worker = visWorkers[i];
+			wzThreadJoin(worker.thread);
+			worker.thread = nullptr;
+			wzSemaphoreDestroy(worker.startSemaphore);
+			worker.startSemaphore = nullptr;
+		}
+
+		wzSemaphoreDestroy(visDoneSemaphore);
+		visDoneSemaphore = nullptr;
+		visNumThreads = 0;
+	}
+
+	visViewers.clear();
+	visCandidates.clear();
+}
+
 // update the visibility change levels
 void visUpdateLevel()
 {
@@ -102,18 +182,60 @@ void visUpdateLevel()
 
 static inline void updateTileVis(MAPTILE *psTile)
 {
-	for (int i = 0; i < MAX_PLAYERS; i++)
+	/// The definition of whether a player can see something on a given tile or not: watched, or seen with radar that isn't jammed by an enemy
+	PlayerMask seen = psTile->watcherBits | psTile->radarBits;
+
+	if (psTile->jammerBits != 0)
 	{
-		/// The definition of whether a player can see something on a given tile or not
-		if (psTile->watchers[i] > 0 || (psTile->sensors[i] > 0 && !(psTile->jammerBits & ~alliancebits[i])))
-		{
-			psTile->sensorBits |= (1 << i);         // mark it as being seen
-		}
-		else
+		const PlayerMask radarOnly = psTile->radarBits & ~psTile->watcherBits;
+
+		for (int i = 0; i < MAX_PLAYERS; i++)
 		{
-			psTile->sensorBits &= ~(1 << i);        // mark as hidden
+			if ((radarOnly & (1 << i)) && (psTile->jammerBits & ~alliancebits[i]))
+			{
+				seen &= ~(1 << i);      // jammed
+			}
 		}
 	}
+
+	psTile->sensorBits = (psTile->sensorBits & ~((1 << MAX_PLAYERS) - 1)) | seen;
+}
+
+/// Returns the bitmask in psTile which says whether any of a player's counters in visionMap(type, player) are non-zero.
+static inline PlayerMask &tileVisionBits(MAPTILE *psTile, int type)
+{
+	switch (type)
+	{
+	case VISMAP_WATCHERS: return psTile->watcherBits;
+	case VISMAP_SENSORS: return psTile->radarBits;
+	default: return psTile->jammerBits;
+	}
+}
+
+/// Counts one more object of player giving vision of the given type to tile (x, y). Returns false if the counter is full.
+static inline bool addTileVision(MAPTILE *psTile, int x, int y, int type, int player)
+{
+	uint8_t &count = visionMap(type, player)[x + y * mapWidth];
+
+	if (count == UBYTE_MAX)
+	{
+		return false;
+	}
+
+	++count;
+	tileVisionBits(psTile, type) |= 1 << player;
+	return true;
+}
+
+/// Counts one less object of player giving vision of the given type to tile (x, y).
+static inline void removeTileVision(MAPTILE *psTile, int x, int y, int type, int player)
+{
+	uint8_t &count = visionMap(type, player)[x + y * mapWidth];
+
+	if (--count == 0)
+	{
+		tileVisionBits(psTile, type) &= ~(1 << player);
+	}
 }
 
 uint32_t addSpotter(int x, int y, int player, int radius, bool radar, uint32_t expiry)
@@ -135,12 +257,10 @@ uint32_t addSpotter(int x, int y, int player, int radius, bool radar, uint32_t e
 
 		MAPTILE *psTile = mapTile(mapX, mapY);
 		psTile->tileExploredBits |= alliancebits[player];
-		uint8_t *visionType = (!radar) ? psTile->watchers : psTile->sensors;
 
-		if (visionType[player] < UBYTE_MAX)
+		if (addTileVision(psTile, mapX, mapY, !radar ? VISMAP_WATCHERS : VISMAP_SENSORS, player))  // we observe this tile
 		{
 			TILEPOS tilePos = {uint8_t(mapX), uint8_t(mapY), uint8_t(radar)};
-			visionType[player]++;          // we observe this tile
 			updateTileVis(psTile);
 			psSpot->watchedTiles[psSpot->numWatchedTiles++] = tilePos;    // record having seen it
 		}
@@ -193,7 +313,7 @@ static void updateSpotters()
 		}
 
 		// else, ie if not expired, show objects around it
-		gridList = gridStartIterateUnseen(world_coord(psSpot->pos.x), world_coord(psSpot->pos.y), psSpot->sensorRadius, psSpot->player);
+		gridFindUnseen(gridList, world_coord(psSpot->pos.x), world_coord(psSpot->pos.y), psSpot->sensorRadius, psSpot->player);
 
 		for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 		{
@@ -211,9 +331,9 @@ SPOTTER::~SPOTTER()
 	{
 		const TILEPOS tilePos = watchedTiles[i];
 		MAPTILE *psTile = mapTile(tilePos.x, tilePos.y);
-		uint8_t *visionType = (tilePos.type == 0) ? psTile->watchers : psTile->sensors;
-		ASSERT(visionType[player] > 0, "Not watching watched tile (%d, %d)", (int)tilePos.x, (int)tilePos.y);
-		visionType[player]--;
+		const int type = (tilePos.type == 0) ? VISMAP_WATCHERS : VISMAP_SENSORS;
+		ASSERT(visionMap(type, player)[tilePos.x + tilePos.y * mapWidth] > 0, "Not watching watched tile (%d, %d)", (int)tilePos.x, (int)tilePos.y);
+		removeTileVision(psTile, tilePos.x, tilePos.y, type, player);
 		updateTileVis(psTile);
 	}
 
@@ -231,17 +351,14 @@ static inline void visMarkTile(const BASE_OBJECT *psObj, int mapX, int mapY, MAP
 	const int ydiff = map_coord(psObj->pos.y) - mapY;
 	const int distSq = xdiff * xdiff + ydiff * ydiff;
 	const bool inRange = (distSq < 16);
-	uint8_t *visionType = inRange ? psTile->watchers : psTile->sensors;
 
-	if (visionType[rayPlayer] < UBYTE_MAX && *lastRecordTilePos < MAX_SEEN_TILES)
+	if (*lastRecordTilePos < MAX_SEEN_TILES && addTileVision(psTile, mapX, mapY, inRange ? VISMAP_WATCHERS : VISMAP_SENSORS, rayPlayer))  // we observe this tile
 	{
 		TILEPOS tilePos = {uint8_t(mapX), uint8_t(mapY), uint8_t(inRange)};
 
-		visionType[rayPlayer]++;                        // we observe this tile
-
 		if (psObj->flags.test(OBJECT_FLAG_JAMMED_TILES))   // we are a jammer object
 		{
-			psTile->jammers[rayPlayer]++;
+			visionMap(VISMAP_JAMMERS, rayPlayer)[mapX + mapY * mapWidth]++;
 			psTile->jammerBits |= (1 << rayPlayer); // mark it as being jammed
 		}
 
@@ -352,26 +469,22 @@ void visRemoveVisibility(BASE_OBJECT *psObj)
 			MAPTILE *psTile = mapTile(pos.x, pos.y);
 
 			ASSERT(pos.type < 2, "Invalid visibility type %d", (int)pos.type);
-			uint8_t *visionType = (pos.type == 0) ? psTile->sensors : psTile->watchers;
+			const int type = (pos.type == 0) ? VISMAP_SENSORS : VISMAP_WATCHERS;
+			const int tile = pos.x + pos.y * mapWidth;
 
-			if (visionType[psObj->player] == 0 && game.type == CAMPAIGN)	// hack
+			if (visionMap(type, psObj->player)[tile] == 0 && game.type == CAMPAIGN)	// hack
 			{
 				continue;
 			}
 
-			ASSERT(visionType[psObj->player] > 0, "No %s on watched tile (%d, %d)", pos.type ? "radar" : "vision", (int)pos.x, (int)pos.y);
-			visionType[psObj->player]--;
+			ASSERT(visionMap(type, psObj->player)[tile] > 0, "No %s on watched tile (%d, %d)", pos.type ? "radar" : "vision", (int)pos.x, (int)pos.y);
+			removeTileVision(psTile, pos.x, pos.y, type, psObj->player);
 
 			if (psObj->flags.test(OBJECT_FLAG_JAMMED_TILES))  // we are a jammer object — we cannot check objJammerPower(psObj) > 0 directly here, we may be in the BASE_OBJECT destructor).
 			{
 				// No jammers in campaign, no need for special hack
-				ASSERT(psTile->jammers[psObj->player] > 0, "Not jamming watched tile (%d, %d)", (int)pos.x, (int)pos.y);
-				psTile->jammers[psObj->player]--;
-
-				if (psTile->jammers[psObj->player] == 0)
-				{
-					psTile->jammerBits &= ~(1 << psObj->player);
-				}
+				ASSERT(visionMap(VISMAP_JAMMERS, psObj->player)[tile] > 0, "Not jamming watched tile (%d, %d)", (int)pos.x, (int)pos.y);
+				removeTileVision(psTile, pos.x, pos.y, VISMAP_JAMMERS, psObj->player);
 			}
 
 			updateTileVis(psTile);
@@ -543,12 +656,12 @@ int visibleObject(const BASE_OBJECT *psViewer, const BASE_OBJECT *psTarget, bool
 		return UBYTE_MAX;
 	}
 	// Show objects hidden by ECM jamming with radar blips
-	else if (psTile->watchers[psViewer->player] == 0 && psTile->sensors[psViewer->player] > 0 && jammed)
+	else if (!(psTile->watcherBits & (1 << psViewer->player)) && (psTile->radarBits & (1 << psViewer->player)) && jammed)
 	{
 		return UBYTE_MAX / 2;
 	}
 	// Show objects that are seen directly or with unjammed sensors
-	else if (psTile->watchers[psViewer->player] > 0 || (psTile->sensors[psViewer->player] > 0 && !jammed))
+	else if ((psTile->watcherBits & (1 << psViewer->player)) || ((psTile->radarBits & (1 << psViewer->player)) && !jammed))
 	{
 		return UBYTE_MAX;
 	}
@@ -663,7 +776,7 @@ static void processVisibilityVision(BASE_OBJECT *psViewer)
 	// get all the objects from the grid the droid is in
 	// Will give inconsistent results if hasSharedVision is not an equivalence relation.
 	static GridList gridList;  // static to avoid allocations.
-	gridList = gridStartIterateUnseen(psViewer->pos.x, psViewer->pos.y, objSensorRange(psViewer), psViewer->player);
+	gridFindUnseen(gridList, psViewer->pos.x, psViewer->pos.y, objSensorRange(psViewer), psViewer->player);
 
 	for (GridIterator gi = gridList.begin(); gi != gridList.end(); ++gi)
 	{
@@ -683,6 +796,103 @@ static void processVisibilityVision(BASE_OBJECT *psViewer)
 	}
 }
 
+/// Finds all objects in range of each viewer this thread is responsible for, and how well the viewer can see them.
+/// Only reads the game state, so can run on several threads at once. Which thread does what doesn't affect the results.
+static void visFindCandidates(VISWORKER &worker)
+{
+	for (unsigned i = worker.index; i < visViewers.size(); i += visNumThreads)
+	{
+		BASE_OBJECT *psViewer = visViewers[i];
+		std::vector<VisCandidate> &candidates = visCandidates[i];
+
+		gridFindObjects(worker.gridList, psViewer->pos.x, psViewer->pos.y, objSensorRange(psViewer));
+		candidates.clear();
+
+		for (BASE_OBJECT *psObj : worker.gridList)
+		{
+			VisCandidate candidate = {psObj, visibleObject(psViewer, psObj, false)};
+			candidates.push_back(candidate);
+		}
+	}
+}
+
+static int visThreadFunc(void *data)
+{
+	VISWORKER &worker = *(VISWORKER *)data;
+
+	while (true)
+	{
+		wzSemaphoreWait(worker.startSemaphore);
+
+		if (visQuit)
+		{
+			break;
+		}
+
+		visFindCandidates(worker);
+		wzSemaphorePost(visDoneSemaphore);
+	}
+
+	return 0;
+}
+
+/// Does the same as calling processVisibilityVision on each viewer in turn, but with the expensive part done by several threads.
+static void processVisibilityVisionParallel()
+{
+	visCandidates.resize(visViewers.size());
+
+	for (unsigned i = 1; i < visNumThreads; ++i)
+	{
+		wzSemaphorePost(visWorkers[i].startSemaphore);
+	}
+
+	visFindCandidates(visWorkers[0]);
+
+	for (unsigned i = 1; i < visNumThreads; ++i)
+	{
+		wzSemaphoreWait(visDoneSemaphore);
+	}
+
+	// Apply the results in the same order as processVisibilityVision would, so that the same objects are seen first by the
+	// same viewers. Scripts triggered by seeing objects could change what later viewers can see, so once a script has run,
+	// check visibility again, and do the remaining viewers the slow way.
+	static std::vector<VisCandidate> unseen;  // static to avoid allocations.
+	bool scriptsRan = false;
+	unsigned i = 0;
+
+	for (; i < visViewers.size() && !scriptsRan; ++i)
+	{
+		BASE_OBJECT *psViewer = visViewers[i];
+
+		// Same filter as gridFindUnseen, applied before anything is seen by this viewer.
+		unseen.clear();
+		for (VisCandidate const &candidate : visCandidates[i])
+		{
+			if (candidate.psObj->seenThisTick[psViewer->player] < UINT8_MAX)
+			{
+				unseen.push_back(candidate);
+			}
+		}
+
+		for (VisCandidate const &candidate : unseen)
+		{
+			BASE_OBJECT *psObj = candidate.psObj;
+			int val = scriptsRan ? visibleObject(psViewer, psObj, false) : candidate.val;
+
+			if (val > 0)
+			{
+				setSeenBy(psObj, psViewer->player, val);
+				scriptsRan = triggerEventSeen(psViewer, psObj) || scriptsRan;
+			}
+		}
+	}
+
+	for (; i < visViewers.size(); ++i)
+	{
+		processVisibilityVision(visViewers[i]);
+	}
+}
+
 /* Find out what can see this object */
 // Fade in/out of view. Must be called after calculation of which objects are seen.
 static void processVisibilityLevel(BASE_OBJECT *psObj)
@@ -781,6 +991,8 @@ void processVisibility()
 		}
 	}
 
+	visViewers.clear();
+
 	for (int player = 0; player < MAX_PLAYERS; ++player)
 	{
 		BASE_OBJECT *lists[] = {apsDroidLists[player], apsStructLists[player]};
@@ -790,11 +1002,23 @@ void processVisibility()
 		{
 			for (BASE_OBJECT *psObj = lists[list]; psObj != nullptr; psObj = psObj->psNext)
 			{
-				processVisibilityVision(psObj);
+				visViewers.push_back(psObj);
 			}
 		}
 	}
 
+	if (visNumThreads > 1 && visViewers.size() >= VIS_MIN_PARALLEL_VIEWERS)
+	{
+		processVisibilityVisionParallel();
+	}
+	else
+	{
+		for (BASE_OBJECT *psViewer : visViewers)
+		{
+			processVisibilityVision(psViewer);
+		}
+	}
+
 	for (BASE_OBJECT *psObj = apsSensorList[0]; psObj != nullptr; psObj = psObj->psNextFunc)
 	{
 		if (objRadarDetector(psObj))
@@ -30,6 +30,9 @@
 // initialise the visibility stuff
 bool visInitialise();
 
+// shut down the visibility stuff
+void visShutdown();
+
 /* Check which tiles can be seen by an object */
 void visTilesUpdate(BASE_OBJECT *psObj);
 
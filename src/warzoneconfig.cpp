@@ -58,6 +58,10 @@ struct WARZONE_GLOBALS
 	int cameraSpeed = CAMERASPEED_DEFAULT;
 	int scrollEvent = 0; // map/radar zoom
 	bool radarJump = false;
+	int pathfindingThreads = 0; // 0 = one per spare CPU core
+	bool recordReplays = false;
+	int effectBudget = 3000;
+	int scriptTimerBudget = 0;
 };
 
 static WARZONE_GLOBALS warGlobs;
@@ -212,6 +216,46 @@ bool war_GetPauseOnFocusLoss()
 	return warGlobs.pauseOnFocusLoss;
 }
 
+void war_SetPathfindingThreads(int threads)
+{
+	warGlobs.pathfindingThreads = threads;
+}
+
+int war_GetPathfindingThreads()
+{
+	return warGlobs.pathfindingThreads;
+}
+
+void war_SetRecordReplays(bool enabled)
+{
+	warGlobs.recordReplays = enabled;
+}
+
+bool war_GetRecordReplays()
+{
+	return warGlobs.recordReplays;
+}
+
+void war_SetEffectBudget(int budget)
+{
+	warGlobs.effectBudget = MAX(budget, 100);
+}
+
+int war_GetEffectBudget()
+{
+	return warGlobs.effectBudget;
+}
+
+void war_SetScriptTimerBudget(int microseconds)
+{
+	warGlobs.scriptTimerBudget = MAX(microseconds, 0);
+}
+
+int war_GetScriptTimerBudget()
+{
+	return warGlobs.scriptTimerBudget;
+}
+
 void war_SetColouredCursor(bool enabled)
 {
 	warGlobs.ColouredCursor = enabled;
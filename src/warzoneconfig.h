@@ -96,6 +96,33 @@ int war_getMPcolour();
 void war_setScanlineMode(SCANLINE_MODE mode);
 SCANLINE_MODE war_getScanlineMode();
 
+/**
+ * Set the number of path-finding threads, 0 to use one per spare CPU core.
+ * Takes effect the next time the path-finding module is initialised.
+ */
+void war_SetPathfindingThreads(int threads);
+int war_GetPathfindingThreads();
+
+/**
+ * Record skirmish and multiplayer games to the replay directory, so they can be played back with -replay. Off by default.
+ */
+void war_SetRecordReplays(bool enabled);
+bool war_GetRecordReplays();
+
+/**
+ * Set roughly how many effects (explosions, smoke, debris...) may be in the world at once.
+ * Past half of it, decorative effects are thinned out.
+ */
+void war_SetEffectBudget(int budget);
+int war_GetEffectBudget();
+
+/**
+ * Set how long, in microseconds, an AI script's repeating timers may run for in one game update, or 0 for no limit.
+ * Timers left over wait for the next update. Scripts which run on all clients, such as the rules, are never limited.
+ */
+void war_SetScriptTimerBudget(int microseconds);
+int war_GetScriptTimerBudget();
+
 /**
  * Enable or disable sound initialization
  * Has no effect after systemInitialize()!
@@ -37,9 +37,12 @@
 #include "frontend.h"
 #include "keyedit.h"
 #include "keymap.h"
+#include "main.h"
 #include "mission.h"
 #include "multiint.h"
 #include "multilimit.h"
+#include "multiplay.h"
+#include "multireplay.h"
 #include "multistat.h"
 #include "warzoneconfig.h"
 #include "wrappers.h"
@@ -52,6 +55,7 @@ struct STAR
 };
 
 static bool		firstcall = false;
+static bool		replayStarted = false;	// -replay only plays back once, then it's back to the title screen
 static bool		bPlayerHasLost = false;
 static bool		bPlayerHasWon = false;
 static UBYTE    scriptWinLoseVideo = PLAY_NONE;
@@ -126,7 +130,25 @@ void beforeHandleMenu()
   if (firstcall)
     {
       firstcall = false;
-      changeTitleMode(TITLE);			// normal game, run main title screen.
+
+      bool replay = !replay_enabled().empty() && !replayStarted;
+      replayStarted = replayStarted || replay;
+
+      if (replay && replayStartPlayback(replay_enabled().c_str()))
+        {
+          changeTitleMode(STARTGAME);		// playing back a replay given on the command line
+        }
+      else if (hostlaunch == 2)
+        {
+          SPinit();					// skirmish test given on the command line, the lobby starts it
+          ingame.bHostSetup = true;
+          lastTitleMode = SINGLE;
+          changeTitleMode(MULTIOPTION);
+        }
+      else
+        {
+          changeTitleMode(TITLE);			// normal game, run main title screen.
+        }
 
       // Using software cursors (when on) for these menus due to a bug in SDL's SDL_ShowCursor()
       wzSetCursor(CURSOR_DEFAULT);
@@ -0,0 +1,150 @@
+// Checks crcSum, crcSumU16 and crcSumVector2i against a plain byte at a time CRC, and measures their speed over the data archives.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "lib/framework/crc.h"
+
+static uint32_t refTable[256];
+
+static void refInit()
+{
+	refTable[0] = 0;
+	refTable[1] = 0x04C11DB7;
+	for (unsigned i = 2; i < 256; ++i)
+	{
+		refTable[i] = refTable[i >> 1] << 1 ^ ((refTable[i >> 1] >> 31 ^ (i & 0x01)) * refTable[1]);
+	}
+}
+
+static uint32_t refSum(uint32_t crc, uint8_t const *data, size_t dataLen)
+{
+	while (dataLen-- > 0)
+	{
+		crc = crc << 8 ^ refTable[crc >> 24 ^ *data++];
+	}
+	return crc;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool readFile(char const *filename, std::vector<uint8_t> &data)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (!fp)
+	{
+		return false;
+	}
+	data.clear();
+	uint8_t buf[65536];
+	size_t len;
+	while ((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+	{
+		data.insert(data.end(), buf, buf + len);
+	}
+	fclose(fp);
+	return true;
+}
+
+/// Checks the CRC functions against refSum on all the ways of splitting up the start of data, and some odd lengths and alignments.
+static bool check(std::vector<uint8_t> const &data, char const *filename)
+{
+	size_t size = data.size();
+	for (size_t start = 0; start < 17 && start < size; ++start)
+	{
+		for (size_t len = 0; len < 67 && start + len <= size; ++len)
+		{
+			uint32_t crc = ~(uint32_t)(start * 1000 + len);
+			if (crcSum(crc, &data[start], len) != refSum(crc, &data[start], len))
+			{
+				fprintf(stderr, "crctest: crcSum differs on %s at %u+%u\n", filename, (unsigned)start, (unsigned)len);
+				return false;
+			}
+		}
+	}
+
+	// Built from the bytes, so the same on big endian.
+	std::vector<uint16_t> u16(size / 2);
+	for (size_t i = 0; i < u16.size(); ++i)
+	{
+		u16[i] = data[2 * i] << 8 | data[2 * i + 1];
+	}
+	std::vector<Vector2i> v2i(size / 8);
+	for (size_t i = 0; i < v2i.size(); ++i)
+	{
+		uint8_t const *b = &data[8 * i];
+		v2i[i].x = (uint32_t)b[0] << 24 | b[1] << 16 | b[2] << 8 | b[3];
+		v2i[i].y = (uint32_t)b[4] << 24 | b[5] << 16 | b[6] << 8 | b[7];
+	}
+
+	bool ok = crcSum(0xFFFFFFFF, data.data(), size) == refSum(0xFFFFFFFF, data.data(), size)
+	          && (u16.empty() || crcSumU16(0xFFFFFFFF, u16.data(), u16.size()) == refSum(0xFFFFFFFF, data.data(), 2 * u16.size()))
+	          && (v2i.empty() || crcSumVector2i(0xFFFFFFFF, v2i.data(), v2i.size()) == refSum(0xFFFFFFFF, data.data(), 8 * v2i.size()));
+	if (!ok)
+	{
+		fprintf(stderr, "crctest: CRC of the whole of %s differs\n", filename);
+	}
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> filenames(argv + 1, argv + argc);
+	if (filenames.empty())
+	{
+		FILE *fp = fopen("archivelist.txt", "r");
+		if (!fp)
+		{
+			fprintf(stderr, "%s: Failed to open list file\n", argv[0]);
+			return -1;
+		}
+		char filename[PATH_MAX];
+		while (fscanf(fp, "%4095s\n", filename) == 1)
+		{
+			filenames.push_back(filename);
+		}
+		fclose(fp);
+	}
+
+	refInit();
+	std::vector<uint8_t> data;
+	double refTime = 0, time = 0, total = 0;
+	uint32_t sink = 0;
+	for (auto const &filename : filenames)
+	{
+		if (!readFile(filename.c_str(), data))
+		{
+			fprintf(stderr, "crctest: Failed to read \"%s\"\n", filename.c_str());
+			return -1;
+		}
+		printf("Testing CRC of: %s\n", filename.c_str());
+		if (!check(data, filename.c_str()))
+		{
+			return -1;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		sink ^= refSum(0, data.data(), data.size());
+		refTime += secondsSince(start);
+		start = std::chrono::steady_clock::now();
+		sink ^= crcSum(0, data.data(), data.size());
+		time += secondsSince(start);
+		total += data.size();
+	}
+
+	if (sink != 0)  // Same CRCs, so they cancel out.
+	{
+		fprintf(stderr, "crctest: Timed CRCs differ\n");
+		return -1;
+	}
+	printf("crcSum: %.0f MB/s, byte at a time: %.0f MB/s, over %.1f MB\n", total / 1e6 / std::max(time, 1e-9), total / 1e6 / std::max(refTime, 1e-9), total / 1e6);
+	return 0;
+}
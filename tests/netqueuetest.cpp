@@ -0,0 +1,266 @@
+// Round-trips game messages the way NETbeginEncode, NETend, NETflushGameQueues and NETbeginDecode do, checks the decoded values, and measures the speed.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "lib/netplay/netqueue.h"
+
+static const unsigned numPlayers = 4;
+static const unsigned numTicks = 20000;
+static const unsigned messagesPerTick = 8;
+static const uint8_t gameMessageType = 60;
+static const uint8_t shareGameQueueType = 20;
+
+// The encoding state, as in nettypes.cpp.
+static NetMessage message;
+static MessageWriter writer;
+static MessageReader reader;
+
+static void queue(MessageWriter const &q, uint32_t v)
+{
+	bool moreBytes = true;
+	for (int n = 0; moreBytes; ++n)
+	{
+		uint8_t b;
+		moreBytes = encode_uint32_t(b, v, n);
+		q.byte(b);
+	}
+}
+
+static uint32_t dequeue(MessageReader const &q)
+{
+	uint32_t v = 0;
+	bool moreBytes = true;
+	for (int n = 0; moreBytes; ++n)
+	{
+		uint8_t b = 0;
+		q.byte(b);
+		moreBytes = decode_uint32_t(b, v, n);
+	}
+	return v;
+}
+
+static void beginEncode(uint8_t type)
+{
+	message.type = type;
+	message.data.clear();  // Keeps the buffer from the previous message.
+	writer = MessageWriter(message);
+}
+
+static void endEncode(NetQueue &netQueue)
+{
+	netQueue.pushMessage(message);
+}
+
+static void beginDecode(NetQueue &netQueue)
+{
+	message = netQueue.getMessage();
+	reader = MessageReader(message);
+}
+
+static bool endDecode(NetQueue &netQueue)
+{
+	netQueue.popMessage();
+	return reader.valid();
+}
+
+/// Encodes a message like a droid order, with a payload of a few bytes.
+static void encodeGameMessage(NetQueue &gameQueue, uint32_t seed, uint32_t &checksum)
+{
+	uint32_t droid = seed * 2654435761u, x = seed % 65536, y = seed / 7 % 65536;
+	uint8_t payload[32];
+	uint32_t payloadLen = seed % sizeof(payload);
+	for (uint32_t i = 0; i < payloadLen; ++i)
+	{
+		payload[i] = uint8_t(seed + i);
+	}
+
+	beginEncode(gameMessageType);
+	queue(writer, droid);
+	queue(writer, x);
+	queue(writer, y);
+	queue(writer, payloadLen);
+	writer.bytes(payload, payloadLen);
+	endEncode(gameQueue);
+
+	checksum = checksum * 31 + (droid ^ x ^ y ^ payloadLen);
+}
+
+static bool decodeGameMessage(NetQueue &gameQueue, uint32_t &checksum)
+{
+	beginDecode(gameQueue);
+	if (message.type != gameMessageType)
+	{
+		return false;
+	}
+	uint32_t droid = dequeue(reader), x = dequeue(reader), y = dequeue(reader);
+	uint32_t payloadLen = dequeue(reader);
+	uint8_t payload[32];
+	if (payloadLen > sizeof(payload))
+	{
+		return false;
+	}
+	reader.bytes(payload, payloadLen);
+	checksum = checksum * 31 + (droid ^ x ^ y ^ payloadLen);
+	return endDecode(gameQueue);
+}
+
+/// Wraps the messages queued for the network in one message, like NETflushGameQueues, and appends it to stream.
+static void flushGameQueue(NetQueue &gameQueue, uint8_t player, NetQueue &broadcast, std::vector<uint8_t> &stream)
+{
+	uint32_t num = gameQueue.numMessagesForNet();
+	beginEncode(shareGameQueueType);
+	writer.byte(player);
+	queue(writer, num);
+	for (uint32_t n = 0; n < num; ++n)
+	{
+		NetMessage const &gameMessage = gameQueue.getMessageForNet();
+		writer.byte(gameMessage.type);
+		queue(writer, uint32_t(gameMessage.data.size()));
+		writer.bytes(gameMessage.data.data(), gameMessage.data.size());
+		gameQueue.popMessageForNet();
+	}
+	endEncode(broadcast);
+	broadcast.getMessageForNet().rawDataAppendToVector(stream);
+	broadcast.popMessageForNet();
+}
+
+/// Unwraps the messages from flushGameQueue into the remote copies of the game queues.
+static bool receiveGameQueues(NetQueue &receive, std::unique_ptr<NetQueue> *remoteQueues)
+{
+	NetMessage gameMessage;
+	while (receive.haveMessage())
+	{
+		beginDecode(receive);
+		uint8_t player = 0;
+		reader.byte(player);
+		uint32_t num = dequeue(reader);
+		if (message.type != shareGameQueueType || player >= numPlayers)
+		{
+			return false;
+		}
+		for (uint32_t n = 0; n < num && reader.valid(); ++n)
+		{
+			reader.byte(gameMessage.type);
+			gameMessage.data.resize(std::min<size_t>(dequeue(reader), reader.remaining()));
+			reader.bytes(gameMessage.data.data(), gameMessage.data.size());
+			remoteQueues[player]->pushMessage(gameMessage);
+		}
+		if (!endDecode(receive))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Reading past the end of a message gives zeros and makes the reader invalid, also when already past the end.
+static bool checkReadPastEnd()
+{
+	NetMessage shortMessage;
+	shortMessage.data = {1, 2, 3};
+	MessageReader shortReader(shortMessage);
+	uint8_t out[4];
+
+	shortReader.bytes(out, 2);
+	if (out[0] != 1 || out[1] != 2 || !shortReader.valid())
+	{
+		return false;
+	}
+	shortReader.bytes(out, 4);
+	if (out[0] != 3 || out[1] != 0 || out[3] != 0 || shortReader.valid())
+	{
+		return false;
+	}
+	memset(out, 0xFF, sizeof(out));
+	shortReader.bytes(out, 4);  // index is now past size().
+	return out[0] == 0 && out[3] == 0 && shortReader.remaining() == 0 && !shortReader.valid();
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+	if (!checkReadPastEnd())
+	{
+		printf("MessageReader::bytes past the end of a message did not read zeros.\n");
+		return -1;
+	}
+
+	std::unique_ptr<NetQueue> gameQueues[numPlayers], remoteQueues[numPlayers];
+	for (unsigned player = 0; player < numPlayers; ++player)
+	{
+		gameQueues[player].reset(new NetQueue);
+		remoteQueues[player].reset(new NetQueue);
+		remoteQueues[player]->setWillNeverGetMessagesForNet();
+	}
+	NetQueue broadcast;
+	broadcast.setWillNeverGetMessages();
+	NetQueuePair connection;
+	std::vector<uint8_t> stream;
+
+	uint32_t sentChecksum = 0, localChecksum = 0, remoteChecksum = 0;
+	size_t streamBytes = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned tick = 0; tick < numTicks; ++tick)
+	{
+		for (unsigned player = 0; player < numPlayers; ++player)
+		{
+			for (unsigned i = 0; i < messagesPerTick; ++i)
+			{
+				encodeGameMessage(*gameQueues[player], (tick * numPlayers + player) * messagesPerTick + i, sentChecksum);
+			}
+		}
+
+		stream.clear();
+		for (unsigned player = 0; player < numPlayers; ++player)
+		{
+			flushGameQueue(*gameQueues[player], player, broadcast, stream);
+		}
+		streamBytes += stream.size();
+		connection.receive.writeRawData(stream.data(), stream.size());
+		if (!receiveGameQueues(connection.receive, remoteQueues))
+		{
+			printf("Tick %u: failed to unwrap the game queues.\n", tick);
+			return -1;
+		}
+
+		for (unsigned player = 0; player < numPlayers; ++player)
+		{
+			while (gameQueues[player]->haveMessage())
+			{
+				if (!decodeGameMessage(*gameQueues[player], localChecksum))
+				{
+					printf("Tick %u: failed to decode a local message of player %u.\n", tick, player);
+					return -1;
+				}
+			}
+			while (remoteQueues[player]->haveMessage())
+			{
+				if (!decodeGameMessage(*remoteQueues[player], remoteChecksum))
+				{
+					printf("Tick %u: failed to decode a remote message of player %u.\n", tick, player);
+					return -1;
+				}
+			}
+		}
+	}
+	double seconds = secondsSince(start);
+
+	if (localChecksum != sentChecksum || remoteChecksum != sentChecksum)
+	{
+		printf("Checksums differ: sent %08X, decoded locally %08X, decoded remotely %08X\n", sentChecksum, localChecksum, remoteChecksum);
+		return -1;
+	}
+
+	unsigned numMessages = numTicks * numPlayers * messagesPerTick;
+	printf("Encoded, flushed, received and decoded %u messages (%.1f MiB on the wire) in %.1f ms, %.0f ns per message.\n", numMessages, streamBytes / 1048576., seconds * 1000, seconds * 1e9 / numMessages);
+	return 0;
+}